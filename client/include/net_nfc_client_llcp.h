@@ -138,6 +138,12 @@ net_nfc_error_e net_nfc_client_llcp_receive_from_sync(net_nfc_llcp_socket_t sock
 		sap_t *out_sap,
 		data_s **out_data);
 
+/* fd is a seqpacket socket bound to the connected socket until it is
+   closed. every packet written to it goes out as one PDU of at most the
+   miu of the remote socket and every PDU received reads as one packet. */
+net_nfc_error_e net_nfc_client_llcp_open_stream_sync(net_nfc_llcp_socket_t socket,
+		int *fd);
+
 net_nfc_error_e net_nfc_client_llcp_close(net_nfc_llcp_socket_t socket,
 		net_nfc_client_llcp_close_completed callback,
 		void *user_data);
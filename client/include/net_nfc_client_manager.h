@@ -30,6 +30,14 @@ typedef void (*net_nfc_client_manager_get_server_state_completed)(
 typedef void (*net_nfc_client_manager_activated)(bool state,
 		void *user_data);
 
+/* NDEF records a client wants tag events for, type NULL matches any type */
+typedef struct _net_nfc_ndef_type_filter_s
+{
+	net_nfc_record_tnf_e tnf;
+	data_s *type;
+}
+net_nfc_ndef_type_filter_s;
+
 void net_nfc_client_manager_set_activated(
 		net_nfc_client_manager_activated callback,
 		void *user_data);
@@ -51,10 +59,37 @@ net_nfc_error_e net_nfc_client_manager_get_server_state_sync(
 
 bool net_nfc_client_manager_is_activated(void);
 
+/* tag and p2p events are broadcast without the NDEF raw data and p2p
+   payloads. with raw_data, this client also gets them with the payload
+   for the technologies of tech_mask and, if types is not NULL, the NDEF
+   messages with a record of one of types. other events still arrive
+   without the payload */
+net_nfc_error_e net_nfc_client_manager_set_event_filter_sync(
+		net_nfc_event_filter_e tech_mask,
+		net_nfc_ndef_type_filter_s *types,
+		int count,
+		bool raw_data);
+
+/* value of a GetSnapshot key, the snapshot is fetched on first use and
+   then follows StateChanged. it is fetched again while the main context
+   of the client library does not dispatch signals. NULL if unknown,
+   unref the result */
+GVariant *net_nfc_client_manager_get_state(const char *key);
+
 /* TODO : move to internal header */
 net_nfc_error_e net_nfc_client_manager_init(void);
 
 void net_nfc_client_manager_deinit(void);
 
+/* sent without waiting for the reply, raw data on and NDEF types kept */
+void net_nfc_client_manager_set_tag_event_filter(net_nfc_event_filter_e tech_mask);
+
+bool net_nfc_client_manager_get_event_filter_raw_data(void);
+
+/* values of several keys from the same snapshot, see
+   net_nfc_client_manager_get_state. false if there is no snapshot */
+bool net_nfc_client_manager_get_states(const char * const *keys,
+		GVariant **values, int count);
+
 
 #endif //__NET_NFC_CLIENT_MANAGER_H__
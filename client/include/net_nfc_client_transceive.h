@@ -25,6 +25,23 @@ typedef void (*nfc_transceive_data_callback)(net_nfc_error_e result,
 		data_s *data,
 		void *user_data);
 
+/* one command of a batch, result and response are filled by the call.
+   commands which were not run keep response NULL and get the batch result */
+typedef struct _net_nfc_transceive_command_s
+{
+	data_s *data;
+	bool stop_on_error;
+	net_nfc_error_e result;
+	data_s *response;
+}
+net_nfc_transceive_command_s;
+
+/* responses are freed when the callback returns */
+typedef void (*nfc_transceive_batch_callback)(net_nfc_error_e result,
+		net_nfc_transceive_command_s *commands,
+		int count,
+		void *user_data);
+
 net_nfc_error_e net_nfc_client_transceive(net_nfc_target_handle_s *handle,
 		data_s *rawdata, nfc_transceive_callback callback, void *user_data);
 
@@ -37,6 +54,16 @@ net_nfc_error_e net_nfc_client_transceive_sync(net_nfc_target_handle_s *handle,
 net_nfc_error_e net_nfc_client_transceive_data_sync(
 		net_nfc_target_handle_s *handle, data_s *rawdata, data_s **response);
 
+/* commands must stay valid until the callback is called */
+net_nfc_error_e net_nfc_client_transceive_batch(net_nfc_target_handle_s *handle,
+		net_nfc_transceive_command_s *commands, int count,
+		nfc_transceive_batch_callback callback, void *user_data);
+
+/* free each response with net_nfc_free_data */
+net_nfc_error_e net_nfc_client_transceive_batch_sync(
+		net_nfc_target_handle_s *handle,
+		net_nfc_transceive_command_s *commands, int count);
+
 /* TODO : move to internal header */
 net_nfc_error_e net_nfc_client_transceive_init(void);
 
@@ -30,6 +30,9 @@
 #include "net_nfc_client_phdc.h"
 #include "net_nfc_client_system_handler.h"
 #include "net_nfc_client_handover.h"
+#ifdef USE_SOCKET_IPC
+#include "net_nfc_client_ipc_internal.h"
+#endif
 
 GVariant *net_nfc_client_gdbus_get_privilege()
 {
@@ -40,6 +43,11 @@ void net_nfc_client_gdbus_init(void)
 {
 	if (net_nfc_client_manager_init() != NET_NFC_OK)
 		return;
+
+#ifdef USE_SOCKET_IPC
+	net_nfc_client_ipc_init();
+#endif
+
 	if (net_nfc_client_tag_init() != NET_NFC_OK)
 		return;
 	if (net_nfc_client_ndef_init() != NET_NFC_OK)
@@ -74,5 +82,8 @@ void net_nfc_client_gdbus_deinit(void)
 	net_nfc_client_ndef_deinit();
 	net_nfc_client_tag_deinit();
 	net_nfc_client_phdc_deinit();
+#ifdef USE_SOCKET_IPC
+	net_nfc_client_ipc_deinit();
+#endif
 	net_nfc_client_manager_deinit();
 }
@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2012-2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 				 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+
+#include "net_nfc_typedef_internal.h"
+#include "net_nfc_debug_internal.h"
+#include "net_nfc_util_internal.h"
+#include "net_nfc_client_ipc_internal.h"
+
+/* same as the default D-Bus call timeout */
+#define IPC_CALL_TIMEOUT	25
+
+typedef struct _IpcCall IpcCall;
+
+struct _IpcCall
+{
+	bool done;
+	net_nfc_error_e result;
+	data_s *response;
+};
+
+static int ipc_fd = -1;
+static bool ipc_connected = false;
+static pthread_t ipc_thread;
+static bool ipc_thread_started = false;
+
+/* id -> IpcCall waiting for its reply, the calls live on the stack of
+   the waiting threads */
+static GHashTable *ipc_calls = NULL;
+static uint32_t ipc_next_id = 0;
+static pthread_mutex_t ipc_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t ipc_cond = PTHREAD_COND_INITIALIZER;
+
+static void ipc_call_fail(gpointer key, gpointer value, gpointer user_data)
+{
+	IpcCall *call = value;
+
+	call->result = NET_NFC_IPC_FAIL;
+	call->done = true;
+}
+
+static void *ipc_thread_func(void *user_data)
+{
+	ssize_t ret;
+	IpcCall *call;
+	uint8_t *buffer;
+	net_nfc_ipc_header_s *header;
+
+	buffer = g_malloc(sizeof(*header) + NET_NFC_IPC_PAYLOAD_MAX);
+	header = (net_nfc_ipc_header_s *)buffer;
+
+	while ((ret = net_nfc_util_ipc_recv(ipc_fd, buffer, 0)) > 0)
+	{
+		pthread_mutex_lock(&ipc_lock);
+
+		/* replies come in completion order, not request order */
+		call = g_hash_table_lookup(ipc_calls, GUINT_TO_POINTER(header->id));
+		if (call != NULL)
+		{
+			call->result = header->result;
+
+			if (call->response != NULL && header->length > 0
+					&& net_nfc_util_alloc_data(call->response, header->length) == true)
+			{
+				memcpy(call->response->buffer, buffer + sizeof(*header),
+						header->length);
+			}
+
+			call->done = true;
+			g_hash_table_remove(ipc_calls, GUINT_TO_POINTER(header->id));
+
+			pthread_cond_broadcast(&ipc_cond);
+		}
+		else
+		{
+			NFC_ERR("reply [%d] without a request", header->id);
+		}
+
+		pthread_mutex_unlock(&ipc_lock);
+	}
+
+	NFC_ERR("daemon closed the socket, [%d]", (int)ret);
+
+	pthread_mutex_lock(&ipc_lock);
+
+	ipc_connected = false;
+
+	g_hash_table_foreach(ipc_calls, ipc_call_fail, NULL);
+	g_hash_table_remove_all(ipc_calls);
+
+	pthread_cond_broadcast(&ipc_cond);
+
+	pthread_mutex_unlock(&ipc_lock);
+
+	g_free(buffer);
+
+	return NULL;
+}
+
+void net_nfc_client_ipc_init(void)
+{
+	const char *transport;
+
+	transport = getenv(NET_NFC_CLIENT_IPC_ENV);
+	if (NULL == transport || strcmp(transport, "socket") != 0)
+		return;
+
+	if (ipc_fd >= 0)
+		return;
+
+	ipc_fd = net_nfc_util_ipc_connect();
+	if (ipc_fd < 0)
+	{
+		NFC_ERR("socket transport is not available, use D-Bus");
+		return;
+	}
+
+	ipc_calls = g_hash_table_new(g_direct_hash, g_direct_equal);
+	ipc_connected = true;
+
+	if (pthread_create(&ipc_thread, NULL, ipc_thread_func, NULL) != 0)
+	{
+		NFC_ERR("can not create the reply thread");
+
+		net_nfc_client_ipc_deinit();
+		return;
+	}
+
+	ipc_thread_started = true;
+}
+
+void net_nfc_client_ipc_deinit(void)
+{
+	if (ipc_fd < 0)
+		return;
+
+	/* the reply thread sees the end of the stream and fails the calls */
+	shutdown(ipc_fd, SHUT_RDWR);
+
+	if (true == ipc_thread_started)
+	{
+		pthread_join(ipc_thread, NULL);
+		ipc_thread_started = false;
+	}
+
+	pthread_mutex_lock(&ipc_lock);
+
+	ipc_connected = false;
+
+	pthread_mutex_unlock(&ipc_lock);
+
+	close(ipc_fd);
+	ipc_fd = -1;
+
+	g_hash_table_destroy(ipc_calls);
+	ipc_calls = NULL;
+}
+
+bool net_nfc_client_ipc_is_connected(void)
+{
+	bool result;
+
+	pthread_mutex_lock(&ipc_lock);
+
+	result = ipc_connected;
+
+	pthread_mutex_unlock(&ipc_lock);
+
+	return result;
+}
+
+net_nfc_error_e net_nfc_client_ipc_call_sync(net_nfc_ipc_type_e type,
+		const void *payload, uint32_t length, data_s *response)
+{
+	int ret = 0;
+	uint32_t id;
+	struct timespec ts;
+	IpcCall call = { false, NET_NFC_OK, response };
+	net_nfc_ipc_header_s header = { 0, };
+
+	pthread_mutex_lock(&ipc_lock);
+
+	if (false == ipc_connected)
+	{
+		pthread_mutex_unlock(&ipc_lock);
+
+		return NET_NFC_IPC_FAIL;
+	}
+
+	/* 0 is never used, it is easier to spot in a dump */
+	if (++ipc_next_id == 0)
+		ipc_next_id++;
+
+	id = ipc_next_id;
+
+	g_hash_table_insert(ipc_calls, GUINT_TO_POINTER(id), &call);
+
+	pthread_mutex_unlock(&ipc_lock);
+
+	header.id = id;
+	header.type = type;
+
+	if (net_nfc_util_ipc_send(ipc_fd, &header, payload, length) == false)
+	{
+		pthread_mutex_lock(&ipc_lock);
+
+		g_hash_table_remove(ipc_calls, GUINT_TO_POINTER(id));
+
+		pthread_mutex_unlock(&ipc_lock);
+
+		return NET_NFC_IPC_FAIL;
+	}
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	ts.tv_sec += IPC_CALL_TIMEOUT;
+
+	pthread_mutex_lock(&ipc_lock);
+
+	while (false == call.done && ret != ETIMEDOUT)
+		ret = pthread_cond_timedwait(&ipc_cond, &ipc_lock, &ts);
+
+	if (false == call.done)
+	{
+		NFC_ERR("request [%d] timed out", id);
+
+		g_hash_table_remove(ipc_calls, GUINT_TO_POINTER(id));
+		call.result = NET_NFC_IPC_FAIL;
+	}
+
+	pthread_mutex_unlock(&ipc_lock);
+
+	return call.result;
+}
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2012-2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 				 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __NET_NFC_CLIENT_IPC_INTERNAL_H__
+#define __NET_NFC_CLIENT_IPC_INTERNAL_H__
+
+#include "net_nfc_typedef_internal.h"
+#include "net_nfc_util_ipc_internal.h"
+
+/* NET_NFC_IPC=socket in the environment sends the calls the daemon serves
+   over NET_NFC_IPC_SOCKET_PATH instead of D-Bus */
+#define NET_NFC_CLIENT_IPC_ENV	"NET_NFC_IPC"
+
+void net_nfc_client_ipc_init(void);
+
+void net_nfc_client_ipc_deinit(void);
+
+/* false when not selected or the daemon went away, callers use D-Bus */
+bool net_nfc_client_ipc_is_connected(void);
+
+/* sends one request and waits for its reply, other threads may have
+   requests in flight at the same time. a reply payload is stored in
+   response when it is not NULL, free it with net_nfc_util_free_data */
+net_nfc_error_e net_nfc_client_ipc_call_sync(net_nfc_ipc_type_e type,
+		const void *payload, uint32_t length, data_s *response);
+
+#endif //__NET_NFC_CLIENT_IPC_INTERNAL_H__
@@ -29,6 +29,7 @@ struct _LlcpFuncData
 {
 	gpointer callback;
 	gpointer user_data;
+	gboolean fd; /* data went as a memfd */
 };
 
 static NetNfcGDbusLlcp *llcp_proxy = NULL;
@@ -287,8 +288,12 @@ static void llcp_call_send(GObject *source_object, GAsyncResult *res,
 
 	g_assert(func_data != NULL);
 
-	ret = net_nfc_gdbus_llcp_call_send_finish(NET_NFC_GDBUS_LLCP(source_object),
-			&result, &out_client_socket, res, &error);
+	if (func_data->fd == TRUE)
+		ret = net_nfc_gdbus_llcp_call_send_fd_finish(NET_NFC_GDBUS_LLCP(source_object),
+				&result, &out_client_socket, NULL, res, &error);
+	else
+		ret = net_nfc_gdbus_llcp_call_send_finish(NET_NFC_GDBUS_LLCP(source_object),
+				&result, &out_client_socket, res, &error);
 	if (FALSE == ret)
 	{
 		NFC_ERR("Can not finish send: %s", error->message);
@@ -318,8 +323,13 @@ static void llcp_call_send_to(GObject *source_object, GAsyncResult *res,
 
 	g_assert(func_data != NULL);
 
-	ret = net_nfc_gdbus_llcp_call_send_to_finish(NET_NFC_GDBUS_LLCP(source_object),
-			&result, &out_client_socket, res, &error);
+	if (func_data->fd == TRUE)
+		ret = net_nfc_gdbus_llcp_call_send_to_fd_finish(
+				NET_NFC_GDBUS_LLCP(source_object),
+				&result, &out_client_socket, NULL, res, &error);
+	else
+		ret = net_nfc_gdbus_llcp_call_send_to_finish(NET_NFC_GDBUS_LLCP(source_object),
+				&result, &out_client_socket, res, &error);
 	if (FALSE == ret)
 	{
 		NFC_ERR("Can not finish send to: %s", error->message);
@@ -931,6 +941,7 @@ API net_nfc_error_e net_nfc_client_llcp_send(net_nfc_llcp_socket_t socket,
 		data_s *data, net_nfc_client_llcp_send_completed callback, void *user_data)
 {
 	GVariant *variant;
+	GUnixFDList *fd_list;
 	LlcpFuncData *func_data;
 	net_nfc_llcp_internal_socket_s *socket_data = NULL;
 
@@ -958,6 +969,26 @@ API net_nfc_error_e net_nfc_client_llcp_send(net_nfc_llcp_socket_t socket,
 	func_data->callback = (gpointer)callback;
 	func_data->user_data = user_data;
 
+	fd_list = net_nfc_util_gdbus_data_to_fd_list(data);
+	if (fd_list != NULL)
+	{
+		func_data->fd = TRUE;
+
+		net_nfc_gdbus_llcp_call_send_fd(llcp_proxy,
+				GPOINTER_TO_UINT(llcp_handle),
+				socket_data->client_socket,
+				0 /* index in fd_list */,
+				net_nfc_client_gdbus_get_privilege(),
+				fd_list,
+				NULL,
+				llcp_call_send,
+				func_data);
+
+		g_object_unref(fd_list);
+
+		return NET_NFC_OK;
+	}
+
 	variant = net_nfc_util_gdbus_data_to_variant(data);
 
 	net_nfc_gdbus_llcp_call_send(llcp_proxy,
@@ -977,6 +1008,7 @@ API net_nfc_error_e net_nfc_client_llcp_send_sync(net_nfc_llcp_socket_t socket,
 {
 	gboolean ret;
 	GVariant *variant;
+	GUnixFDList *fd_list;
 	GError *error = NULL;
 	net_nfc_error_e result;
 	guint32 out_client_socket;
@@ -997,17 +1029,37 @@ API net_nfc_error_e net_nfc_client_llcp_send_sync(net_nfc_llcp_socket_t socket,
 		return NET_NFC_LLCP_INVALID_SOCKET;
 	}
 
-	variant = net_nfc_util_gdbus_data_to_variant(data);
+	fd_list = net_nfc_util_gdbus_data_to_fd_list(data);
+	if (fd_list != NULL)
+	{
+		ret = net_nfc_gdbus_llcp_call_send_fd_sync(llcp_proxy,
+				GPOINTER_TO_UINT(llcp_handle),
+				socket_data->client_socket,
+				0 /* index in fd_list */,
+				net_nfc_client_gdbus_get_privilege(),
+				fd_list,
+				&result,
+				&out_client_socket,
+				NULL,
+				NULL,
+				&error);
 
-	ret = net_nfc_gdbus_llcp_call_send_sync(llcp_proxy,
-			GPOINTER_TO_UINT(llcp_handle),
-			socket_data->client_socket,
-			variant,
-			net_nfc_client_gdbus_get_privilege(),
-			&result,
-			&out_client_socket,
-			NULL,
-			&error);
+		g_object_unref(fd_list);
+	}
+	else
+	{
+		variant = net_nfc_util_gdbus_data_to_variant(data);
+
+		ret = net_nfc_gdbus_llcp_call_send_sync(llcp_proxy,
+				GPOINTER_TO_UINT(llcp_handle),
+				socket_data->client_socket,
+				variant,
+				net_nfc_client_gdbus_get_privilege(),
+				&result,
+				&out_client_socket,
+				NULL,
+				&error);
+	}
 	if (TRUE == ret)
 	{
 		out_socket_data = llcp_socket_data_find(out_client_socket);
@@ -1034,6 +1086,7 @@ API net_nfc_error_e net_nfc_client_llcp_send_to(net_nfc_llcp_socket_t socket,
 		void *user_data)
 {
 	GVariant *variant;
+	GUnixFDList *fd_list;
 	LlcpFuncData *func_data;
 	net_nfc_llcp_internal_socket_s *socket_data = NULL;
 
@@ -1062,6 +1115,27 @@ API net_nfc_error_e net_nfc_client_llcp_send_to(net_nfc_llcp_socket_t socket,
 	func_data->callback = (gpointer)callback;
 	func_data->user_data = user_data;
 
+	fd_list = net_nfc_util_gdbus_data_to_fd_list(data);
+	if (fd_list != NULL)
+	{
+		func_data->fd = TRUE;
+
+		net_nfc_gdbus_llcp_call_send_to_fd(llcp_proxy,
+				GPOINTER_TO_UINT(llcp_handle),
+				socket_data->client_socket,
+				sap,
+				0 /* index in fd_list */,
+				net_nfc_client_gdbus_get_privilege(),
+				fd_list,
+				NULL,
+				llcp_call_send_to,
+				func_data);
+
+		g_object_unref(fd_list);
+
+		return NET_NFC_OK;
+	}
+
 	variant = net_nfc_util_gdbus_data_to_variant(data);
 
 	net_nfc_gdbus_llcp_call_send_to(llcp_proxy,
@@ -1082,6 +1156,7 @@ API net_nfc_error_e net_nfc_client_llcp_send_to_sync(net_nfc_llcp_socket_t socke
 {
 	gboolean ret;
 	GVariant *variant;
+	GUnixFDList *fd_list;
 	GError *error = NULL;
 	net_nfc_error_e result;
 	guint32 out_client_socket;
@@ -1103,18 +1178,39 @@ API net_nfc_error_e net_nfc_client_llcp_send_to_sync(net_nfc_llcp_socket_t socke
 		return NET_NFC_LLCP_INVALID_SOCKET;
 	}
 
-	variant = net_nfc_util_gdbus_data_to_variant(data);
+	fd_list = net_nfc_util_gdbus_data_to_fd_list(data);
+	if (fd_list != NULL)
+	{
+		ret = net_nfc_gdbus_llcp_call_send_to_fd_sync(llcp_proxy,
+				GPOINTER_TO_UINT(llcp_handle),
+				socket_data->client_socket,
+				sap,
+				0 /* index in fd_list */,
+				net_nfc_client_gdbus_get_privilege(),
+				fd_list,
+				&result,
+				&out_client_socket,
+				NULL,
+				NULL,
+				&error);
 
-	ret = net_nfc_gdbus_llcp_call_send_to_sync(llcp_proxy,
-			GPOINTER_TO_UINT(llcp_handle),
-			socket_data->client_socket,
-			sap,
-			variant,
-			net_nfc_client_gdbus_get_privilege(),
-			&result,
-			&out_client_socket,
-			NULL,
-			&error);
+		g_object_unref(fd_list);
+	}
+	else
+	{
+		variant = net_nfc_util_gdbus_data_to_variant(data);
+
+		ret = net_nfc_gdbus_llcp_call_send_to_sync(llcp_proxy,
+				GPOINTER_TO_UINT(llcp_handle),
+				socket_data->client_socket,
+				sap,
+				variant,
+				net_nfc_client_gdbus_get_privilege(),
+				&result,
+				&out_client_socket,
+				NULL,
+				&error);
+	}
 	if (TRUE == ret)
 	{
 		out_socket_data = llcp_socket_data_find(out_client_socket);
@@ -1325,6 +1421,68 @@ API net_nfc_error_e net_nfc_client_llcp_receive_from_sync(
 	return result;
 }
 
+API net_nfc_error_e net_nfc_client_llcp_open_stream_sync(net_nfc_llcp_socket_t socket,
+		int *fd)
+{
+	gboolean ret;
+	GError *error = NULL;
+	net_nfc_error_e result;
+	gint32 out_stream = -1;
+	GUnixFDList *out_fd_list = NULL;
+	net_nfc_llcp_internal_socket_s *socket_data = NULL;
+
+	RETV_IF(NULL == llcp_proxy, NET_NFC_NOT_INITIALIZED);
+	RETV_IF(NULL == fd, NET_NFC_NULL_PARAMETER);
+	RETV_IF(socket <= 0, NET_NFC_INVALID_PARAM);
+
+	/* prevent executing daemon when nfc is off */
+	RETV_IF(net_nfc_client_manager_is_activated() == false, NET_NFC_INVALID_STATE);
+
+	*fd = -1;
+
+	socket_data = llcp_socket_data_find(socket);
+	if (socket_data == NULL)
+	{
+		NFC_ERR("can not get socket_data");
+		return NET_NFC_LLCP_INVALID_SOCKET;
+	}
+
+	ret = net_nfc_gdbus_llcp_call_open_stream_sync(llcp_proxy,
+			GPOINTER_TO_UINT(llcp_handle),
+			socket_data->client_socket,
+			net_nfc_client_gdbus_get_privilege(),
+			NULL,
+			&result,
+			&out_stream,
+			&out_fd_list,
+			NULL,
+			&error);
+	if (FALSE == ret)
+	{
+		NFC_ERR("can not open stream: %s", error->message);
+		g_error_free(error);
+
+		return NET_NFC_IPC_FAIL;
+	}
+
+	if (NET_NFC_OK == result)
+	{
+		*fd = g_unix_fd_list_get(out_fd_list, out_stream, &error);
+		if (*fd < 0)
+		{
+			NFC_ERR("can not get stream: %s", error->message);
+			g_error_free(error);
+
+			result = NET_NFC_IPC_FAIL;
+		}
+	}
+
+	if (out_fd_list != NULL)
+		g_object_unref(out_fd_list);
+
+	return result;
+}
+
 API net_nfc_error_e net_nfc_client_llcp_close(net_nfc_llcp_socket_t socket,
 		net_nfc_client_llcp_close_completed callback, void *user_data)
 {
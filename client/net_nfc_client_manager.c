@@ -14,13 +14,20 @@
  * limitations under the License.
  */
 
+#include <pthread.h>
+
 #include "net_nfc_debug_internal.h"
 
+#include "net_nfc_util_gdbus_internal.h"
 #include "net_nfc_gdbus.h"
 #include "net_nfc_client.h"
 #include "net_nfc_client_context.h"
 #include "net_nfc_client_manager.h"
 #include "net_nfc_neard.h"
+#ifdef USE_SOCKET_IPC
+#include "net_nfc_util_internal.h"
+#include "net_nfc_client_ipc_internal.h"
+#endif
 
 #define DEACTIVATE_DELAY	500 /* ms */
 
@@ -38,6 +45,19 @@ static ManagerFuncData activated_func_data;
 static int is_activated = -1;
 static guint timeout_id[2];
 
+/* GetSnapshot reply kept up to date by StateChanged, key -> GVariant.
+   NULL until the first query which needs it */
+static GHashTable *state_cache = NULL;
+static pthread_mutex_t state_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* context the signals of manager_proxy are dispatched in */
+static GMainContext *signal_context = NULL;
+static bool state_marker_pending = false;
+
+/* last SetEventFilter arguments, (tech_mask, ndef_types, raw_data).
+   sent again when the daemon restarts */
+static GVariant *event_filter = NULL;
+
 static void manager_call_get_server_state_callback(GObject *source_object,
 		GAsyncResult *res, gpointer user_data)
 {
@@ -111,6 +131,240 @@ static void manager_activated(NetNfcGDbusManager *manager, gboolean activated,
 	}
 }
 
+/* called with state_lock */
+static void manager_state_merge(GHashTable *cache, GVariant *state)
+{
+	gchar *key;
+	GVariant *value;
+	GVariantIter iter;
+
+	g_variant_iter_init(&iter, state);
+
+	while (g_variant_iter_next(&iter, "{sv}", &key, &value))
+	{
+		if (g_strcmp0(key, "activated") == 0)
+			is_activated = (int)g_variant_get_boolean(value);
+
+		if (cache != NULL)
+			g_hash_table_insert(cache, key, value);
+		else
+		{
+			g_free(key);
+			g_variant_unref(value);
+		}
+	}
+}
+
+static void manager_state_changed(NetNfcGDbusManager *manager, GVariant *changed,
+		gpointer user_data)
+{
+	NFC_INFO(">>> SIGNAL arrived");
+
+	pthread_mutex_lock(&state_lock);
+
+	manager_state_merge(state_cache, changed);
+
+	pthread_mutex_unlock(&state_lock);
+}
+
+static gboolean manager_state_marker(gpointer user_data)
+{
+	pthread_mutex_lock(&state_lock);
+
+	state_marker_pending = false;
+
+	pthread_mutex_unlock(&state_lock);
+
+	return G_SOURCE_REMOVE;
+}
+
+/* called with state_lock. StateChanged only reaches the cache while
+   signal_context is iterated, which may never happen in a client without
+   a main loop. a marker is queued there on every use and the cache is
+   only trusted once the marker of the previous use has run */
+static bool manager_state_is_dispatched_no_lock(void)
+{
+	GSource *source;
+
+	if (true == state_marker_pending)
+		return false;
+
+	state_marker_pending = true;
+
+	source = g_idle_source_new();
+	g_source_set_callback(source, manager_state_marker, NULL, NULL);
+	g_source_attach(source, signal_context);
+	g_source_unref(source);
+
+	return true;
+}
+
+static void manager_call_set_event_filter_callback(GObject *source_object,
+		GAsyncResult *res, gpointer user_data)
+{
+	gboolean ret;
+	GError *error = NULL;
+	net_nfc_error_e result;
+
+	ret = net_nfc_gdbus_manager_call_set_event_filter_finish(
+			NET_NFC_GDBUS_MANAGER(source_object),
+			(gint *)&result,
+			res,
+			&error);
+
+	if (FALSE == ret)
+	{
+		NFC_ERR("Can not finish set_event_filter: %s", error->message);
+		g_error_free(error);
+	}
+	else if (result != NET_NFC_OK)
+	{
+		NFC_ERR("set_event_filter failed, [%d]", result);
+	}
+}
+
+static void manager_push_event_filter(void)
+{
+	guint32 tech_mask;
+	GVariant *ndef_types;
+	gboolean raw_data;
+
+	g_variant_get(event_filter, "(u@a(yay)b)", &tech_mask, &ndef_types,
+			&raw_data);
+
+	net_nfc_gdbus_manager_call_set_event_filter(manager_proxy,
+			tech_mask,
+			ndef_types,
+			raw_data,
+			net_nfc_client_gdbus_get_privilege(),
+			NULL,
+			manager_call_set_event_filter_callback,
+			NULL);
+
+	g_variant_unref(ndef_types);
+}
+
+static void manager_name_owner_changed(GObject *object, GParamSpec *pspec,
+		gpointer user_data)
+{
+	gchar *owner;
+
+	owner = g_dbus_proxy_get_name_owner(G_DBUS_PROXY(object));
+	if (NULL == owner)
+	{
+		/* a restarted daemon starts over, ask again */
+		pthread_mutex_lock(&state_lock);
+
+		if (state_cache != NULL)
+		{
+			g_hash_table_destroy(state_cache);
+			state_cache = NULL;
+		}
+
+		pthread_mutex_unlock(&state_lock);
+	}
+	else if (event_filter != NULL)
+	{
+		manager_push_event_filter();
+	}
+
+	g_free(owner);
+}
+
+/* called with state_lock */
+static void manager_state_lookup_no_lock(const char * const *keys,
+		GVariant **values, int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+	{
+		values[i] = g_hash_table_lookup(state_cache, keys[i]);
+		if (values[i] != NULL)
+			g_variant_ref(values[i]);
+	}
+}
+
+bool net_nfc_client_manager_get_states(const char * const *keys,
+		GVariant **values, int count)
+{
+	gboolean ret;
+	GError *error = NULL;
+	GVariant *out_state = NULL;
+	GHashTable *cache;
+	net_nfc_error_e result;
+
+	RETV_IF(NULL == keys, false);
+	RETV_IF(NULL == values, false);
+	RETV_IF(NULL == manager_proxy, false);
+
+	pthread_mutex_lock(&state_lock);
+
+	if (state_cache != NULL && manager_state_is_dispatched_no_lock() == true)
+	{
+		manager_state_lookup_no_lock(keys, values, count);
+
+		pthread_mutex_unlock(&state_lock);
+
+		return true;
+	}
+
+	pthread_mutex_unlock(&state_lock);
+
+	/* no cache yet or it may have missed signals, ask the daemon */
+	ret = net_nfc_gdbus_manager_call_get_snapshot_sync(manager_proxy,
+			net_nfc_client_gdbus_get_privilege(),
+			(gint *)&result,
+			&out_state,
+			NULL,
+			&error);
+	if (FALSE == ret)
+	{
+		NFC_ERR("can not call GetSnapshot: %s", error->message);
+		g_error_free(error);
+
+		return false;
+	}
+
+	if (result != NET_NFC_OK)
+	{
+		g_variant_unref(out_state);
+
+		return false;
+	}
+
+	cache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+			(GDestroyNotify)g_variant_unref);
+
+	pthread_mutex_lock(&state_lock);
+
+	manager_state_merge(cache, out_state);
+
+	if (state_cache != NULL)
+		g_hash_table_destroy(state_cache);
+	state_cache = cache;
+
+	manager_state_lookup_no_lock(keys, values, count);
+
+	pthread_mutex_unlock(&state_lock);
+
+	g_variant_unref(out_state);
+
+	return true;
+}
+
+API GVariant *net_nfc_client_manager_get_state(const char *key)
+{
+	GVariant *value = NULL;
+
+	RETV_IF(NULL == key, NULL);
+
+	if (net_nfc_client_manager_get_states(&key, &value, 1) == false)
+		return NULL;
+
+	return value;
+}
+
 API void net_nfc_client_manager_set_activated(
 		net_nfc_client_manager_activated callback, void *user_data)
 {
@@ -188,6 +442,7 @@ API net_nfc_error_e net_nfc_client_manager_get_server_state_sync(
 		unsigned int *state)
 {
 	gboolean ret;
+	GVariant *cached;
 	guint out_state = 0;
 	GError *error = NULL;
 	net_nfc_error_e out_result = NET_NFC_OK;
@@ -200,6 +455,38 @@ API net_nfc_error_e net_nfc_client_manager_get_server_state_sync(
 
 	*state = 0;
 
+	cached = net_nfc_client_manager_get_state("server_state");
+	if (cached != NULL)
+	{
+		*state = g_variant_get_uint32(cached);
+		g_variant_unref(cached);
+
+		return NET_NFC_OK;
+	}
+
+#ifdef USE_SOCKET_IPC
+	if (net_nfc_client_ipc_is_connected() == true)
+	{
+		data_s reply = { NULL, 0 };
+
+		out_result = net_nfc_client_ipc_call_sync(NET_NFC_IPC_GET_SERVER_STATE,
+				NULL, 0, &reply);
+		if (NET_NFC_OK == out_result && reply.length == sizeof(out_state))
+			memcpy(&out_state, reply.buffer, sizeof(out_state));
+
+		if (reply.buffer != NULL)
+			net_nfc_util_free_data(&reply);
+
+		/* a broken socket falls through to D-Bus */
+		if (out_result != NET_NFC_IPC_FAIL)
+		{
+			*state = out_state;
+
+			return out_result;
+		}
+	}
+#endif
+
 	ret = net_nfc_gdbus_manager_call_get_server_state_sync(manager_proxy,
 			net_nfc_client_gdbus_get_privilege(),
 			&out_result,
@@ -222,6 +509,98 @@ API net_nfc_error_e net_nfc_client_manager_get_server_state_sync(
 	return out_result;
 }
 
+API net_nfc_error_e net_nfc_client_manager_set_event_filter_sync(
+		net_nfc_event_filter_e tech_mask,
+		net_nfc_ndef_type_filter_s *types,
+		int count,
+		bool raw_data)
+{
+	int i;
+	gboolean ret;
+	GError *error = NULL;
+	GVariant *filter;
+	GVariant *ndef_types;
+	GVariantBuilder builder;
+	net_nfc_error_e out_result = NET_NFC_OK;
+
+	RETV_IF(NULL == manager_proxy, NET_NFC_NOT_INITIALIZED);
+	RETV_IF(count > 0 && NULL == types, NET_NFC_NULL_PARAMETER);
+
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("a(yay)"));
+
+	for (i = 0; i < count; i++)
+		g_variant_builder_add(&builder, "(y@ay)", (guint8)types[i].tnf,
+				net_nfc_util_gdbus_data_to_variant(types[i].type));
+
+	ndef_types = g_variant_ref_sink(g_variant_builder_end(&builder));
+
+	ret = net_nfc_gdbus_manager_call_set_event_filter_sync(manager_proxy,
+			(guint)tech_mask,
+			ndef_types,
+			raw_data,
+			net_nfc_client_gdbus_get_privilege(),
+			(gint *)&out_result,
+			NULL,
+			&error);
+
+	if (FALSE == ret)
+	{
+		NFC_ERR("can not call SetEventFilter: %s", error->message);
+		g_error_free(error);
+
+		out_result = NET_NFC_IPC_FAIL;
+	}
+
+	if (NET_NFC_OK == out_result)
+	{
+		filter = g_variant_ref_sink(g_variant_new("(u@a(yay)b)",
+					(guint32)tech_mask, ndef_types, (gboolean)raw_data));
+
+		if (event_filter != NULL)
+			g_variant_unref(event_filter);
+		event_filter = filter;
+	}
+
+	g_variant_unref(ndef_types);
+
+	return out_result;
+}
+
+void net_nfc_client_manager_set_tag_event_filter(net_nfc_event_filter_e tech_mask)
+{
+	GVariant *ndef_types;
+
+	RET_IF(NULL == manager_proxy);
+
+	if (event_filter != NULL)
+	{
+		ndef_types = g_variant_get_child_value(event_filter, 1);
+		g_variant_unref(event_filter);
+	}
+	else
+	{
+		ndef_types = g_variant_ref_sink(g_variant_new_array(
+					G_VARIANT_TYPE("(yay)"), NULL, 0));
+	}
+
+	/* users of the tag api read the NDEF message of the event */
+	event_filter = g_variant_ref_sink(g_variant_new("(u@a(yay)b)",
+				(guint32)tech_mask, ndef_types, TRUE));
+	g_variant_unref(ndef_types);
+
+	manager_push_event_filter();
+}
+
+bool net_nfc_client_manager_get_event_filter_raw_data(void)
+{
+	gboolean raw_data = FALSE;
+
+	if (event_filter != NULL)
+		g_variant_get_child(event_filter, 2, "b", &raw_data);
+
+	return raw_data;
+}
+
 net_nfc_error_e net_nfc_client_manager_init(void)
 {
 	GError *error = NULL;
@@ -248,8 +627,16 @@ net_nfc_error_e net_nfc_client_manager_init(void)
 		return NET_NFC_UNKNOWN_ERROR;
 	}
 
+	signal_context = g_main_context_ref_thread_default();
+
 	g_signal_connect(manager_proxy, "activated", G_CALLBACK(manager_activated), NULL);
 
+	g_signal_connect(manager_proxy, "state-changed",
+			G_CALLBACK(manager_state_changed), NULL);
+
+	g_signal_connect(manager_proxy, "notify::g-name-owner",
+			G_CALLBACK(manager_name_owner_changed), NULL);
+
 	return NET_NFC_OK;
 }
 
@@ -271,6 +658,30 @@ void net_nfc_client_manager_deinit(void)
 		g_object_unref(manager_proxy);
 		manager_proxy = NULL;
 	}
+
+	pthread_mutex_lock(&state_lock);
+
+	if (state_cache != NULL)
+	{
+		g_hash_table_destroy(state_cache);
+		state_cache = NULL;
+	}
+
+	state_marker_pending = false;
+
+	pthread_mutex_unlock(&state_lock);
+
+	if (signal_context != NULL)
+	{
+		g_main_context_unref(signal_context);
+		signal_context = NULL;
+	}
+
+	if (event_filter != NULL)
+	{
+		g_variant_unref(event_filter);
+		event_filter = NULL;
+	}
 }
 
 /* internal function */
@@ -179,7 +179,6 @@ API net_nfc_error_e net_nfc_client_ndef_write(net_nfc_target_handle_s *handle,
 		net_nfc_client_ndef_write_completed callback,
 		void *user_data)
 {
-	size_t length;
 	net_nfc_error_e ret;
 	data_s data = {NULL, 0};
 
@@ -190,25 +189,11 @@ API net_nfc_error_e net_nfc_client_ndef_write(net_nfc_target_handle_s *handle,
 	RETV_IF(net_nfc_client_manager_is_activated() == false, NET_NFC_INVALID_STATE);
 	RETV_IF(net_nfc_client_tag_is_connected() == FALSE, NET_NFC_NOT_CONNECTED);
 
-	length = net_nfc_util_get_ndef_message_length((ndef_message_s *)message);
-	if (length > 0) {
-		if (net_nfc_util_alloc_data(&data, length) == true) {
-			ret = net_nfc_util_convert_ndef_message_to_rawdata((ndef_message_s *)message,
-						&data);
-			if (NET_NFC_OK != ret) {
-				NFC_ERR("can not convert ndef_message to rawdata");
-
-				net_nfc_util_free_data(&data);
-			}
-		} else {
-			NFC_ERR("net_nfc_util_alloc_data failed");
-
-			return NET_NFC_ALLOC_FAIL;
-		}
-	} else {
-		NFC_ERR("message length is 0");
-
-		return NET_NFC_INVALID_PARAM;
+	ret = net_nfc_util_serialize_ndef_message(message, 0, &data);
+	if (ret != NET_NFC_OK) {
+		NFC_ERR("can not convert ndef_message to rawdata [%d]", ret);
+
+		return ret;
 	}
 
 	ret = net_nfc_neard_write_ndef(handle, &data, callback, user_data);
@@ -224,6 +209,8 @@ API net_nfc_error_e net_nfc_client_ndef_write_sync(net_nfc_target_handle_s *hand
 	gboolean ret;
 	GVariant *arg_data;
 	GError *error = NULL;
+	GUnixFDList *fd_list = NULL;
+	data_s data = { NULL, 0 };
 	net_nfc_error_e out_result = NET_NFC_OK;
 
 	RETV_IF(NULL == handle, NET_NFC_NULL_PARAMETER);
@@ -235,15 +222,41 @@ API net_nfc_error_e net_nfc_client_ndef_write_sync(net_nfc_target_handle_s *hand
 	RETV_IF(net_nfc_client_manager_is_activated() == false, NET_NFC_INVALID_STATE);
 	RETV_IF(net_nfc_client_tag_is_connected() == FALSE, NET_NFC_NOT_CONNECTED);
 
-	arg_data = net_nfc_util_gdbus_ndef_message_to_variant(message);
+	if (net_nfc_util_get_ndef_message_length(message) >=
+			NET_NFC_UTIL_GDBUS_FD_THRESHOLD &&
+			net_nfc_util_serialize_ndef_message(message, 0, &data) == NET_NFC_OK)
+	{
+		fd_list = net_nfc_util_gdbus_data_to_fd_list(&data);
 
-	ret = net_nfc_gdbus_ndef_call_write_sync(ndef_proxy ,
-			GPOINTER_TO_UINT(handle),
-			arg_data,
-			net_nfc_client_gdbus_get_privilege(),
-			(gint *)&out_result,
-			NULL,
-			&error);
+		net_nfc_util_free_data(&data);
+	}
+
+	if (fd_list != NULL)
+	{
+		ret = net_nfc_gdbus_ndef_call_write_fd_sync(ndef_proxy,
+				GPOINTER_TO_UINT(handle),
+				0 /* index in fd_list */,
+				net_nfc_client_gdbus_get_privilege(),
+				fd_list,
+				(gint *)&out_result,
+				NULL,
+				NULL,
+				&error);
+
+		g_object_unref(fd_list);
+	}
+	else
+	{
+		arg_data = net_nfc_util_gdbus_ndef_message_to_variant(message);
+
+		ret = net_nfc_gdbus_ndef_call_write_sync(ndef_proxy ,
+				GPOINTER_TO_UINT(handle),
+				arg_data,
+				net_nfc_client_gdbus_get_privilege(),
+				(gint *)&out_result,
+				NULL,
+				&error);
+	}
 
 	if (FALSE == ret)
 	{
@@ -84,6 +84,11 @@ static void p2p_device_data_received(GObject *source_object, GVariant *arg_data,
 
 	RET_IF(NULL == p2p_signal_handler.p2p_data_received_cb);
 
+	/* the broadcast after the copy with the payload sent to this client */
+	if (g_variant_n_children(arg_data) == 0 &&
+			net_nfc_client_manager_get_event_filter_raw_data() == true)
+		return;
+
 	net_nfc_util_gdbus_variant_to_data_s(arg_data, &p2p_data);
 	p2p_signal_handler.p2p_data_received_cb(&p2p_data,
 		p2p_signal_handler.p2p_data_received_data);
@@ -108,6 +113,7 @@ API net_nfc_error_e net_nfc_client_p2p_send_sync(net_nfc_target_handle_s *handle
 	gboolean ret;
 	GVariant *arg_data;
 	GError *error = NULL;
+	GUnixFDList *fd_list;
 	net_nfc_error_e out_result;
 
 	RETV_IF(NULL == p2p_proxy, NET_NFC_NOT_INITIALIZED);
@@ -115,16 +121,35 @@ API net_nfc_error_e net_nfc_client_p2p_send_sync(net_nfc_target_handle_s *handle
 	/* prevent executing daemon when nfc is off */
 	RETV_IF(net_nfc_client_manager_is_activated() == false, NET_NFC_INVALID_STATE);
 
-	arg_data = net_nfc_util_gdbus_data_to_variant(data);
-
-	ret = net_nfc_gdbus_p2p_call_send_sync(p2p_proxy,
-			0 /* FIXME */,
-			arg_data,
-			GPOINTER_TO_UINT(handle),
-			net_nfc_client_gdbus_get_privilege(),
-			(gint *)&out_result,
-			NULL,
-			&error);
+	fd_list = net_nfc_util_gdbus_data_to_fd_list(data);
+	if (fd_list != NULL)
+	{
+		ret = net_nfc_gdbus_p2p_call_send_fd_sync(p2p_proxy,
+				0 /* FIXME */,
+				0 /* index in fd_list */,
+				GPOINTER_TO_UINT(handle),
+				net_nfc_client_gdbus_get_privilege(),
+				fd_list,
+				(gint *)&out_result,
+				NULL,
+				NULL,
+				&error);
+
+		g_object_unref(fd_list);
+	}
+	else
+	{
+		arg_data = net_nfc_util_gdbus_data_to_variant(data);
+
+		ret = net_nfc_gdbus_p2p_call_send_sync(p2p_proxy,
+				0 /* FIXME */,
+				arg_data,
+				GPOINTER_TO_UINT(handle),
+				net_nfc_client_gdbus_get_privilege(),
+				(gint *)&out_result,
+				NULL,
+				&error);
+	}
 
 	if (FALSE == ret)
 	{
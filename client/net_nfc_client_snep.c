@@ -66,6 +66,59 @@ static void snep_send_client_request(GObject *source_object, GAsyncResult *res,
 	g_variant_unref(parameter);
 }
 
+static void snep_send_client_request_fd(GObject *source_object,
+		GAsyncResult *res, gpointer user_data)
+{
+	void *user_param;
+	GError *error = NULL;
+	gint out_data_fd = -1;
+	GVariant *out_data = NULL;
+	GUnixFDList *out_fd_list = NULL;
+	net_nfc_error_e out_result;
+	net_nfc_snep_handle_h handle;
+	net_nfc_client_snep_event_cb callback;
+	GVariant *parameter = (GVariant *)user_data;
+	net_nfc_snep_type_t out_type = NET_NFC_SNEP_GET;
+
+	g_assert(parameter != NULL);
+
+	if (net_nfc_gdbus_snep_call_client_request_fd_finish(
+				NET_NFC_GDBUS_SNEP(source_object), (gint *)&out_result,
+				(guint *)&out_type, &out_data, &out_data_fd, &out_fd_list, res,
+				&error) == FALSE)
+	{
+		NFC_ERR("Can not finish send client request %s", error->message);
+		g_error_free(error);
+
+		out_result = NET_NFC_IPC_FAIL;
+	}
+
+	g_variant_get(parameter, "(uuu)", (guint *)&callback, (guint *)&user_param,
+			(guint *)&handle);
+
+	if (callback != NULL) {
+		ndef_message_s *message = NULL;
+
+		/* a large response is mapped read only, not copied */
+		if (out_data_fd >= 0)
+			message = net_nfc_util_gdbus_fd_list_to_ndef_message(out_fd_list,
+					out_data_fd);
+		else
+			message = net_nfc_util_gdbus_variant_to_ndef_message(out_data);
+
+		callback(handle, out_type, out_result,message, user_param);
+		net_nfc_free_ndef_message(message);
+	}
+
+	if (out_data != NULL)
+		g_variant_unref(out_data);
+
+	if (out_fd_list != NULL)
+		g_object_unref(out_fd_list);
+
+	g_variant_unref(parameter);
+}
+
 API net_nfc_error_e net_nfc_client_snep_start_server(
 		net_nfc_target_handle_s *target,
 		const char *san,
@@ -157,6 +210,8 @@ API net_nfc_error_e net_nfc_client_snep_send_client_request(
 {
 	GVariant *parameter;
 	GVariant *ndef_msg = NULL;
+	GUnixFDList *fd_list = NULL;
+	data_s data = { NULL, 0 };
 
 	RETV_IF(NULL == target, NET_NFC_NULL_PARAMETER);
 	RETV_IF(NULL == msg, NET_NFC_NULL_PARAMETER);
@@ -170,6 +225,32 @@ API net_nfc_error_e net_nfc_client_snep_send_client_request(
 			GPOINTER_TO_UINT(user_data),
 			GPOINTER_TO_UINT(target));
 
+	if (net_nfc_util_get_ndef_message_length(msg) >=
+			NET_NFC_UTIL_GDBUS_FD_THRESHOLD &&
+			net_nfc_util_serialize_ndef_message(msg, 0, &data) == NET_NFC_OK)
+	{
+		fd_list = net_nfc_util_gdbus_data_to_fd_list(&data);
+
+		net_nfc_util_free_data(&data);
+	}
+
+	if (fd_list != NULL)
+	{
+		net_nfc_gdbus_snep_call_client_request_fd(snep_proxy,
+				GPOINTER_TO_UINT(target),
+				snep_type,
+				0 /* index in fd_list */,
+				net_nfc_client_gdbus_get_privilege(),
+				fd_list,
+				NULL,
+				snep_send_client_request_fd,
+				parameter);
+
+		g_object_unref(fd_list);
+
+		return NET_NFC_OK;
+	}
+
 	ndef_msg = net_nfc_util_gdbus_ndef_message_to_variant(msg);
 
 	net_nfc_gdbus_snep_call_client_request(snep_proxy,
@@ -15,6 +15,7 @@
  */
 #include "net_nfc_typedef_internal.h"
 #include "net_nfc_debug_internal.h"
+#include "net_nfc_util_internal.h"
 #include "net_nfc_util_gdbus_internal.h"
 #include "net_nfc_gdbus.h"
 #include "net_nfc_data.h"
@@ -36,91 +37,14 @@ static net_nfc_event_filter_e client_filter = NET_NFC_ALL_ENABLE;
 
 static gboolean tag_check_filter(net_nfc_target_type_e type)
 {
-	net_nfc_event_filter_e converted = NET_NFC_ALL_ENABLE;
-
 	NFC_DBG("client filter =  %d", client_filter);
 
-	if (type >= NET_NFC_ISO14443_A_PICC
-			&& type <= NET_NFC_MIFARE_DESFIRE_PICC)
-	{
-		converted = NET_NFC_ISO14443A_ENABLE;
-	}
-	else if (type >= NET_NFC_ISO14443_B_PICC
-			&& type <= NET_NFC_ISO14443_BPRIME_PICC)
-	{
-		converted = NET_NFC_ISO14443B_ENABLE;
-	}
-	else if (type == NET_NFC_FELICA_PICC)
-	{
-		converted = NET_NFC_FELICA_ENABLE;
-	}
-	else if (type == NET_NFC_JEWEL_PICC)
-	{
-		converted = NET_NFC_FELICA_ENABLE;
-	}
-	else if (type == NET_NFC_ISO15693_PICC)
-	{
-		converted = NET_NFC_ISO15693_ENABLE;
-	}
-
-	if ((converted & client_filter) == 0)
+	if ((net_nfc_util_get_event_filter(type) & client_filter) == 0)
 		return FALSE;
 
 	return TRUE;
 }
 
-static void tag_get_info_list(guint8 *buffer, gint number_of_keys,
-		net_nfc_tag_info_s **list)
-{
-	gint i = 0;
-	gint length;
-	guint8 *pos = buffer;
-	net_nfc_tag_info_s *current = NULL;
-	net_nfc_tag_info_s *tmp_list = NULL;
-
-	RET_IF(NULL == buffer);
-
-	tmp_list = g_new0(net_nfc_tag_info_s, number_of_keys);
-	current = tmp_list;
-
-	while (i < number_of_keys)
-	{
-		gchar *str = NULL;
-		data_s *value = NULL;
-
-		/* key */
-		length = *pos;	/* first values is length of key */
-		pos++;
-
-		str = g_new0(gchar, length + 1);
-		memcpy(str, pos, length);
-
-		NFC_DBG("key = [%s]", str);
-
-		pos += length;
-
-		current->key = str;
-
-		/* value */
-		length = *pos; /* first value is length of value */
-		pos++;
-
-		value = NULL;
-		if (length > 0)
-		{
-			net_nfc_create_data(&value, pos, length);
-			pos += length;
-		}
-
-		current->value = value;
-
-		current++;
-		i++;
-	}
-
-	*list = tmp_list;
-}
-
 static void tag_get_target_info(guint handle,
 		guint dev_type,
 		gboolean is_ndef_supported,
@@ -132,15 +56,23 @@ static void tag_get_target_info(guint handle,
 		GVariant *raw_data,
 		net_nfc_target_info_s **info)
 {
-	guint8 *buffer = NULL;
+	gsize length = 0;
+	gint decoded_keys = 0;
+	const guint8 *buffer = NULL;
 	net_nfc_tag_info_s *list = NULL;
 	net_nfc_target_info_s *info_data = NULL;
 
 	RET_IF(NULL == info);
 
-	net_nfc_util_gdbus_variant_to_buffer(target_info_values, &buffer, NULL);
+	/* decoded straight from the variant, the count travels in the encoding */
+	if (number_of_keys > 0 && g_variant_is_of_type(target_info_values,
+				G_VARIANT_TYPE_BYTESTRING))
+	{
+		buffer = g_variant_get_fixed_array(target_info_values, &length,
+				sizeof(guint8));
 
-	tag_get_info_list(buffer, number_of_keys, &list);
+		list = net_nfc_util_decode_tag_info(buffer, length, &decoded_keys);
+	}
 
 	info_data = g_new0(net_nfc_target_info_s, 1);
 
@@ -150,7 +82,7 @@ static void tag_get_target_info(guint handle,
 	info_data->devType = dev_type;
 	info_data->handle = GUINT_TO_POINTER(handle);
 	info_data->is_ndef_supported = (uint8_t)is_ndef_supported;
-	info_data->number_of_keys = number_of_keys;
+	info_data->number_of_keys = decoded_keys;
 	info_data->tag_info_list = list;
 
 	net_nfc_util_gdbus_variant_to_data_s(raw_data, &info_data->raw_data);
@@ -344,6 +276,15 @@ static void tag_tag_discovered(NetNfcGDbusTag *object,
 
 	NFC_INFO(">>> SIGNAL arrived");
 
+	/* the broadcast after the copy with raw data sent to this client */
+	if (client_target_info != NULL &&
+			GPOINTER_TO_UINT(client_target_info->handle) == arg_handle)
+	{
+		NFC_DBG("tag [%u] is already reported", arg_handle);
+
+		return;
+	}
+
 	net_nfc_release_tag_info(client_target_info);
 	client_target_info = NULL;
 
@@ -441,6 +382,8 @@ API net_nfc_error_e net_nfc_client_tag_is_tag_connected_sync(
 		net_nfc_target_type_e *dev_type)
 {
 	gboolean ret;
+	GVariant *cached[2] = { NULL, NULL };
+	const char *keys[2] = { "tag_connected", "tag_type" };
 	GError *error = NULL;
 	net_nfc_target_info_s *info;
 	gboolean out_is_connected = FALSE;
@@ -455,6 +398,33 @@ API net_nfc_error_e net_nfc_client_tag_is_tag_connected_sync(
 	info = net_nfc_client_tag_get_client_target_info();
 	if (NULL == info)
 	{
+		/* the manager state cache follows tag events already */
+		if (net_nfc_client_manager_get_states(keys, cached, 2) == true &&
+				cached[0] != NULL)
+		{
+			out_is_connected = g_variant_get_boolean(cached[0]);
+			if (TRUE == out_is_connected && cached[1] != NULL)
+			{
+				if (dev_type)
+					*dev_type = g_variant_get_int32(cached[1]);
+
+				result = NET_NFC_OK;
+			}
+			else
+			{
+				result = NET_NFC_NOT_CONNECTED;
+			}
+
+			g_variant_unref(cached[0]);
+			if (cached[1] != NULL)
+				g_variant_unref(cached[1]);
+
+			return result;
+		}
+
+		if (cached[1] != NULL)
+			g_variant_unref(cached[1]);
+
 		/* try to request target information from server */
 		ret = net_nfc_gdbus_tag_call_is_tag_connected_sync(tag_proxy,
 				net_nfc_client_gdbus_get_privilege(),
@@ -599,6 +569,8 @@ API void net_nfc_client_tag_unset_tag_detached(void)
 API void net_nfc_client_tag_set_filter(net_nfc_event_filter_e filter)
 {
 	client_filter = filter;
+
+	net_nfc_client_manager_set_tag_event_filter(filter);
 }
 
 API net_nfc_event_filter_e net_nfc_client_tag_get_filter(void)
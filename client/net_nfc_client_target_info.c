@@ -120,7 +120,6 @@ API net_nfc_error_e net_nfc_get_tag_info_keys(net_nfc_target_info_s *target_info
 API net_nfc_error_e net_nfc_get_tag_info_value(net_nfc_target_info_s *target_info,
 		const char *key, data_s **value)
 {
-	int i;
 	net_nfc_tag_info_s *tag_info;
 
 	RETV_IF(NULL == key, NET_NFC_NULL_PARAMETER);
@@ -129,27 +128,13 @@ API net_nfc_error_e net_nfc_get_tag_info_value(net_nfc_target_info_s *target_inf
 
 	RETV_IF(NULL == target_info->tag_info_list, NET_NFC_NO_DATA_FOUND);
 
-	tag_info = target_info->tag_info_list;
-
-	for (i = 0; i < target_info->number_of_keys; i++, tag_info++)
-	{
-		if (strcmp(key, tag_info->key) == 0)
-		{
-			if (NULL == tag_info->value)
-			{
-				return NET_NFC_NO_DATA_FOUND;
-			}
-			else
-			{
-				*value = tag_info->value;
-				break;
-			}
-		}
-	}
-
-	if (i == target_info->number_of_keys)
+	tag_info = net_nfc_util_find_tag_info(target_info->tag_info_list,
+			target_info->number_of_keys, key);
+	if (NULL == tag_info || NULL == tag_info->value)
 		return NET_NFC_NO_DATA_FOUND;
 
+	*value = tag_info->value;
+
 	return NET_NFC_OK;
 }
 
@@ -175,33 +160,14 @@ API net_nfc_error_e net_nfc_duplicate_target_info(net_nfc_target_info_s *origin,
 
 	if (0 < temp->number_of_keys)
 	{
-		int i;
-
-		_net_nfc_util_alloc_mem(temp->tag_info_list,
-				temp->number_of_keys * sizeof(net_nfc_tag_info_s));
+		temp->tag_info_list = net_nfc_util_duplicate_tag_info(
+				origin->tag_info_list, origin->number_of_keys);
 
 		if (NULL == temp->tag_info_list)
 		{
 			_net_nfc_util_free_mem(temp);
 			return NET_NFC_ALLOC_FAIL;
 		}
-
-		for (i = 0; i < origin->number_of_keys; i++)
-		{
-			if (origin->tag_info_list[i].key != NULL)
-			{
-				_net_nfc_util_strdup(temp->tag_info_list[i].key,
-					origin->tag_info_list[i].key);
-			}
-
-			if (origin->tag_info_list[i].value != NULL)
-			{
-				data_s *data = origin->tag_info_list[i].value;
-
-				net_nfc_create_data(&temp->tag_info_list[i].value,
-					data->buffer, data->length);
-			}
-		}
 	}
 
 	if (0 < origin->raw_data.length)
@@ -217,27 +183,12 @@ API net_nfc_error_e net_nfc_duplicate_target_info(net_nfc_target_info_s *origin,
 
 static net_nfc_error_e _release_tag_info(net_nfc_target_info_s *info)
 {
-	net_nfc_tag_info_s *list = NULL;
-
 	if (NULL == info)
 		return NET_NFC_NULL_PARAMETER;
 
-	list = info->tag_info_list;
-	if (list != NULL)
-	{
-		int i;
-
-		for (i = 0; i < info->number_of_keys; i++, list++)
-		{
-			if (list->key != NULL)
-				_net_nfc_util_free_mem(list->key);
-
-			if (list->value != NULL)
-				net_nfc_free_data(list->value);
-		}
-
-		_net_nfc_util_free_mem(info->tag_info_list);
-	}
+	/* keys and values live in the list allocation */
+	net_nfc_util_free_tag_info(info->tag_info_list);
+	info->tag_info_list = NULL;
 
 	if (info->keylist != NULL)
 	{
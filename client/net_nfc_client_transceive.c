@@ -25,28 +25,36 @@
 #include "net_nfc_client_manager.h"
 #include "net_nfc_client_tag_internal.h"
 #include "net_nfc_client_transceive.h"
+#ifdef USE_SOCKET_IPC
+#include "net_nfc_client_ipc_internal.h"
+#endif
 
-static NetNfcGDbusTransceive *transceive_proxy = NULL;
+typedef struct _TransceiveBatchFuncData TransceiveBatchFuncData;
 
-static GVariant *transceive_data_to_transceive_variant(
-		net_nfc_target_type_e devType, data_s *data)
+struct _TransceiveBatchFuncData
 {
-	GVariant *variant;
-	data_s transceive_info = { NULL, };
+	gpointer callback;
+	gpointer user_data;
+	net_nfc_transceive_command_s *commands;
+	int count;
+};
 
-	RETV_IF(NULL == data, NULL);
+static NetNfcGDbusTransceive *transceive_proxy = NULL;
 
+static bool transceive_data_prepare(net_nfc_target_type_e devType,
+		data_s *data, data_s *transceive_info)
+{
 	switch (devType)
 	{
 	case NET_NFC_MIFARE_MINI_PICC :
 	case NET_NFC_MIFARE_1K_PICC :
 	case NET_NFC_MIFARE_4K_PICC :
 	case NET_NFC_MIFARE_ULTRA_PICC :
-		if (net_nfc_util_alloc_data(&transceive_info, data->length + 2) == true)
+		if (net_nfc_util_alloc_data(transceive_info, data->length + 2) == true)
 		{
-			memcpy(transceive_info.buffer, data->buffer, data->length);
+			memcpy(transceive_info->buffer, data->buffer, data->length);
 
-			net_nfc_util_compute_CRC(CRC_A, transceive_info.buffer, transceive_info.length);
+			net_nfc_util_compute_CRC(CRC_A, transceive_info->buffer, transceive_info->length);
 		}
 		break;
 
@@ -54,24 +62,38 @@ static GVariant *transceive_data_to_transceive_variant(
 		if (data->length > 9)
 		{
 			NFC_ERR("data length is larger than 9");
-			return NULL;
+			return false;
 		}
 
-		if (net_nfc_util_alloc_data(&transceive_info, 9) == true)
+		if (net_nfc_util_alloc_data(transceive_info, 9) == true)
 		{
-			memcpy(transceive_info.buffer, data->buffer, data->length);
+			memcpy(transceive_info->buffer, data->buffer, data->length);
 
-			net_nfc_util_compute_CRC(CRC_B, transceive_info.buffer, transceive_info.length);
+			net_nfc_util_compute_CRC(CRC_B, transceive_info->buffer, transceive_info->length);
 		}
 		break;
 
 	default :
-		if(net_nfc_util_alloc_data(&transceive_info, data->length) == true)
-			memcpy(transceive_info.buffer, data->buffer, data->length);
+		if(net_nfc_util_alloc_data(transceive_info, data->length) == true)
+			memcpy(transceive_info->buffer, data->buffer, data->length);
 
 		break;
 	}
 
+	return true;
+}
+
+static GVariant *transceive_data_to_transceive_variant(
+		net_nfc_target_type_e devType, data_s *data)
+{
+	GVariant *variant;
+	data_s transceive_info = { NULL, };
+
+	RETV_IF(NULL == data, NULL);
+
+	if (transceive_data_prepare(devType, data, &transceive_info) == false)
+		return NULL;
+
 	variant = net_nfc_util_gdbus_data_to_variant(&transceive_info);
 
 	net_nfc_util_free_data(&transceive_info);
@@ -79,6 +101,165 @@ static GVariant *transceive_data_to_transceive_variant(
 	return variant;
 }
 
+#ifdef USE_SOCKET_IPC
+static net_nfc_error_e transceive_ipc(net_nfc_target_handle_s *handle,
+		net_nfc_target_type_e devType, data_s *data, data_s **response)
+{
+	uint32_t params[2];
+	data_s payload = { NULL, };
+	data_s transceive_info = { NULL, };
+	data_s reply = { NULL, 0 };
+	net_nfc_error_e result;
+
+	if (transceive_data_prepare(devType, data, &transceive_info) == false)
+		return NET_NFC_INVALID_PARAM;
+
+	params[0] = GPOINTER_TO_UINT(handle);
+	params[1] = devType;
+
+	if (net_nfc_util_alloc_data(&payload,
+				sizeof(params) + transceive_info.length) == false)
+	{
+		net_nfc_util_free_data(&transceive_info);
+
+		return NET_NFC_ALLOC_FAIL;
+	}
+
+	memcpy(payload.buffer, params, sizeof(params));
+	if (transceive_info.length > 0)
+		memcpy(payload.buffer + sizeof(params), transceive_info.buffer,
+				transceive_info.length);
+
+	net_nfc_util_free_data(&transceive_info);
+
+	result = net_nfc_client_ipc_call_sync(NET_NFC_IPC_TRANSCEIVE,
+			payload.buffer, payload.length, (response != NULL) ? &reply : NULL);
+
+	net_nfc_util_free_data(&payload);
+
+	if (response != NULL && reply.buffer != NULL)
+	{
+		*response = g_new0(data_s, 1);
+		**response = reply;
+	}
+
+	return result;
+}
+#endif
+
+static GVariant *transceive_batch_to_variant(net_nfc_target_type_e devType,
+		net_nfc_transceive_command_s *commands, int count)
+{
+	int i;
+	GVariant *data;
+	GVariantBuilder builder;
+
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("a(bay)"));
+
+	for (i = 0; i < count; i++)
+	{
+		data = transceive_data_to_transceive_variant(devType, commands[i].data);
+		if (NULL == data)
+		{
+			NFC_ERR("invalid command [%d]", i);
+			g_variant_builder_clear(&builder);
+
+			return NULL;
+		}
+
+		g_variant_builder_add(&builder, "(b@ay)",
+				commands[i].stop_on_error, data);
+	}
+
+	return g_variant_builder_end(&builder);
+}
+
+static void transceive_batch_fill(net_nfc_error_e result, GVariant *responses,
+		net_nfc_transceive_command_s *commands, int count)
+{
+	int i = 0;
+	gint cmd_result;
+	GVariant *data;
+	GVariantIter iter;
+
+	if (responses != NULL)
+	{
+		g_variant_iter_init(&iter, responses);
+
+		while (i < count &&
+				g_variant_iter_next(&iter, "(i@ay)", &cmd_result, &data))
+		{
+			commands[i].result = cmd_result;
+			commands[i].response = net_nfc_util_gdbus_variant_to_data(data);
+
+			g_variant_unref(data);
+			i++;
+		}
+	}
+
+	/* the rest were not run */
+	for (; i < count; i++)
+	{
+		commands[i].result = result;
+		commands[i].response = NULL;
+	}
+}
+
+static void transceive_batch_call(GObject *source_object,
+		GAsyncResult *res, gpointer user_data)
+{
+	int i;
+	gboolean ret;
+	GError *error = NULL;
+	GVariant *out_responses = NULL;
+	net_nfc_error_e out_result;
+	TransceiveBatchFuncData *func_data = user_data;
+
+	g_assert(user_data != NULL);
+
+	ret = net_nfc_gdbus_transceive_call_transceive_batch_finish(
+				NET_NFC_GDBUS_TRANSCEIVE(source_object),
+				(gint *)&out_result,
+				&out_responses,
+				res,
+				&error);
+
+	if (FALSE == ret)
+	{
+		NFC_ERR("Can not finish transceive batch: %s", error->message);
+		g_error_free(error);
+
+		out_result = NET_NFC_IPC_FAIL;
+	}
+
+	transceive_batch_fill(out_result, out_responses, func_data->commands,
+			func_data->count);
+
+	if (out_responses != NULL)
+		g_variant_unref(out_responses);
+
+	if (func_data->callback != NULL)
+	{
+		((nfc_transceive_batch_callback)func_data->callback)(
+			out_result,
+			func_data->commands,
+			func_data->count,
+			func_data->user_data);
+	}
+
+	for (i = 0; i < func_data->count; i++)
+	{
+		if (func_data->commands[i].response != NULL)
+		{
+			net_nfc_util_free_data(func_data->commands[i].response);
+			g_free(func_data->commands[i].response);
+			func_data->commands[i].response = NULL;
+		}
+	}
+
+	g_free(func_data);
+}
+
 static void transceive_data_call(GObject *source_object,
 		GAsyncResult *res, gpointer user_data)
 {
@@ -310,6 +491,11 @@ API net_nfc_error_e net_nfc_client_transceive_sync(net_nfc_target_handle_s *hand
 
 	NFC_DBG("send request :: transceive = [%p]", handle);
 
+#ifdef USE_SOCKET_IPC
+	if (net_nfc_client_ipc_is_connected() == true)
+		return transceive_ipc(handle, target_info->devType, rawdata, NULL);
+#endif
+
 	arg_data = transceive_data_to_transceive_variant(target_info->devType, rawdata);
 	if (NULL == arg_data)
 		return NET_NFC_ALLOC_FAIL;
@@ -367,6 +553,11 @@ API net_nfc_error_e net_nfc_client_transceive_data_sync(
 
 	NFC_DBG("send request :: transceive = [%p]", handle);
 
+#ifdef USE_SOCKET_IPC
+	if (net_nfc_client_ipc_is_connected() == true)
+		return transceive_ipc(handle, target_info->devType, rawdata, response);
+#endif
+
 	arg_data = transceive_data_to_transceive_variant(target_info->devType, rawdata);
 	if (NULL == arg_data)
 		return NET_NFC_ALLOC_FAIL;
@@ -396,6 +587,136 @@ API net_nfc_error_e net_nfc_client_transceive_data_sync(
 	return out_result;
 }
 
+API net_nfc_error_e net_nfc_client_transceive_batch(
+		net_nfc_target_handle_s *handle,
+		net_nfc_transceive_command_s *commands, int count,
+		nfc_transceive_batch_callback callback, void *user_data)
+{
+	GVariant *arg_commands;
+	TransceiveBatchFuncData *funcdata;
+	net_nfc_target_info_s *target_info;
+
+	RETV_IF(NULL == transceive_proxy, NET_NFC_NOT_INITIALIZED);
+
+	RETV_IF(NULL == handle, NET_NFC_NULL_PARAMETER);
+	RETV_IF(NULL == commands, NET_NFC_NULL_PARAMETER);
+	RETV_IF(count <= 0, NET_NFC_INVALID_PARAM);
+
+	/* prevent executing daemon when nfc is off */
+	RETV_IF(net_nfc_client_manager_is_activated() == false, NET_NFC_INVALID_STATE);
+
+	target_info = net_nfc_client_tag_get_client_target_info();
+	if (NULL == target_info)
+	{
+		NFC_ERR("target_info is NULL");
+		return NET_NFC_NOT_CONNECTED;
+	}
+
+	if (NULL == target_info->handle)
+	{
+		NFC_ERR("target_info->handle is NULL");
+		return NET_NFC_NOT_CONNECTED;
+	}
+
+	NFC_DBG("send request :: transceive batch = [%p], [%d] commands", handle, count);
+
+	arg_commands = transceive_batch_to_variant(target_info->devType, commands,
+			count);
+	if (NULL == arg_commands)
+		return NET_NFC_INVALID_PARAM;
+
+	funcdata = g_try_new0(TransceiveBatchFuncData, 1);
+	if (NULL == funcdata)
+	{
+		g_variant_unref(arg_commands);
+
+		return NET_NFC_ALLOC_FAIL;
+	}
+
+	funcdata->callback = (gpointer)callback;
+	funcdata->user_data = user_data;
+	funcdata->commands = commands;
+	funcdata->count = count;
+
+	net_nfc_gdbus_transceive_call_transceive_batch(transceive_proxy,
+			GPOINTER_TO_UINT(handle),
+			target_info->devType,
+			arg_commands,
+			net_nfc_client_gdbus_get_privilege(),
+			NULL,
+			transceive_batch_call,
+			funcdata);
+
+	return NET_NFC_OK;
+}
+
+API net_nfc_error_e net_nfc_client_transceive_batch_sync(
+		net_nfc_target_handle_s *handle,
+		net_nfc_transceive_command_s *commands, int count)
+{
+	gboolean ret;
+	GVariant *arg_commands;
+	GError *error = NULL;
+	GVariant *out_responses = NULL;
+	net_nfc_target_info_s *target_info;
+	net_nfc_error_e out_result = NET_NFC_OK;
+
+	RETV_IF(NULL == transceive_proxy, NET_NFC_NOT_INITIALIZED);
+
+	RETV_IF(NULL == handle, NET_NFC_NULL_PARAMETER);
+	RETV_IF(NULL == commands, NET_NFC_NULL_PARAMETER);
+	RETV_IF(count <= 0, NET_NFC_INVALID_PARAM);
+
+	/* prevent executing daemon when nfc is off */
+	RETV_IF(net_nfc_client_manager_is_activated() == false, NET_NFC_INVALID_STATE);
+
+	target_info = net_nfc_client_tag_get_client_target_info();
+	if (NULL == target_info)
+	{
+		NFC_ERR("target_info is NULL");
+		return NET_NFC_NOT_CONNECTED;
+	}
+
+	if (NULL == target_info->handle)
+	{
+		NFC_ERR("target_info->handle is NULL");
+		return NET_NFC_NOT_CONNECTED;
+	}
+
+	NFC_DBG("send request :: transceive batch = [%p], [%d] commands", handle, count);
+
+	arg_commands = transceive_batch_to_variant(target_info->devType, commands,
+			count);
+	if (NULL == arg_commands)
+		return NET_NFC_INVALID_PARAM;
+
+	ret = net_nfc_gdbus_transceive_call_transceive_batch_sync(
+				transceive_proxy,
+				GPOINTER_TO_UINT(handle),
+				target_info->devType,
+				arg_commands,
+				net_nfc_client_gdbus_get_privilege(),
+				(gint *)&out_result,
+				&out_responses,
+				NULL,
+				&error);
+
+	if (FALSE == ret)
+	{
+		NFC_ERR("Transceive batch (sync call) failed: %s", error->message);
+		g_error_free(error);
+
+		out_result = NET_NFC_IPC_FAIL;
+	}
+
+	transceive_batch_fill(out_result, out_responses, commands, count);
+
+	if (out_responses != NULL)
+		g_variant_unref(out_responses);
+
+	return out_result;
+}
+
 
 net_nfc_error_e net_nfc_client_transceive_init(void)
 {
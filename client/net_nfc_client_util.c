@@ -545,7 +545,7 @@ net_nfc_error_e net_nfc_app_util_process_ndef(data_s *data)
 	int ret = 0;
 	char mime[2048] = { 0, };
 	char text[2048] = { 0, };
-	ndef_message_s *msg = NULL;
+	ndef_message_s msg = { 0, };
 	char operation[2048] = { 0, };
 	net_nfc_error_e result = NET_NFC_UNKNOWN_ERROR;
 #ifdef USE_FULL_URI
@@ -571,20 +571,15 @@ net_nfc_error_e net_nfc_app_util_process_ndef(data_s *data)
 		return result;
 	}
 
-	if (net_nfc_util_create_ndef_message(&msg) != NET_NFC_OK)
-	{
-		NFC_ERR("memory alloc fail..");
-		return NET_NFC_ALLOC_FAIL;
-	}
-
-	/* parse ndef message and fill appsvc data */
-	if ((result = net_nfc_util_convert_rawdata_to_ndef_message(data, msg)) != NET_NFC_OK)
+	/* parse ndef message and fill appsvc data, records are only read here */
+	if ((result = net_nfc_util_convert_rawdata_to_ndef_message_view(data, &msg,
+					NULL, 0)) != NET_NFC_OK)
 	{
 		NFC_ERR("net_nfc_app_util_store_ndef_message failed [%d]", result);
 		goto ERROR;
 	}
 
-	if (_net_nfc_app_util_get_operation_from_record(msg->records, operation,
+	if (_net_nfc_app_util_get_operation_from_record(msg.records, operation,
 				sizeof(operation)) == FALSE)
 	{
 		NFC_ERR("_net_nfc_app_util_get_operation_from_record failed [%d]", result);
@@ -592,14 +587,14 @@ net_nfc_error_e net_nfc_app_util_process_ndef(data_s *data)
 		goto ERROR;
 	}
 
-	if (_net_nfc_app_util_get_mime_from_record(msg->records, mime, sizeof(mime)) == FALSE)
+	if (_net_nfc_app_util_get_mime_from_record(msg.records, mime, sizeof(mime)) == FALSE)
 	{
 		NFC_ERR("_net_nfc_app_util_get_mime_from_record failed [%d]", result);
 		result = NET_NFC_UNKNOWN_ERROR;
 		goto ERROR;
 	}
 #ifdef USE_FULL_URI
-	if (_net_nfc_app_util_get_uri_from_record(msg->records, uri, sizeof(uri)) == FALSE)
+	if (_net_nfc_app_util_get_uri_from_record(msg.records, uri, sizeof(uri)) == FALSE)
 	{
 		NFC_ERR("_net_nfc_app_util_get_uri_from_record failed [%d]", result);
 		result = NET_NFC_UNKNOWN_ERROR;
@@ -607,7 +602,7 @@ net_nfc_error_e net_nfc_app_util_process_ndef(data_s *data)
 	}
 #endif
 	/* launch appsvc */
-	if (_net_nfc_app_util_get_data_from_record(msg->records, text, sizeof(text)) == FALSE)
+	if (_net_nfc_app_util_get_data_from_record(msg.records, text, sizeof(text)) == FALSE)
 	{
 		NFC_ERR("_net_nfc_app_util_get_data_from_record failed [%d]", result);
 		result = NET_NFC_UNKNOWN_ERROR;
@@ -628,7 +623,7 @@ net_nfc_error_e net_nfc_app_util_process_ndef(data_s *data)
 	result = NET_NFC_OK;
 
 ERROR :
-	net_nfc_util_free_ndef_message(msg);
+	net_nfc_util_release_ndef_message_view(&msg);
 
 	return result;
 }
@@ -437,7 +437,7 @@ static void _read_completed_cb(GVariant *ret, void *user_data)
 	net_nfc_app_util_process_ndef(rawNDEF);
 	_create_target_info(rawNDEF);
 
-	if (net_nfc_util_create_ndef_message(&ndef) != NET_NFC_OK) {
+	if (net_nfc_util_create_pooled_ndef_message(&ndef) != NET_NFC_OK) {
 		NFC_DBG("ndef memory alloc fail..");
 		goto exit;
 	}
@@ -174,6 +174,24 @@ typedef bool (*net_nfc_oem_controller_test_mode_off)(net_nfc_error_e *result);
 typedef bool (*net_nfc_oem_controller_eedata_register_set)(
 		net_nfc_error_e *result , uint32_t mode , uint32_t reg_id , data_s *data);
 
+typedef enum
+{
+	/* calls on different target or secure element handles may run at
+	   the same time, from up to three threads. what the plugin must
+	   tolerate then :
+	   - calls that take a handle (connect, disconnect, check_presence,
+	     check_ndef, read/write/format ndef, transceive, the llcp socket
+	     calls and the secure element apdu calls) for two different
+	     handles at once. calls for one handle are issued in order, one
+	     at a time.
+	   - the listener callbacks while such calls run. they may come from
+	     any thread, a call must not block waiting for one of them.
+	   calls without a handle (init, deinit, configure_discovery,
+	   register_listener, get_secure_element_list, set_secure_element_mode
+	   and the rest) never overlap any other call. */
+	NET_NFC_OEM_CAPABILITY_REENTRANT_HANDLES = 0x01,
+} net_nfc_oem_capability_e;
+
 typedef struct _net_nfc_oem_interface_s
 {
 	net_nfc_oem_controller_init init;
@@ -230,6 +248,9 @@ typedef struct _net_nfc_oem_interface_s
 	net_nfc_oem_controller_secure_element_get_atr secure_element_get_atr;
 	net_nfc_oem_controller_secure_element_send_apdu secure_element_send_apdu;
 	net_nfc_oem_controller_secure_element_close secure_element_close;
+
+	/* net_nfc_oem_capability_e flags, left zero by older plugins */
+	uint32_t capabilities;
 } net_nfc_oem_interface_s;
 
 #endif //__NET_NFC_OEM_CONTROLLER_H__
@@ -409,6 +409,14 @@ typedef struct
 	uint32_t length;
 } data_s;
 
+/**
+  bump allocator used to carve a whole NDEF message out of one block
+  */
+typedef struct _net_nfc_util_arena_s net_nfc_util_arena_s;
+
+/* buffers of records made by net_nfc_util_share_record, see net_nfc_util_ndef_record.c */
+typedef struct _net_nfc_util_record_share_s net_nfc_util_record_share_s;
+
 /**
   ndef_record_s structure has the NDEF record data. it is only a record not a message
   */
@@ -420,10 +428,14 @@ typedef struct _ndef_record_s
 	uint8_t SR :1;
 	uint8_t IL :1;
 	uint8_t TNF :3;
+	uint8_t borrowed :1; /* type_s, id_s and payload_s point into a buffer the record does not own */
 	data_s type_s;
 	data_s id_s;
 	data_s payload_s;
 	struct _ndef_record_s *next;
+	net_nfc_util_arena_s *arena; /* the record and its buffers are carved from it if not NULL */
+	uint32_t encoded_length; /* cached by net_nfc_util_get_record_length, 0 if not known */
+	net_nfc_util_record_share_s *shared; /* buffers shared with other records, see net_nfc_util_share_record */
 }ndef_record_s;
 
 /**
@@ -433,6 +445,16 @@ typedef struct _ndef_message_s
 {
 	uint32_t recordCount;
 	ndef_record_s *records; // linked list
+	bool is_view; /* records are not allocated one by one, see net_nfc_util_convert_rawdata_to_ndef_message_view */
+	ndef_record_s *record_block; /* record nodes of a view, allocated at once */
+	net_nfc_util_arena_s *arena; /* records, fields and inner messages are carved from it if not NULL */
+	bool owns_arena; /* the message itself lives in arena and destroys it when freed */
+	ndef_record_s *tail; /* last record of the list */
+	GPtrArray *record_index; /* records by index, built on first indexed access */
+	GHashTable *type_lookup; /* records by (tnf, type), built on first search */
+	GHashTable *id_lookup; /* records by id, built on first search */
+	uint32_t lookup_stamp; /* record stamp when the lookup tables were built */
+	bool pooled; /* the message and its records go back to a pool when freed */
 } ndef_message_s;
 
 typedef struct _net_nfc_target_handle_s
@@ -133,6 +133,17 @@ net_nfc_error_e net_nfc_util_create_handover_request_message(
 net_nfc_error_e net_nfc_util_create_handover_select_message(
 		ndef_message_s **message);
 
+/*
+ same as above, but the message and its records are carved from an arena.
+ its records can not be freed or moved to another message on their own,
+ so these are for messages which never leave the daemon
+ */
+net_nfc_error_e net_nfc_util_create_handover_request_message_with_arena(
+		ndef_message_s **message);
+
+net_nfc_error_e net_nfc_util_create_handover_select_message_with_arena(
+		ndef_message_s **message);
+
 net_nfc_error_e net_nfc_util_create_handover_carrier_record(
 		ndef_record_s **record);
 net_nfc_error_e net_nfc_util_create_handover_error_record(
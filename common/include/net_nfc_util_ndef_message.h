@@ -17,6 +17,8 @@
 #ifndef __NET_NFC_UTIL_NDEF_MESSAGE_H__
 #define __NET_NFC_UTIL_NDEF_MESSAGE_H__
 
+#include <sys/uio.h>
+
 #include "net_nfc_typedef_internal.h"
 
 /**
@@ -55,11 +57,74 @@ net_nfc_error_e net_nfc_util_convert_rawdata_to_ndef_message(data_s *rawdata,
 		ndef_message_s *ndef);
 
 /*
- this util function converts into rawdata from ndef message structure
+ parse rawdata into a read-only view. type, id and payload of each record
+ point into rawdata, so rawdata must outlive the message.
+ if records is NULL, record nodes are allocated in one block, otherwise
+ up to max_records entries of the given array are used and nothing is allocated.
+ records of a view can not be appended or removed.
+ */
+net_nfc_error_e net_nfc_util_convert_rawdata_to_ndef_message_view(
+		data_s *rawdata, ndef_message_s *ndef, ndef_record_s *records,
+		uint32_t max_records);
+
+/*
+ release the resources of a view. rawdata and ndef itself are not freed
+ */
+void net_nfc_util_release_ndef_message_view(ndef_message_s *ndef);
+
+/*
+ incremental parser for a message which arrives in fragments.
+ chunked records are reassembled, and each record is handed to callback
+ as soon as its last byte is fed. callback takes the ownership of the record
+ and frees it with net_nfc_util_free_record or appends it to a message.
+ if callback is NULL, records are only checked and freed
+ */
+typedef struct _net_nfc_util_ndef_parser_s net_nfc_util_ndef_parser_s;
+
+typedef void (*net_nfc_util_ndef_parser_cb)(ndef_record_s *record,
+		void *user_data);
+
+net_nfc_util_ndef_parser_s *net_nfc_util_ndef_parser_create(
+		net_nfc_util_ndef_parser_cb callback, void *user_data);
+
+/*
+ feed next fragment. once it fails, the parser keeps returning the same error
+ */
+net_nfc_error_e net_nfc_util_ndef_parser_feed(net_nfc_util_ndef_parser_s *parser,
+		const uint8_t *data, uint32_t length);
+
+/*
+ true if the record with ME flag is complete
+ */
+bool net_nfc_util_ndef_parser_is_complete(net_nfc_util_ndef_parser_s *parser);
+
+void net_nfc_util_ndef_parser_destroy(net_nfc_util_ndef_parser_s *parser);
+
+/*
+ this util function converts into rawdata from ndef message structure.
+ rawdata->length must be at least net_nfc_util_get_ndef_message_length
  */
 net_nfc_error_e net_nfc_util_convert_ndef_message_to_rawdata(
 		ndef_message_s *ndef, data_s *rawdata);
 
+/*
+ allocate rawdata and convert ndef message into it in one pass.
+ the message starts after headroom bytes, which are left zero filled for the
+ caller. free rawdata with net_nfc_util_free_data
+ */
+net_nfc_error_e net_nfc_util_serialize_ndef_message(ndef_message_s *ndef,
+		uint32_t headroom, data_s *rawdata);
+
+/*
+ describe the serial form of ndef message as iov entries without copying
+ payloads. record headers, types and ids are packed into headers, which must be
+ freed with net_nfc_util_free_data after the iov is consumed.
+ *iov_count is the number of iov entries on input and at least twice the
+ record count is needed, on output it is the number of entries used
+ */
+net_nfc_error_e net_nfc_util_convert_ndef_message_to_iovec(ndef_message_s *ndef,
+		data_s *headers, struct iovec *iov, uint32_t *iov_count);
+
 /*
  get total bytes of ndef message in serial form
  */
@@ -83,6 +148,45 @@ void net_nfc_util_print_ndef_message(ndef_message_s *msg);
 
 net_nfc_error_e net_nfc_util_create_ndef_message(ndef_message_s **ndef_message);
 
+/*
+ create ndef message carved from its own arena. records created with
+ net_nfc_util_create_record_with_arena(msg->arena, ...) and parsed into it share
+ the arena, and net_nfc_util_free_ndef_message releases all of them at once
+ */
+net_nfc_error_e net_nfc_util_create_ndef_message_with_arena(
+		ndef_message_s **ndef_message, uint32_t arena_size);
+
+/*
+ create ndef message from the pool of the calling thread. when it is freed,
+ the message and its records are reset and kept for reuse by the freeing
+ thread, up to a bound. use it on paths which parse and free at a high rate
+ */
+net_nfc_error_e net_nfc_util_create_pooled_ndef_message(
+		ndef_message_s **ndef_message);
+
+typedef struct _net_nfc_util_ndef_pool_stats_s
+{
+	uint32_t hits; /* objects taken from a pool */
+	uint32_t misses; /* objects allocated because a pool was empty */
+	uint32_t high_water; /* most objects a pool has held at once */
+} net_nfc_util_ndef_pool_stats_s;
+
+/*
+ counters of all pools, for sizing them
+ */
+void net_nfc_util_get_ndef_pool_stats(net_nfc_util_ndef_pool_stats_s *stats);
+
+/*
+ create ndef message in the arena of parent. it is released with parent.
+ if parent has no arena, this is same with net_nfc_util_create_ndef_message
+ */
+net_nfc_error_e net_nfc_util_create_inner_ndef_message(
+		ndef_message_s *parent, ndef_message_s **ndef_message);
+
+/*
+ find the first record of the given type. messages with many records keep a
+ lookup table which is built on the first search and dropped on mutation
+ */
 net_nfc_error_e net_nfc_util_search_record_by_type(ndef_message_s *ndef_message,
 		net_nfc_record_tnf_e tnf, data_s *type, ndef_record_s **record);
 
@@ -95,6 +199,9 @@ net_nfc_error_e net_nfc_util_get_record_by_index(ndef_message_s *ndef_message,
 net_nfc_error_e net_nfc_util_remove_record_by_index(
 		ndef_message_s *ndef_message, int index);
 
+/*
+ find the first record with the given id. see net_nfc_util_search_record_by_type
+ */
 net_nfc_error_e net_nfc_util_search_record_by_id(ndef_message_s *ndef_message,
 		data_s *id, ndef_record_s **record);
 
@@ -26,6 +26,34 @@ net_nfc_error_e net_nfc_util_create_record(net_nfc_record_tnf_e recordType,
 		const data_s *typeName, const data_s *id, const data_s *payload,
 		ndef_record_s **record);
 
+/*
+ create record structure whose node and buffers are carved from arena.
+ it is released with the arena, net_nfc_util_free_record does nothing for it.
+ if arena is NULL, this is same with net_nfc_util_create_record
+ */
+net_nfc_error_e net_nfc_util_create_record_with_arena(net_nfc_util_arena_s *arena,
+		net_nfc_record_tnf_e recordType, const data_s *typeName, const data_s *id,
+		const data_s *payload, ndef_record_s **record);
+
+/*
+ create a record with the type, id and payload of src without copying them.
+ the buffers are reference counted and copied on write, see
+ net_nfc_util_unshare_record. arena and borrowed records are copied
+ */
+net_nfc_error_e net_nfc_util_share_record(ndef_record_s *src,
+		ndef_record_s **record);
+
+/*
+ give record its own copy of the buffers it shares with other records.
+ call this before writing into type, id or payload of a record in place
+ */
+net_nfc_error_e net_nfc_util_unshare_record(ndef_record_s *record);
+
+/*
+ free type, id and payload of record, but not record itself
+ */
+void net_nfc_util_release_record_buffers(ndef_record_s *record);
+
 /*
  create text type record
  */
@@ -33,7 +61,8 @@ net_nfc_error_e net_nfc_util_create_text_type_record(const char *text,
 		const char *lang_code_str, net_nfc_encode_type_e encode, ndef_record_s **record);
 
 /*
- this utility function help to create uri type record
+ this utility function help to create uri type record.
+ with NET_NFC_SCHEMA_FULL_URI, the longest known prefix of uri is abbreviated
  */
 net_nfc_error_e net_nfc_util_create_uri_type_record(const char *uri,
 		net_nfc_schema_type_e protocol_schema, ndef_record_s **record);
@@ -50,10 +79,25 @@ net_nfc_error_e net_nfc_util_set_record_id(ndef_record_s *record, uint8_t *data,
 		int length);
 
 /*
- get total bytes of ndef record in serial form
+ get a counter which changes whenever net_nfc_util_set_record_id or
+ net_nfc_util_unshare_record replaces the buffers of a record
+ */
+uint32_t net_nfc_util_get_record_stamp(void);
+
+/*
+ get total bytes of ndef record in serial form. the value is cached in
+ the record, reset encoded_length to 0 after changing its fields directly
  */
 uint32_t net_nfc_util_get_record_length(ndef_record_s *record);
 
+/*
+ write the uri of record into buffer, terminated by NUL.
+ length is the size of buffer, it is set to the size needed. if buffer is NULL
+ or too small, NET_NFC_BUFFER_TOO_SMALL is returned
+ */
+net_nfc_error_e net_nfc_util_get_uri_string_from_uri_record(
+		ndef_record_s *record, char *buffer, uint32_t *length);
+
 /*
  create uri string from record
  */
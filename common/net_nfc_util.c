@@ -15,6 +15,7 @@
  */
 
 // libc header
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include <pthread.h>
@@ -71,6 +72,21 @@ static const char *schema[] =
 	"urn:epc:nfc:",
 };
 
+/* prefix trie over schema[], built once on first use. children of a node
+   are linked by sibling, index 0 is the root and means none otherwise */
+typedef struct _net_nfc_util_schema_node_s
+{
+	char c;
+	uint8_t schema; /* NET_NFC_SCHEMA_FULL_URI if no prefix ends here */
+	uint16_t child;
+	uint16_t sibling;
+} net_nfc_util_schema_node_s;
+
+#define NET_NFC_UTIL_SCHEMA_NODE_MAX	256
+
+static net_nfc_util_schema_node_s schema_nodes[NET_NFC_UTIL_SCHEMA_NODE_MAX];
+static gsize schema_trie_ready;
+
 static uint8_t *bt_addr = NULL;
 
 /* for log tag */
@@ -176,6 +192,102 @@ API void net_nfc_util_free_data(data_s *data)
 	data->length = 0;
 }
 
+typedef struct _net_nfc_util_arena_block_s
+{
+	struct _net_nfc_util_arena_block_s *next;
+	uint32_t size;
+	uint32_t used;
+	uint8_t data[0];
+} net_nfc_util_arena_block_s;
+
+struct _net_nfc_util_arena_s
+{
+	net_nfc_util_arena_block_s *current;
+	uint32_t block_size;
+	net_nfc_util_arena_block_s first;
+};
+
+#define NET_NFC_UTIL_ARENA_ALIGN(size) \
+	(((size) + (2 * sizeof(void *) - 1)) & ~(2 * sizeof(void *) - 1))
+
+/* larger sizes wrap while being aligned or added to the block header */
+#define NET_NFC_UTIL_ARENA_MAX_SIZE \
+	(G_MAXINT - sizeof(net_nfc_util_arena_s) - 2 * sizeof(void *))
+
+API net_nfc_util_arena_s *net_nfc_util_arena_create(uint32_t block_size)
+{
+	net_nfc_util_arena_s *arena = NULL;
+
+	if (0 == block_size)
+		block_size = NET_NFC_UTIL_ARENA_DEFAULT_SIZE;
+
+	RETV_IF(block_size > NET_NFC_UTIL_ARENA_MAX_SIZE, NULL);
+
+	block_size = NET_NFC_UTIL_ARENA_ALIGN(block_size);
+
+	/* first block shares the allocation with the arena header */
+	_net_nfc_util_alloc_mem(arena, sizeof(net_nfc_util_arena_s) + block_size);
+	if (NULL == arena)
+		return NULL;
+
+	arena->block_size = block_size;
+	arena->first.size = block_size;
+	arena->current = &arena->first;
+
+	return arena;
+}
+
+API void *net_nfc_util_arena_alloc(net_nfc_util_arena_s *arena, uint32_t size)
+{
+	void *mem;
+	net_nfc_util_arena_block_s *block;
+
+	RETV_IF(NULL == arena, NULL);
+	RETV_IF(0 == size, NULL);
+	RETV_IF(size > NET_NFC_UTIL_ARENA_MAX_SIZE, NULL);
+
+	size = NET_NFC_UTIL_ARENA_ALIGN(size);
+	block = arena->current;
+
+	if (block->size - block->used < size)
+	{
+		uint32_t block_size = MAX(size, arena->block_size);
+
+		block = NULL;
+		_net_nfc_util_alloc_mem(block, sizeof(net_nfc_util_arena_block_s) + block_size);
+		if (NULL == block)
+			return NULL;
+
+		block->size = block_size;
+		block->next = arena->current;
+		arena->current = block;
+	}
+
+	mem = block->data + block->used;
+	block->used += size;
+
+	return mem;
+}
+
+API void net_nfc_util_arena_destroy(net_nfc_util_arena_s *arena)
+{
+	net_nfc_util_arena_block_s *block;
+
+	RET_IF(NULL == arena);
+
+	block = arena->current;
+
+	while (block != &arena->first)
+	{
+		net_nfc_util_arena_block_s *next = block->next;
+
+		_net_nfc_util_free_mem(block);
+		block = next;
+	}
+
+	_net_nfc_util_free_mem(arena);
+}
+
 net_nfc_conn_handover_carrier_state_e net_nfc_util_get_cps(
 		net_nfc_conn_handover_carrier_type_e carrier_type)
 {
@@ -365,6 +477,334 @@ void net_nfc_util_compute_CRC(CRC_type_e CRC_type, uint8_t *buffer,
 	temp[length - 1] = (uint8_t)((wCrc >> 8) & 0xFF);
 }
 
+net_nfc_event_filter_e net_nfc_util_get_event_filter(net_nfc_target_type_e type)
+{
+	net_nfc_event_filter_e converted = NET_NFC_ALL_ENABLE;
+
+	if (type >= NET_NFC_ISO14443_A_PICC
+			&& type <= NET_NFC_MIFARE_DESFIRE_PICC)
+	{
+		converted = NET_NFC_ISO14443A_ENABLE;
+	}
+	else if (type >= NET_NFC_ISO14443_B_PICC
+			&& type <= NET_NFC_ISO14443_BPRIME_PICC)
+	{
+		converted = NET_NFC_ISO14443B_ENABLE;
+	}
+	else if (type == NET_NFC_FELICA_PICC)
+	{
+		converted = NET_NFC_FELICA_ENABLE;
+	}
+	else if (type == NET_NFC_JEWEL_PICC)
+	{
+		converted = NET_NFC_FELICA_ENABLE;
+	}
+	else if (type == NET_NFC_ISO15693_PICC)
+	{
+		converted = NET_NFC_ISO15693_ENABLE;
+	}
+	else if (type == NET_NFC_NFCIP1_TARGET || type == NET_NFC_NFCIP1_INITIATOR)
+	{
+		converted = NET_NFC_IP_ENABLE;
+	}
+
+	return converted;
+}
+
+/* well-known keys, encoded as their index. 0 is a key spelled out */
+static const char *tag_info_keys[NET_NFC_TAG_INFO_KEY_MAX] =
+{
+	NULL,
+	"UID",
+	"ATQA",
+	"SAK",
+	"APP_DATA",
+	"PROTOCOL_INFO",
+	"HIST_BYTES",
+	"FWI_SFGT",
+	"DSFID",
+	"AFI",
+	"IDm",
+	"PMm",
+	"SYSTEM_CODE",
+	"HEADER_ROM0",
+	"HEADER_ROM1",
+};
+
+typedef struct _net_nfc_util_tag_info_block_s
+{
+	/* position + 1 in list of each well-known key, 0 if absent */
+	uint8_t index[NET_NFC_TAG_INFO_KEY_MAX];
+	net_nfc_tag_info_s list[0];
+} net_nfc_util_tag_info_block_s;
+
+typedef struct _net_nfc_util_tag_info_entry_s
+{
+	uint8_t id;
+	uint8_t key_length;
+	uint8_t value_length;
+	const char *key;
+	const uint8_t *value;
+} net_nfc_util_tag_info_entry_s;
+
+static uint8_t _net_nfc_util_get_tag_info_key_id(const char *key,
+		uint32_t length)
+{
+	uint8_t i;
+
+	for (i = 1; i < NET_NFC_TAG_INFO_KEY_MAX; i++)
+	{
+		if (strlen(tag_info_keys[i]) == length
+				&& memcmp(tag_info_keys[i], key, length) == 0)
+			return i;
+	}
+
+	return 0;
+}
+
+static net_nfc_util_tag_info_block_s *_net_nfc_util_get_tag_info_block(
+		const net_nfc_tag_info_s *list)
+{
+	return (net_nfc_util_tag_info_block_s *)((uint8_t *)list -
+			offsetof(net_nfc_util_tag_info_block_s, list));
+}
+
+/* lays the list, its values and its bytes out in one allocation */
+static net_nfc_tag_info_s *_net_nfc_util_pack_tag_info(
+		const net_nfc_util_tag_info_entry_s *entries, int count)
+{
+	int i;
+	size_t size;
+	uint8_t *pos;
+	data_s *values;
+	net_nfc_util_tag_info_block_s *block = NULL;
+
+	size = sizeof(*block) + count * (sizeof(net_nfc_tag_info_s) + sizeof(data_s));
+	for (i = 0; i < count; i++)
+	{
+		if (0 == entries[i].id)
+			size += entries[i].key_length + 1;
+
+		size += entries[i].value_length;
+	}
+
+	_net_nfc_util_alloc_mem(block, size);
+	if (NULL == block)
+		return NULL;
+
+	values = (data_s *)(block->list + count);
+	pos = (uint8_t *)(values + count);
+
+	for (i = 0; i < count; i++)
+	{
+		if (entries[i].id > 0)
+		{
+			block->list[i].key = (char *)tag_info_keys[entries[i].id];
+
+			/* the first of duplicated keys wins, as with a linear search */
+			if (0 == block->index[entries[i].id])
+				block->index[entries[i].id] = i + 1;
+		}
+		else
+		{
+			memcpy(pos, entries[i].key, entries[i].key_length);
+			block->list[i].key = (char *)pos;
+			pos += entries[i].key_length + 1;
+		}
+
+		if (entries[i].value_length > 0)
+		{
+			memcpy(pos, entries[i].value, entries[i].value_length);
+			values[i].buffer = pos;
+			values[i].length = entries[i].value_length;
+			block->list[i].value = &values[i];
+			pos += entries[i].value_length;
+		}
+	}
+
+	return block->list;
+}
+
+uint32_t net_nfc_util_encode_tag_info(const data_s *legacy, int number_of_keys,
+		uint8_t *buffer, uint32_t length)
+{
+	int i;
+	uint8_t id;
+	uint32_t in = 0;
+	uint32_t out = 2;
+	uint8_t key_length, value_length;
+
+	RETV_IF(NULL == legacy, 0);
+	RETV_IF(NULL == buffer, 0);
+	RETV_IF(number_of_keys < 0 || number_of_keys > UINT8_MAX, 0);
+	RETV_IF(length < NET_NFC_TAG_INFO_ENCODED_MAX(legacy->length, number_of_keys), 0);
+
+	buffer[0] = NET_NFC_TAG_INFO_VERSION;
+	buffer[1] = number_of_keys;
+
+	for (i = 0; i < number_of_keys; i++)
+	{
+		if (in >= legacy->length)
+			return 0;
+
+		key_length = legacy->buffer[in++];
+		if (legacy->length - in < key_length + 1)
+			return 0;
+
+		id = _net_nfc_util_get_tag_info_key_id(
+				(const char *)legacy->buffer + in, key_length);
+
+		buffer[out++] = id;
+		if (0 == id)
+		{
+			buffer[out++] = key_length;
+			memcpy(buffer + out, legacy->buffer + in, key_length);
+			out += key_length;
+		}
+		in += key_length;
+
+		value_length = legacy->buffer[in++];
+		if (legacy->length - in < value_length)
+			return 0;
+
+		buffer[out++] = value_length;
+		memcpy(buffer + out, legacy->buffer + in, value_length);
+		out += value_length;
+		in += value_length;
+	}
+
+	return out;
+}
+
+net_nfc_tag_info_s *net_nfc_util_decode_tag_info(const uint8_t *buffer,
+		uint32_t length, int *number_of_keys)
+{
+	int i, count;
+	uint32_t pos = 2;
+	net_nfc_tag_info_s *list;
+	net_nfc_util_tag_info_entry_s entries[UINT8_MAX];
+
+	RETV_IF(NULL == number_of_keys, NULL);
+
+	*number_of_keys = 0;
+
+	RETV_IF(NULL == buffer, NULL);
+	RETV_IF(length < 2, NULL);
+
+	if (buffer[0] != NET_NFC_TAG_INFO_VERSION)
+	{
+		NFC_ERR("unknown tag info version [%d]", buffer[0]);
+		return NULL;
+	}
+
+	count = buffer[1];
+
+	for (i = 0; i < count; i++)
+	{
+		if (pos >= length)
+			return NULL;
+
+		entries[i].id = buffer[pos++];
+		if (entries[i].id >= NET_NFC_TAG_INFO_KEY_MAX)
+			return NULL;
+
+		if (0 == entries[i].id)
+		{
+			if (pos >= length)
+				return NULL;
+
+			entries[i].key_length = buffer[pos++];
+			if (length - pos < entries[i].key_length)
+				return NULL;
+
+			entries[i].key = (const char *)buffer + pos;
+			pos += entries[i].key_length;
+		}
+
+		if (pos >= length)
+			return NULL;
+
+		entries[i].value_length = buffer[pos++];
+		if (length - pos < entries[i].value_length)
+			return NULL;
+
+		entries[i].value = buffer + pos;
+		pos += entries[i].value_length;
+	}
+
+	list = _net_nfc_util_pack_tag_info(entries, count);
+	if (list != NULL)
+		*number_of_keys = count;
+
+	return list;
+}
+
+net_nfc_tag_info_s *net_nfc_util_duplicate_tag_info(
+		const net_nfc_tag_info_s *list, int number_of_keys)
+{
+	int i;
+	net_nfc_util_tag_info_entry_s entries[UINT8_MAX];
+
+	RETV_IF(NULL == list, NULL);
+	RETV_IF(number_of_keys <= 0 || number_of_keys > UINT8_MAX, NULL);
+
+	for (i = 0; i < number_of_keys; i++)
+	{
+		entries[i].key = list[i].key;
+		entries[i].key_length = (list[i].key != NULL) ? strlen(list[i].key) : 0;
+		entries[i].id = _net_nfc_util_get_tag_info_key_id(entries[i].key,
+				entries[i].key_length);
+		entries[i].value = NULL;
+		entries[i].value_length = 0;
+
+		if (list[i].value != NULL)
+		{
+			entries[i].value = list[i].value->buffer;
+			entries[i].value_length = list[i].value->length;
+		}
+	}
+
+	return _net_nfc_util_pack_tag_info(entries, number_of_keys);
+}
+
+net_nfc_tag_info_s *net_nfc_util_find_tag_info(net_nfc_tag_info_s *list,
+		int number_of_keys, const char *key)
+{
+	int i;
+	uint8_t id;
+	net_nfc_util_tag_info_block_s *block;
+
+	RETV_IF(NULL == list, NULL);
+	RETV_IF(NULL == key, NULL);
+
+	id = _net_nfc_util_get_tag_info_key_id(key, strlen(key));
+	if (id > 0)
+	{
+		block = _net_nfc_util_get_tag_info_block(list);
+
+		return (block->index[id] > 0) ? &list[block->index[id] - 1] : NULL;
+	}
+
+	for (i = 0; i < number_of_keys; i++)
+	{
+		if (list[i].key != NULL && strcmp(key, list[i].key) == 0)
+			return &list[i];
+	}
+
+	return NULL;
+}
+
+void net_nfc_util_free_tag_info(net_nfc_tag_info_s *list)
+{
+	net_nfc_util_tag_info_block_s *block;
+
+	RET_IF(NULL == list);
+
+	block = _net_nfc_util_get_tag_info_block(list);
+
+	_net_nfc_util_free_mem(block);
+}
+
 const char *net_nfc_util_get_schema_string(int index)
 {
 	RETV_IF(0 == index, NULL);
@@ -373,3 +813,84 @@ const char *net_nfc_util_get_schema_string(int index)
 	return schema[index];
 }
 
+static void __net_nfc_util_build_schema_trie(void)
+{
+	uint16_t count = 1;
+	uint16_t node;
+	uint16_t child;
+	const char *c;
+	int i;
+
+	for (i = NET_NFC_SCHEMA_FULL_URI + 1; i < NET_NFC_SCHEMA_MAX; i++)
+	{
+		node = 0;
+
+		for (c = schema[i]; *c != '\0'; c++)
+		{
+			child = schema_nodes[node].child;
+
+			while (child != 0 && schema_nodes[child].c != *c)
+				child = schema_nodes[child].sibling;
+
+			if (0 == child)
+			{
+				if (count >= NET_NFC_UTIL_SCHEMA_NODE_MAX)
+				{
+					NFC_ERR("schema trie is full");
+					return;
+				}
+
+				child = count++;
+				schema_nodes[child].c = *c;
+				schema_nodes[child].sibling = schema_nodes[node].child;
+				schema_nodes[node].child = child;
+			}
+
+			node = child;
+		}
+
+		schema_nodes[node].schema = i;
+	}
+}
+
+net_nfc_schema_type_e net_nfc_util_get_schema_type(const char *uri,
+		uint32_t *prefix_length)
+{
+	net_nfc_schema_type_e type = NET_NFC_SCHEMA_FULL_URI;
+	uint32_t length = 0;
+	uint16_t node = 0;
+	uint16_t child;
+	uint32_t i;
+
+	if (g_once_init_enter(&schema_trie_ready))
+	{
+		__net_nfc_util_build_schema_trie();
+		g_once_init_leave(&schema_trie_ready, 1);
+	}
+
+	/* one pass over uri, the last prefix seen is the longest */
+	for (i = 0; uri != NULL && uri[i] != '\0'; i++)
+	{
+		child = schema_nodes[node].child;
+
+		while (child != 0 && schema_nodes[child].c != uri[i])
+			child = schema_nodes[child].sibling;
+
+		if (0 == child)
+			break;
+
+		node = child;
+
+		if (schema_nodes[node].schema != NET_NFC_SCHEMA_FULL_URI)
+		{
+			type = schema_nodes[node].schema;
+			length = i + 1;
+		}
+	}
+
+	if (prefix_length != NULL)
+		*prefix_length = length;
+
+	return type;
+}
+
@@ -15,6 +15,10 @@
  */
 
 // libc header
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/syscall.h>
 
 // platform header
 
@@ -24,137 +28,114 @@
 #include "net_nfc_util_gdbus_internal.h"
 #include "net_nfc_util_ndef_message.h"
 
-void net_nfc_util_gdbus_variant_to_buffer(GVariant *variant, uint8_t **buffer,
-		size_t *length)
+/* memfd and sealing, for libc headers older than the kernel feature */
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC		0x0001U
+#define MFD_ALLOW_SEALING	0x0002U
+#endif
+
+#ifndef F_ADD_SEALS
+#define F_ADD_SEALS		(1024 + 9)
+#define F_GET_SEALS		(1024 + 10)
+#define F_SEAL_SEAL		0x0001
+#define F_SEAL_SHRINK		0x0002
+#define F_SEAL_GROW		0x0004
+#define F_SEAL_WRITE		0x0008
+#endif
+
+/* a peer can neither change nor truncate the pages we map, so the
+   mapping never faults and the content is fixed once checked */
+#define NET_NFC_UTIL_GDBUS_FD_SEALS \
+	(F_SEAL_SEAL | F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE)
+
+/* buffers cross the bus as "ay", the returned bytes point into variant */
+static const guint8 *__net_nfc_util_gdbus_get_bytes(GVariant *variant,
+		gsize *length)
 {
-	guint size = 0;
-	GVariantIter *iter;
-	guint8 *buf = NULL;
+	*length = 0;
 
-	RET_IF(NULL == variant);
+	if (g_variant_is_of_type(variant, G_VARIANT_TYPE_BYTESTRING) == FALSE)
+	{
+		NFC_ERR("unexpected type [%s]", g_variant_get_type_string(variant));
+		return NULL;
+	}
 
-	g_variant_get(variant, "a(y)", &iter);
+	return g_variant_get_fixed_array(variant, length, sizeof(guint8));
+}
 
-	size = g_variant_iter_n_children(iter);
-	buf  = g_new0(guint8, size);
+/* buffer of the caller's own, 0 bytes gives a NULL buffer */
+static guint8 *__net_nfc_util_gdbus_dup_bytes(GVariant *variant, gsize *length)
+{
+	const guint8 *bytes;
 
-	if (buf != NULL)
-	{
-		guint i;
-		guint8 element;
+	bytes = __net_nfc_util_gdbus_get_bytes(variant, length);
+	if (NULL == bytes || 0 == *length)
+		return NULL;
 
-		i = 0;
-		while (g_variant_iter_loop(iter, "(y)", &element))
-		{
-			*(buf + i) = element;
-			i++;
-		}
+	return g_memdup(bytes, *length);
+}
+
+void net_nfc_util_gdbus_variant_to_buffer(GVariant *variant, uint8_t **buffer,
+		size_t *length)
+{
+	gsize size = 0;
+	guint8 *buf;
 
-		g_variant_iter_free(iter);
+	RET_IF(NULL == variant);
 
-		if (length)
-			*length = size;
+	buf = __net_nfc_util_gdbus_dup_bytes(variant, &size);
 
-		if (buffer)
-			*buffer = buf;
-		else
-			g_free(buf);
-	}
+	if (length)
+		*length = size;
+
+	if (buffer)
+		*buffer = buf;
+	else
+		g_free(buf);
 }
 
 data_s *net_nfc_util_gdbus_variant_to_data(GVariant *variant)
 {
-	guint size = 0;
-	GVariantIter *iter;
-	guint8 *buf = NULL;
+	gsize size = 0;
+	guint8 *buf;
 	data_s *result = NULL;
 
 	RETV_IF(NULL == variant, result);
 
-	g_variant_get(variant, "a(y)", &iter);
-
-	size = g_variant_iter_n_children(iter);
-	buf  = g_new0(guint8, size);
-	if (buf != NULL)
-	{
-		guint i;
-		guint8 element;
-
-		i = 0;
-		while (g_variant_iter_loop(iter, "(y)", &element))
-		{
-			*(buf + i) = element;
-			i++;
-		}
+	/* an empty buffer gives no data */
+	buf = __net_nfc_util_gdbus_dup_bytes(variant, &size);
+	if (NULL == buf)
+		return NULL;
 
-		g_variant_iter_free(iter);
-
-		result = g_new0(data_s, 1);
-		if (result != NULL)
-		{
-			result->buffer = buf;
-			result->length = size;
-		}
-		else
-		{
-			g_free(buf);
-		}
-	}
+	result = g_new0(data_s, 1);
+	result->buffer = buf;
+	result->length = size;
 
 	return result;
 }
 
 void net_nfc_util_gdbus_variant_to_data_s(GVariant *variant, data_s *data)
 {
-	guint size = 0;
-	guint8 element;
-	GVariantIter *iter;
-	guint8 *buf = NULL;
+	gsize size = 0;
 
 	RET_IF(NULL == data);
 	RET_IF(NULL == variant);
 
-	data->buffer = NULL;
-	data->length = 0;
-
-	g_variant_get(variant, "a(y)", &iter);
-
-	size = g_variant_iter_n_children(iter);
-	buf  = g_new0(guint8, size);
-
-	if (buf != NULL)
-	{
-		guint i = 0;
-
-		while (g_variant_iter_loop(iter, "(y)", &element))
-		{
-			*(buf + i) = element;
-			i++;
-		}
-
-		g_variant_iter_free(iter);
-
-		data->length = size;
-		data->buffer = buf;
-	}
+	data->buffer = __net_nfc_util_gdbus_dup_bytes(variant, &size);
+	data->length = (data->buffer != NULL) ? size : 0;
 }
 
 GVariant *net_nfc_util_gdbus_buffer_to_variant(const uint8_t *buffer,
 		size_t length)
 {
-	GVariantBuilder builder;
-
-	g_variant_builder_init(&builder, G_VARIANT_TYPE("a(y)"));
-
-	if (buffer && length > 0)
-	{
-		int i;
+	static const guint8 empty[1];
 
-		for(i = 0; i < length; i++)
-			g_variant_builder_add(&builder, "(y)", *(buffer + i));
-	}
+	if (NULL == buffer || 0 == length)
+		return g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, empty, 0,
+				sizeof(guint8));
 
-	return g_variant_builder_end(&builder);
+	return g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, buffer, length,
+			sizeof(guint8));
 }
 
 GVariant *net_nfc_util_gdbus_data_to_variant(const data_s *data)
@@ -165,22 +146,40 @@ GVariant *net_nfc_util_gdbus_data_to_variant(const data_s *data)
 		return net_nfc_util_gdbus_buffer_to_variant(NULL, 0);
 }
 
-ndef_message_s *net_nfc_util_gdbus_variant_to_ndef_message(GVariant *variant)
+GVariant *net_nfc_util_gdbus_data_take_to_variant(data_s *data)
 {
-	data_s data = { NULL, 0 };
-	ndef_message_s *temp = NULL;
-	ndef_message_s *message = NULL;
+	GBytes *bytes;
+	GVariant *variant;
 
-	RETV_IF(NULL == variant, NULL);
+	if (NULL == data || NULL == data->buffer || 0 == data->length)
+	{
+		if (data != NULL)
+			net_nfc_util_free_data(data);
 
-	net_nfc_util_gdbus_variant_to_data_s(variant, &data);
+		return net_nfc_util_gdbus_buffer_to_variant(NULL, 0);
+	}
 
-	if (NULL == data.buffer || data.length <= 0)
+	bytes = g_bytes_new_take(data->buffer, data->length);
+	variant = g_variant_new_from_bytes(G_VARIANT_TYPE_BYTESTRING, bytes, TRUE);
+	g_bytes_unref(bytes);
+
+	data->buffer = NULL;
+	data->length = 0;
+
+	return variant;
+}
+
+static ndef_message_s *__net_nfc_util_gdbus_parse_ndef_message(data_s *data)
+{
+	ndef_message_s *temp = NULL;
+	ndef_message_s *message = NULL;
+
+	if (NULL == data->buffer || data->length <= 0)
 		return NULL;
 
-	if (net_nfc_util_create_ndef_message(&temp) == NET_NFC_OK)
+	if (net_nfc_util_create_pooled_ndef_message(&temp) == NET_NFC_OK)
 	{
-		if (net_nfc_util_convert_rawdata_to_ndef_message(&data, temp) == NET_NFC_OK)
+		if (net_nfc_util_convert_rawdata_to_ndef_message(data, temp) == NET_NFC_OK)
 		{
 			message = temp;
 		}
@@ -196,54 +195,197 @@ ndef_message_s *net_nfc_util_gdbus_variant_to_ndef_message(GVariant *variant)
 		NFC_ERR("net_nfc_util_create_ndef_message failed");
 	}
 
-	net_nfc_util_free_data(&data);
+	return message;
+}
+
+ndef_message_s *net_nfc_util_gdbus_variant_to_ndef_message(GVariant *variant)
+{
+	data_s data = { NULL, 0 };
+	ndef_message_s *message;
+	gsize length;
+
+	RETV_IF(NULL == variant, NULL);
+
+	/* records copy what they need, so the bytes are parsed in place */
+	data.buffer = (uint8_t *)__net_nfc_util_gdbus_get_bytes(variant, &length);
+	data.length = length;
+
+	message = __net_nfc_util_gdbus_parse_ndef_message(&data);
 
 	return message;
 }
 
+ndef_message_s *net_nfc_util_gdbus_fd_list_to_ndef_message(
+		GUnixFDList *fd_list, gint32 index)
+{
+	data_s data = { NULL, 0 };
+	ndef_message_s *message;
+	GMappedFile *mapped;
+
+	mapped = net_nfc_util_gdbus_fd_list_to_data_s(fd_list, index, &data);
+	if (NULL == mapped)
+		return NULL;
+
+	/* parsed straight from the mapping, like the variant above */
+	message = __net_nfc_util_gdbus_parse_ndef_message(&data);
+
+	net_nfc_util_gdbus_release_data_s(&data, mapped);
+
+	return message;
+}
 
 GVariant *net_nfc_util_gdbus_ndef_message_to_variant(
 		const ndef_message_s *message)
 {
-	size_t length;
 	net_nfc_error_e ret;
-	data_s *data = NULL;
-	GVariant *variant = NULL;
+	data_s temp = { NULL, 0 };
+
+	ret = net_nfc_util_serialize_ndef_message((ndef_message_s *)message, 0, &temp);
+	if (ret != NET_NFC_OK)
+		NFC_ERR("can not convert ndef_message to rawdata [%d]", ret);
 
-	length = net_nfc_util_get_ndef_message_length((ndef_message_s *)message);
-	if (length > 0)
+	/* the variant keeps the serialized buffer instead of a copy */
+	return net_nfc_util_gdbus_data_take_to_variant(&temp);
+}
+
+static int __net_nfc_util_gdbus_create_memfd(const data_s *data)
+{
+	size_t offset = 0;
+	ssize_t written;
+	int fd;
+
+#ifdef __NR_memfd_create
+	fd = syscall(__NR_memfd_create, "nfc-data",
+			MFD_CLOEXEC | MFD_ALLOW_SEALING);
+#else
+	fd = -1;
+	errno = ENOSYS;
+#endif
+	if (fd < 0)
 	{
-		data_s temp = { NULL, 0 };
+		NFC_DBG("memfd_create failed [%d]", errno);
+		return -1;
+	}
 
-		if (net_nfc_util_alloc_data(&temp, length) == true)
-		{
-			ret = net_nfc_util_convert_ndef_message_to_rawdata((ndef_message_s *)message,
-						&temp);
-			if (NET_NFC_OK == ret)
-			{
-				data = &temp;
-			}
-			else
-			{
-				NFC_ERR("can not convert ndef_message to rawdata");
-
-				net_nfc_util_free_data(&temp);
-			}
-		}
-		else
+	while (offset < data->length)
+	{
+		written = write(fd, data->buffer + offset, data->length - offset);
+		if (written < 0 && errno == EINTR)
+			continue;
+
+		if (written <= 0)
 		{
-			NFC_ERR("net_nfc_util_alloc_data failed");
+			NFC_ERR("write to memfd failed [%d]", errno);
+			close(fd);
+			return -1;
 		}
+
+		offset += written;
 	}
-	else
+
+	if (fcntl(fd, F_ADD_SEALS, NET_NFC_UTIL_GDBUS_FD_SEALS) < 0)
 	{
-		NFC_ERR("message length is 0");
+		NFC_ERR("can not seal memfd [%d]", errno);
+		close(fd);
+		return -1;
 	}
 
-	variant = net_nfc_util_gdbus_data_to_variant(data);
+	return fd;
+}
+
+GUnixFDList *net_nfc_util_gdbus_data_to_fd_list(const data_s *data)
+{
+	GUnixFDList *fd_list;
+	int fd;
 
-	if (data != NULL)
-		net_nfc_util_free_data(data);
+	RETV_IF(NULL == data, NULL);
 
-	return variant;
+	if (data->length < NET_NFC_UTIL_GDBUS_FD_THRESHOLD)
+		return NULL;
+
+	fd = __net_nfc_util_gdbus_create_memfd(data);
+	if (fd < 0)
+		return NULL;
+
+	/* the list owns fd from here */
+	fd_list = g_unix_fd_list_new_from_array(&fd, 1);
+
+	return fd_list;
+}
+
+GMappedFile *net_nfc_util_gdbus_fd_list_to_data_s(GUnixFDList *fd_list,
+		gint32 index, data_s *data)
+{
+	GMappedFile *mapped;
+	GError *error = NULL;
+	int seals;
+	int fd;
+
+	RETV_IF(NULL == data, NULL);
+
+	data->buffer = NULL;
+	data->length = 0;
+
+	RETV_IF(NULL == fd_list, NULL);
+
+	/* the index comes from the peer */
+	if (index < 0 || index >= g_unix_fd_list_get_length(fd_list))
+	{
+		NFC_ERR("invalid fd index [%d]", index);
+
+		return NULL;
+	}
+
+	fd = g_unix_fd_list_get(fd_list, index, &error);
+	if (fd < 0)
+	{
+		NFC_ERR("can not get fd [%d] : %s", index, error->message);
+		g_error_free(error);
+
+		return NULL;
+	}
+
+	seals = fcntl(fd, F_GET_SEALS);
+	if (seals < 0 || (seals & NET_NFC_UTIL_GDBUS_FD_SEALS) !=
+			NET_NFC_UTIL_GDBUS_FD_SEALS)
+	{
+		NFC_ERR("fd [%d] is not a sealed memfd, seals [%x]", index, seals);
+		close(fd);
+
+		return NULL;
+	}
+
+	/* read only private mapping, the pages are never copied */
+	mapped = g_mapped_file_new_from_fd(fd, FALSE, &error);
+	close(fd);
+
+	if (NULL == mapped)
+	{
+		NFC_ERR("can not map fd [%d] : %s", index, error->message);
+		g_error_free(error);
+
+		return NULL;
+	}
+
+	data->buffer = (uint8_t *)g_mapped_file_get_contents(mapped);
+	data->length = g_mapped_file_get_length(mapped);
+
+	return mapped;
+}
+
+void net_nfc_util_gdbus_release_data_s(data_s *data, GMappedFile *mapped)
+{
+	RET_IF(NULL == data);
+
+	if (mapped != NULL)
+	{
+		g_mapped_file_unref(mapped);
+
+		data->buffer = NULL;
+		data->length = 0;
+	}
+	else
+	{
+		net_nfc_util_free_data(data);
+	}
 }
@@ -18,9 +18,14 @@
 #define __NET_NFC_UTIL_GDBUS_INTERNAL_H__
 
 #include <glib.h>
+#include <gio/gunixfdlist.h>
 
 #include "net_nfc_typedef_internal.h"
 
+/* buffers from this size on are passed as a sealed memfd, below it the
+   mapping costs more than copying into the message */
+#define NET_NFC_UTIL_GDBUS_FD_THRESHOLD	(4 * 1024)
+
 void net_nfc_util_gdbus_variant_to_buffer(GVariant *variant, uint8_t **buffer,
 		size_t *length);
 
@@ -33,9 +38,27 @@ GVariant *net_nfc_util_gdbus_buffer_to_variant(const uint8_t *buffer,
 
 GVariant *net_nfc_util_gdbus_data_to_variant(const data_s *data);
 
+/* the variant takes data->buffer, data is left empty */
+GVariant *net_nfc_util_gdbus_data_take_to_variant(data_s *data);
+
 ndef_message_s *net_nfc_util_gdbus_variant_to_ndef_message(GVariant *variant);
 
 GVariant *net_nfc_util_gdbus_ndef_message_to_variant(
 		const ndef_message_s *message);
 
+/* NULL when data is below the threshold or memfd is not available, the
+   caller falls back to the "ay" method. the fd is at index 0 of the list */
+GUnixFDList *net_nfc_util_gdbus_data_to_fd_list(const data_s *data);
+
+/* maps the memfd at index read only, data points into the mapping until
+   it is released with net_nfc_util_gdbus_release_data_s */
+GMappedFile *net_nfc_util_gdbus_fd_list_to_data_s(GUnixFDList *fd_list,
+		gint32 index, data_s *data);
+
+/* unmaps data when mapped is set, frees it otherwise */
+void net_nfc_util_gdbus_release_data_s(data_s *data, GMappedFile *mapped);
+
+ndef_message_s *net_nfc_util_gdbus_fd_list_to_ndef_message(
+		GUnixFDList *fd_list, gint32 index);
+
 #endif //__NET_NFC_UTIL_GDBUS_INTERNAL_H__
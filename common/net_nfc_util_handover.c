@@ -114,7 +114,7 @@ static void __free_all_data(gpointer data, gpointer user_data)
 
 static net_nfc_error_e
 	__net_nfc_util_create_connection_handover_collsion_resolution_record(
-	ndef_record_s **record)
+	net_nfc_util_arena_s *arena, ndef_record_s **record)
 {
 
 	uint32_t state = 0;
@@ -140,8 +140,8 @@ static net_nfc_error_e
 	NFC_DBG("rand number = [0x%x] [0x%x] => [0x%x]",
 		payload.buffer[0], payload.buffer[1], random_num);
 
-	return net_nfc_util_create_record(NET_NFC_RECORD_WELL_KNOWN_TYPE,
-		&typeName, NULL, &payload, record);
+	return net_nfc_util_create_record_with_arena(arena,
+		NET_NFC_RECORD_WELL_KNOWN_TYPE, &typeName, NULL, &payload, record);
 }
 
 static int __net_nfc_get_size_of_attribute(int attribute)
@@ -733,13 +733,16 @@ net_nfc_error_e net_nfc_util_create_carrier_config_from_config_record(
 	return result;
 }
 
-net_nfc_error_e net_nfc_util_create_handover_request_message(ndef_message_s **message)
+static net_nfc_error_e __net_nfc_util_create_handover_request_message(
+		ndef_message_s **message, bool use_arena)
 {
 	ndef_message_s *inner_message = NULL;
+	net_nfc_util_arena_s *arena;
 	net_nfc_error_e error;
 	ndef_record_s *record = NULL;
 	data_s type = { NULL, 0 };
 	data_s payload = { NULL, 0 };
+	data_s inner = { NULL, 0 };
 	int size = 0;
 
 	if (message == NULL)
@@ -747,13 +750,20 @@ net_nfc_error_e net_nfc_util_create_handover_request_message(ndef_message_s **me
 		return NET_NFC_NULL_PARAMETER;
 	}
 
-	error = net_nfc_util_create_ndef_message(message);
+	if (use_arena)
+		error = net_nfc_util_create_ndef_message_with_arena(message,
+				NET_NFC_UTIL_ARENA_DEFAULT_SIZE);
+	else
+		error = net_nfc_util_create_ndef_message(message);
 	if (error != NET_NFC_OK)
 	{
 		return error;
 	}
 
-	error = net_nfc_util_create_ndef_message(&inner_message);
+	arena = (*message)->arena;
+
+	/* released with the arena of message if there is one */
+	error = net_nfc_util_create_inner_ndef_message(*message, &inner_message);
 	if (error != NET_NFC_OK)
 	{
 		net_nfc_util_free_ndef_message(*message);
@@ -762,92 +772,113 @@ net_nfc_error_e net_nfc_util_create_handover_request_message(ndef_message_s **me
 		return error;
 	}
 
-	__net_nfc_util_create_connection_handover_collsion_resolution_record(&record);
+	__net_nfc_util_create_connection_handover_collsion_resolution_record(
+			arena, &record);
 	net_nfc_util_append_record(inner_message, record);
 
 	size = net_nfc_util_get_ndef_message_length(inner_message) + 1;
-	_net_nfc_util_alloc_mem(payload.buffer, size);
+	if (arena != NULL)
+		payload.buffer = net_nfc_util_arena_alloc(arena, size);
+	else
+		_net_nfc_util_alloc_mem(payload.buffer, size);
 	if (payload.buffer == NULL)
 	{
-		net_nfc_util_free_ndef_message(inner_message);
-		net_nfc_util_free_ndef_message(*message);
-		*message = NULL;
-
-		return NET_NFC_ALLOC_FAIL;
+		error = NET_NFC_ALLOC_FAIL;
+		goto END;
 	}
 	payload.length = size;
 
-	uint8_t version = CH_VERSION;
+	(payload.buffer)[0] = CH_VERSION;
 
-	(payload.buffer)[0] = version;
-	(payload.buffer)++;
-	(payload.length)--;
+	inner.buffer = payload.buffer + 1;
+	inner.length = payload.length - 1;
 
-	error = net_nfc_util_convert_ndef_message_to_rawdata(inner_message, &payload);
+	error = net_nfc_util_convert_ndef_message_to_rawdata(inner_message, &inner);
 	if (error != NET_NFC_OK)
+		goto END;
+
+	type.buffer = (uint8_t *)CH_REQ_RECORD_TYPE;
+	type.length = strlen(CH_REQ_RECORD_TYPE);
+
+	net_nfc_util_create_record_with_arena(arena,
+			NET_NFC_RECORD_WELL_KNOWN_TYPE, &type, NULL, &payload, &record);
+	net_nfc_util_append_record(*message, record);
+
+END :
+	if (NULL == arena)
 	{
 		_net_nfc_util_free_mem(payload.buffer);
 		net_nfc_util_free_ndef_message(inner_message);
+	}
+
+	if (error != NET_NFC_OK)
+	{
 		net_nfc_util_free_ndef_message(*message);
 		*message = NULL;
-
-		return error;
 	}
 
-	net_nfc_util_free_ndef_message(inner_message);
-	(payload.buffer)--;
-	(payload.length)++;
-
-	type.buffer = (uint8_t *)CH_REQ_RECORD_TYPE;
-	type.length = strlen(CH_REQ_RECORD_TYPE);
-
-	net_nfc_util_create_record(NET_NFC_RECORD_WELL_KNOWN_TYPE, &type, NULL, &payload, &record);
-	net_nfc_util_append_record(*message, record);
+	return error;
+}
 
-	_net_nfc_util_free_mem(payload.buffer);
+net_nfc_error_e net_nfc_util_create_handover_request_message(ndef_message_s **message)
+{
+	return __net_nfc_util_create_handover_request_message(message, false);
+}
 
-	return NET_NFC_OK;
+net_nfc_error_e net_nfc_util_create_handover_request_message_with_arena(
+		ndef_message_s **message)
+{
+	return __net_nfc_util_create_handover_request_message(message, true);
 }
 
-net_nfc_error_e net_nfc_util_create_handover_select_message(ndef_message_s **message)
+static net_nfc_error_e __net_nfc_util_create_handover_select_message(
+		ndef_message_s **message, bool use_arena)
 {
 	net_nfc_error_e error = NET_NFC_OK;
 	ndef_record_s *record = NULL;
 	data_s type = { NULL, 0 };
 	data_s payload = { NULL, 0 };
+	uint8_t version = CH_VERSION;
 
 	if (message == NULL)
 	{
 		return NET_NFC_NULL_PARAMETER;
 	}
 
-	error = net_nfc_util_create_ndef_message(message);
+	if (use_arena)
+		error = net_nfc_util_create_ndef_message_with_arena(message,
+				NET_NFC_UTIL_ARENA_DEFAULT_SIZE);
+	else
+		error = net_nfc_util_create_ndef_message(message);
 	if (error != NET_NFC_OK)
 	{
 		return error;
 	}
 
-	_net_nfc_util_alloc_mem(payload.buffer, 1);
-	if (payload.buffer == NULL)
-	{
-		net_nfc_util_free_ndef_message(*message);
-		return NET_NFC_ALLOC_FAIL;
-	}
+	payload.buffer = &version;
 	payload.length = (uint32_t)1;
 
-	(payload.buffer)[0] = CH_VERSION;
-
 	type.buffer = (uint8_t*)CH_SEL_RECORD_TYPE;
 	type.length = strlen(CH_SEL_RECORD_TYPE);
 
-	net_nfc_util_create_record(NET_NFC_RECORD_WELL_KNOWN_TYPE, &type, NULL, &payload, &record);
+	net_nfc_util_create_record_with_arena((*message)->arena,
+			NET_NFC_RECORD_WELL_KNOWN_TYPE, &type, NULL, &payload, &record);
 	net_nfc_util_append_record(*message, record);
 
-	_net_nfc_util_free_mem(payload.buffer);
-
 	return NET_NFC_OK;
 }
 
+net_nfc_error_e net_nfc_util_create_handover_select_message(ndef_message_s **message)
+{
+	return __net_nfc_util_create_handover_select_message(message, false);
+}
+
+net_nfc_error_e net_nfc_util_create_handover_select_message_with_arena(
+		ndef_message_s **message)
+{
+	return __net_nfc_util_create_handover_select_message(message, true);
+}
+
 net_nfc_error_e net_nfc_util_create_handover_carrier_record(ndef_record_s ** record)
 {
 	data_s payload = {NULL,0};
@@ -921,18 +952,10 @@ net_nfc_error_e net_nfc_util_create_handover_error_record(ndef_record_s **record
 	return NET_NFC_OK;
 }
 
-/*	inner_msg should be freed after using 	*/
-
-static net_nfc_error_e __net_nfc_get_inner_message(ndef_message_s *message, ndef_message_s *inner_msg)
+static net_nfc_error_e __net_nfc_get_inner_payload(ndef_message_s *message, data_s *payload)
 {
-	net_nfc_error_e error;
 	ndef_record_s *inner_record = NULL;
 
-	if (message == NULL || inner_msg == NULL)
-	{
-		return NET_NFC_NULL_PARAMETER;
-	}
-
 	inner_record = message->records;
 	if (inner_record == NULL)
 	{
@@ -947,20 +970,54 @@ static net_nfc_error_e __net_nfc_get_inner_message(ndef_message_s *message, ndef
 		return NET_NFC_INVALID_FORMAT;
 	}
 
-	if (inner_record->payload_s.length > 1)
+	if (inner_record->payload_s.length <= 1)
 	{
-		/* There is Alternative Carrier Record or Collision Res. Rec. */
-		(inner_record->payload_s.buffer)++; /* version */
-		(inner_record->payload_s.length)--;
-		error = net_nfc_util_convert_rawdata_to_ndef_message(&(inner_record->payload_s), inner_msg);
-		(inner_record->payload_s.buffer)--;
-		(inner_record->payload_s.length)++;
+		return NET_NFC_NO_DATA_FOUND;
 	}
-	else
+
+	/* There is Alternative Carrier Record or Collision Res. Rec. */
+	payload->buffer = inner_record->payload_s.buffer + 1; /* version */
+	payload->length = inner_record->payload_s.length - 1;
+
+	return NET_NFC_OK;
+}
+
+/*	inner_msg should be freed after using 	*/
+
+static net_nfc_error_e __net_nfc_get_inner_message(ndef_message_s *message, ndef_message_s *inner_msg)
+{
+	net_nfc_error_e error;
+	data_s payload = { NULL, 0 };
+
+	if (message == NULL || inner_msg == NULL)
+	{
+		return NET_NFC_NULL_PARAMETER;
+	}
+
+	error = __net_nfc_get_inner_payload(message, &payload);
+	if (error == NET_NFC_OK)
+		error = net_nfc_util_convert_rawdata_to_ndef_message(&payload, inner_msg);
+
+	return error;
+}
+
+/*	read-only variant, records of inner_msg borrow the payload of message.
+	inner_msg should be freed after using, before message is freed 	*/
+
+static net_nfc_error_e __net_nfc_get_inner_message_view(ndef_message_s *message, ndef_message_s *inner_msg)
+{
+	net_nfc_error_e error;
+	data_s payload = { NULL, 0 };
+
+	if (message == NULL || inner_msg == NULL)
 	{
-		error = NET_NFC_NO_DATA_FOUND;
+		return NET_NFC_NULL_PARAMETER;
 	}
 
+	error = __net_nfc_get_inner_payload(message, &payload);
+	if (error == NET_NFC_OK)
+		error = net_nfc_util_convert_rawdata_to_ndef_message_view(&payload, inner_msg, NULL, 0);
+
 	return error;
 }
 
@@ -994,32 +1051,49 @@ static net_nfc_error_e __net_nfc_replace_inner_message(ndef_message_s *message,
 	{
 		/* There is Alternative Carrier Record or Collision Res. Rec. */
 		data_s tdata = { NULL, 0 };
-		int inner_length;
-
-		inner_length = net_nfc_util_get_ndef_message_length(inner_msg);
+		data_s inner = { NULL, 0 };
 
-		_net_nfc_util_alloc_mem(tdata.buffer, inner_length + 1);
-		if (tdata.buffer == NULL)
+		/* the payload is freed below, other records may still use it */
+		if (NULL == inner_record->arena
+				&& net_nfc_util_unshare_record(inner_record) != NET_NFC_OK)
 		{
 			return NET_NFC_ALLOC_FAIL;
 		}
 
-		(tdata.buffer)++;
-		tdata.length = inner_length;
-		error = net_nfc_util_convert_ndef_message_to_rawdata(inner_msg, &tdata);
+		if (inner_record->arena != NULL)
+		{
+			/* the old payload stays in the arena until the message is freed */
+			inner.length = net_nfc_util_get_ndef_message_length(inner_msg);
+			tdata.length = inner.length + 1;
+			tdata.buffer = net_nfc_util_arena_alloc(inner_record->arena,
+					tdata.length);
+			if (tdata.buffer == NULL)
+			{
+				return NET_NFC_ALLOC_FAIL;
+			}
+
+			inner.buffer = tdata.buffer + 1;
+			error = net_nfc_util_convert_ndef_message_to_rawdata(inner_msg, &inner);
+		}
+		else
+		{
+			/* leave one byte in front for the version */
+			error = net_nfc_util_serialize_ndef_message(inner_msg, 1, &tdata);
+		}
+
 		if (error == NET_NFC_OK)
 		{
-			(tdata.buffer)--;
-			(tdata.length)++;
 			(tdata.buffer)[0] = (inner_record->payload_s.buffer)[0];
-			_net_nfc_util_free_mem(inner_record->payload_s.buffer);
+			if (NULL == inner_record->arena)
+				_net_nfc_util_free_mem(inner_record->payload_s.buffer);
 			inner_record->payload_s.buffer = tdata.buffer;
 			inner_record->payload_s.length = tdata.length;
+			inner_record->SR = (tdata.length < 256) ? 1 : 0;
+			inner_record->encoded_length = 0;
 		}
 		else
 		{
 			NFC_ERR("net_nfc_util_convert_ndef_message_to_rawdata failed [%d]", error);
-			_net_nfc_util_free_mem(tdata.buffer);
 		}
 	}
 	else
@@ -1272,7 +1346,7 @@ net_nfc_error_e net_nfc_util_get_carrier_config_record(ndef_message_s *message,
 		return error;
 	}
 
-	if ((error = __net_nfc_get_inner_message(message, inner_msg)) == NET_NFC_OK)
+	if ((error = __net_nfc_get_inner_message_view(message, inner_msg)) == NET_NFC_OK)
 	{
 		current = inner_msg->records;
 		for (idx = 0; idx < inner_msg->recordCount; idx++)
@@ -1324,7 +1398,7 @@ net_nfc_error_e net_nfc_util_get_handover_random_number(ndef_message_s *message,
 		return error;
 	}
 
-	if ((error = __net_nfc_get_inner_message(message, inner_msg)) == NET_NFC_OK)
+	if ((error = __net_nfc_get_inner_message_view(message, inner_msg)) == NET_NFC_OK)
 	{
 		cr_record = inner_msg->records;
 		if (strncmp((char*)cr_record->type_s.buffer, COLLISION_DETECT_RECORD_TYPE, (size_t)cr_record->type_s.length) != 0
@@ -1366,7 +1440,7 @@ net_nfc_error_e net_nfc_util_get_alternative_carrier_record_count(ndef_message_s
 
 	*count = 0;
 
-	if ((error = __net_nfc_get_inner_message(message, inner_msg)) == NET_NFC_OK)
+	if ((error = __net_nfc_get_inner_message_view(message, inner_msg)) == NET_NFC_OK)
 	{
 		current = inner_msg->records;
 		for (idx = 0; idx < inner_msg->recordCount; idx++)
@@ -1409,7 +1483,7 @@ net_nfc_error_e net_nfc_util_get_alternative_carrier_power_status(ndef_message_s
 		return error;
 	}
 
-	if ((error = __net_nfc_get_inner_message(message, inner_msg)) == NET_NFC_OK)
+	if ((error = __net_nfc_get_inner_message_view(message, inner_msg)) == NET_NFC_OK)
 	{
 		error = NET_NFC_OUT_OF_BOUND;
 		current = inner_msg->records;
@@ -1468,6 +1542,12 @@ net_nfc_error_e net_nfc_util_set_alternative_carrier_power_status(ndef_message_s
 			{
 				if (idx_count == index)
 				{
+					if (net_nfc_util_unshare_record(current) != NET_NFC_OK)
+					{
+						error = NET_NFC_ALLOC_FAIL;
+						break;
+					}
+
 					current->payload_s.buffer[0] = (power_status & 0x3) | (current->payload_s.buffer[0] & 0xFC);
 
 					__net_nfc_replace_inner_message(message, inner_msg);
@@ -1586,7 +1666,7 @@ net_nfc_error_e net_nfc_util_get_selector_power_status(ndef_message_s *message,
 
 	if ((error = net_nfc_util_create_ndef_message(&inner_msg)) == NET_NFC_OK)
 	{
-		if ((error = __net_nfc_get_inner_message(message, inner_msg)) == NET_NFC_OK)
+		if ((error = __net_nfc_get_inner_message_view(message, inner_msg)) == NET_NFC_OK)
 		{
 			if (inner_msg->recordCount > 1)
 			{
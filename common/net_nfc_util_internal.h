@@ -55,6 +55,15 @@ void __net_nfc_util_free_mem(void **mem, char *filename, unsigned int line);
 bool net_nfc_util_alloc_data(data_s *data, uint32_t length);
 void net_nfc_util_free_data(data_s *data);
 
+/* Arena utils */
+/* bump allocator. memory carved from an arena is zero filled and is only
+   released all at once by net_nfc_util_arena_destroy */
+#define NET_NFC_UTIL_ARENA_DEFAULT_SIZE	1024
+
+net_nfc_util_arena_s *net_nfc_util_arena_create(uint32_t block_size);
+void *net_nfc_util_arena_alloc(net_nfc_util_arena_s *arena, uint32_t size);
+void net_nfc_util_arena_destroy(net_nfc_util_arena_s *arena);
+
 net_nfc_conn_handover_carrier_state_e net_nfc_util_get_cps(net_nfc_conn_handover_carrier_type_e carrier_type);
 
 uint8_t *net_nfc_util_get_local_bt_address();
@@ -64,6 +73,38 @@ bool net_nfc_util_strip_string(char *buffer, int buffer_length);
 
 void net_nfc_util_compute_CRC(CRC_type_e CRC_type, uint8_t *buffer, uint32_t length);
 
+/* bit of net_nfc_event_filter_e which covers the target type,
+   NET_NFC_ALL_ENABLE if no bit does */
+net_nfc_event_filter_e net_nfc_util_get_event_filter(net_nfc_target_type_e type);
+
+/* Tag info utils */
+/* compact target info : version, count, then per key an id of a well-known
+   key (or 0, key length, key) followed by value length, value */
+#define NET_NFC_TAG_INFO_VERSION	1
+#define NET_NFC_TAG_INFO_KEY_MAX	15
+
+/* room net_nfc_util_encode_tag_info needs for a legacy key/value list */
+#define NET_NFC_TAG_INFO_ENCODED_MAX(length, number_of_keys) \
+	((length) + (number_of_keys) + 2)
+
+/* returns the encoded length, 0 if legacy is malformed */
+uint32_t net_nfc_util_encode_tag_info(const data_s *legacy, int number_of_keys,
+		uint8_t *buffer, uint32_t length);
+
+/* lists below are one allocation, release them with net_nfc_util_free_tag_info */
+net_nfc_tag_info_s *net_nfc_util_decode_tag_info(const uint8_t *buffer,
+		uint32_t length, int *number_of_keys);
+net_nfc_tag_info_s *net_nfc_util_duplicate_tag_info(
+		const net_nfc_tag_info_s *list, int number_of_keys);
+net_nfc_tag_info_s *net_nfc_util_find_tag_info(net_nfc_tag_info_s *list,
+		int number_of_keys, const char *key);
+void net_nfc_util_free_tag_info(net_nfc_tag_info_s *list);
+
 const char *net_nfc_util_get_schema_string(int index);
 
+/* longest schema which prefixes uri, NET_NFC_SCHEMA_FULL_URI if none.
+   prefix_length is set to the length of the schema string */
+net_nfc_schema_type_e net_nfc_util_get_schema_type(const char *uri,
+		uint32_t *prefix_length);
+
 #endif //__NET_NFC_UTIL_INTERNAL_H__
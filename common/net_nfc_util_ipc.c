@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2012-2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 				 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// libc header
+#define _GNU_SOURCE
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+// platform header
+
+// nfc-manager header
+#include "net_nfc_debug_internal.h"
+#include "net_nfc_util_ipc_internal.h"
+
+int net_nfc_util_ipc_connect(void)
+{
+	int fd;
+	struct stat st;
+	struct ucred cred = { 0, };
+	socklen_t length = sizeof(cred);
+	struct sockaddr_un addr = { 0, };
+
+	fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+	if (fd < 0)
+	{
+		NFC_ERR("socket failed, [%d]", errno);
+		return -1;
+	}
+
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, NET_NFC_IPC_SOCKET_PATH, sizeof(addr.sun_path) - 1);
+
+	if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+	{
+		NFC_ERR("connect failed, [%d]", errno);
+		close(fd);
+
+		return -1;
+	}
+
+	/* only the daemon can create the directory, so whoever listens
+	   there and owns it is the daemon and not a squatter */
+	if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &length) < 0
+			|| lstat(NET_NFC_IPC_SOCKET_DIR, &st) < 0
+			|| S_ISDIR(st.st_mode) == 0
+			|| (st.st_mode & (S_IWGRP | S_IWOTH)) != 0
+			|| st.st_uid != cred.uid)
+	{
+		NFC_ERR("[%s] is not served by the daemon", NET_NFC_IPC_SOCKET_PATH);
+		close(fd);
+
+		return -1;
+	}
+
+	return fd;
+}
+
+bool net_nfc_util_ipc_send(int fd, net_nfc_ipc_header_s *header,
+		const void *payload, uint32_t length)
+{
+	ssize_t ret;
+	struct msghdr msg = { 0, };
+	struct iovec iov[2];
+
+	RETV_IF(NULL == header, false);
+	RETV_IF(length > NET_NFC_IPC_PAYLOAD_MAX, false);
+
+	header->length = length;
+
+	iov[0].iov_base = header;
+	iov[0].iov_len = sizeof(*header);
+	iov[1].iov_base = (void *)payload;
+	iov[1].iov_len = length;
+
+	msg.msg_iov = iov;
+	msg.msg_iovlen = (length > 0) ? 2 : 1;
+
+	/* a seqpacket frame goes out whole or not at all, so threads can
+	   share the socket without a lock */
+	do
+	{
+		ret = sendmsg(fd, &msg, MSG_NOSIGNAL);
+	}
+	while (ret < 0 && EINTR == errno);
+
+	if (ret != (ssize_t)(sizeof(*header) + length))
+	{
+		NFC_ERR("sendmsg failed, [%d]", errno);
+		return false;
+	}
+
+	return true;
+}
+
+ssize_t net_nfc_util_ipc_recv(int fd, uint8_t *buffer, int flags)
+{
+	ssize_t ret;
+	net_nfc_ipc_header_s *header = (net_nfc_ipc_header_s *)buffer;
+
+	RETV_IF(NULL == buffer, -1);
+
+	do
+	{
+		ret = recv(fd, buffer, sizeof(*header) + NET_NFC_IPC_PAYLOAD_MAX,
+				flags | MSG_TRUNC);
+	}
+	while (ret < 0 && EINTR == errno);
+
+	if (ret <= 0)
+		return ret;
+
+	if ((size_t)ret < sizeof(*header)
+			|| (size_t)ret > sizeof(*header) + NET_NFC_IPC_PAYLOAD_MAX
+			|| header->length != (size_t)ret - sizeof(*header))
+	{
+		NFC_ERR("malformed frame, [%d] bytes", (int)ret);
+		return -1;
+	}
+
+	return ret;
+}
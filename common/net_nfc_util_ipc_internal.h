@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2012-2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 				 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __NET_NFC_UTIL_IPC_INTERNAL_H__
+#define __NET_NFC_UTIL_IPC_INTERNAL_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/types.h>
+
+/* framed request/response transport next to D-Bus, see
+   daemon/net_nfc_server_ipc.c. it is a SOCK_SEQPACKET socket, so every
+   frame is one message and replies may come back in any order */
+#define NET_NFC_IPC_SOCKET_DIR	"/run/nfc-manager"
+#define NET_NFC_IPC_SOCKET_PATH	NET_NFC_IPC_SOCKET_DIR "/ipc"
+
+/* group that may connect, the daemon's own group when it does not exist */
+#define NET_NFC_IPC_SOCKET_GROUP	"nfc"
+
+/* the largest payload of a frame, above any transceive */
+#define NET_NFC_IPC_PAYLOAD_MAX	(64 * 1024)
+
+/* set on frames sent by the daemon */
+#define NET_NFC_IPC_FLAG_REPLY	(1 << 0)
+
+typedef enum
+{
+	NET_NFC_IPC_PING = 1,
+	/* reply payload : uint32_t state */
+	NET_NFC_IPC_GET_SERVER_STATE,
+	/* request payload : uint32_t handle, uint32_t dev_type, bytes.
+	   reply payload : response bytes */
+	NET_NFC_IPC_TRANSCEIVE,
+}
+net_nfc_ipc_type_e;
+
+typedef struct _net_nfc_ipc_header_s
+{
+	uint32_t length; /* payload bytes after the header */
+	uint32_t id; /* chosen by the client, echoed in the reply */
+	uint16_t type;
+	uint16_t flags;
+	int32_t result; /* net_nfc_error_e of a reply, 0 in a request */
+}
+net_nfc_ipc_header_s;
+
+/* blocking connection to the daemon, -1 if it does not listen or the
+   peer is not the owner of NET_NFC_IPC_SOCKET_DIR */
+int net_nfc_util_ipc_connect(void);
+
+/* sends header and payload as one frame, header->length is set here */
+bool net_nfc_util_ipc_send(int fd, net_nfc_ipc_header_s *header,
+		const void *payload, uint32_t length);
+
+/* receives one frame into buffer, which holds at least the header and
+   NET_NFC_IPC_PAYLOAD_MAX bytes. returns the frame size, 0 when the peer
+   closed, -1 on errors and malformed frames. flags is passed to recv */
+ssize_t net_nfc_util_ipc_recv(int fd, uint8_t *buffer, int flags);
+
+#endif //__NET_NFC_UTIL_IPC_INTERNAL_H__
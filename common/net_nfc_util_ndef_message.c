@@ -21,382 +21,1238 @@
 #include "net_nfc_util_ndef_message.h"
 #include "net_nfc_util_ndef_record.h"
 
-static net_nfc_error_e __net_nfc_repair_record_flags(ndef_message_s *ndef_message);
+static net_nfc_error_e __net_nfc_repair_record_flags(ndef_message_s *ndef_message,
+		ndef_record_s *inner);
+static GPtrArray *__net_nfc_get_record_index(ndef_message_s *ndef_message);
+static void __net_nfc_drop_record_index(ndef_message_s *ndef_message);
+static void __net_nfc_lookup_add_record(ndef_message_s *ndef_message,
+		ndef_record_s *record);
+static void __net_nfc_drop_record_lookup(ndef_message_s *ndef_message);
+
+static void *__net_nfc_util_message_alloc(ndef_message_s *ndef, uint32_t size)
+{
+	void *mem = NULL;
+
+	if (ndef->arena != NULL)
+		return net_nfc_util_arena_alloc(ndef->arena, size);
+
+	_net_nfc_util_alloc_mem(mem, size);
+
+	return mem;
+}
+
+/* free lists of one thread for messages made by
+   net_nfc_util_create_pooled_ndef_message. objects are reset when they are
+   put back, so what is taken out is zero filled */
+#define NET_NFC_NDEF_POOL_MESSAGE_MAX	8
+#define NET_NFC_NDEF_POOL_RECORD_MAX	32
+/* record blocks of views are recycled if they hold up to this many records */
+#define NET_NFC_NDEF_POOL_BLOCK_RECORDS	8
+
+typedef struct _net_nfc_ndef_pool_s
+{
+	ndef_message_s *messages[NET_NFC_NDEF_POOL_MESSAGE_MAX];
+	guint message_count;
+	ndef_record_s *records[NET_NFC_NDEF_POOL_RECORD_MAX];
+	guint record_count;
+	ndef_record_s *blocks[NET_NFC_NDEF_POOL_MESSAGE_MAX];
+	guint block_count;
+	guint high_water;
+} net_nfc_ndef_pool_s;
+
+static void __net_nfc_ndef_pool_destroy(gpointer data);
+
+static GPrivate ndef_pool_key = G_PRIVATE_INIT(__net_nfc_ndef_pool_destroy);
+
+static gint ndef_pool_hits;
+static gint ndef_pool_misses;
+static gint ndef_pool_high_water;
+
+static void __net_nfc_ndef_pool_destroy(gpointer data)
+{
+	net_nfc_ndef_pool_s *pool = data;
+	guint i;
+
+	for (i = 0; i < pool->message_count; i++)
+		_net_nfc_util_free_mem(pool->messages[i]);
+
+	for (i = 0; i < pool->record_count; i++)
+		_net_nfc_util_free_mem(pool->records[i]);
+
+	for (i = 0; i < pool->block_count; i++)
+		_net_nfc_util_free_mem(pool->blocks[i]);
+
+	_net_nfc_util_free_mem(pool);
+}
+
+static net_nfc_ndef_pool_s *__net_nfc_ndef_pool_get(void)
+{
+	net_nfc_ndef_pool_s *pool = g_private_get(&ndef_pool_key);
+
+	if (NULL == pool)
+	{
+		_net_nfc_util_alloc_mem(pool, sizeof(*pool));
+		if (pool != NULL)
+			g_private_set(&ndef_pool_key, pool);
+	}
+
+	return pool;
+}
+
+/* take an object out of a free list, or allocate it if the list is empty */
+static void *__net_nfc_ndef_pool_take(void **list, guint *count, gsize size)
+{
+	void *mem = NULL;
+
+	if (list != NULL && *count > 0)
+	{
+		g_atomic_int_inc(&ndef_pool_hits);
+
+		return list[--(*count)];
+	}
+
+	g_atomic_int_inc(&ndef_pool_misses);
+
+	_net_nfc_util_alloc_mem(mem, size);
+
+	return mem;
+}
+
+/* reset an object into a free list, or free it if the list is full */
+static void __net_nfc_ndef_pool_put(net_nfc_ndef_pool_s *pool, void **list,
+		guint *count, guint max, void *mem, gsize size)
+{
+	guint held;
+	gint high_water;
+
+	if (*count >= max)
+	{
+		_net_nfc_util_free_mem(mem);
+		return;
+	}
+
+	memset(mem, 0, size);
+	list[(*count)++] = mem;
+
+	held = pool->message_count + pool->record_count + pool->block_count;
+	if (held <= pool->high_water)
+		return;
+
+	pool->high_water = held;
+
+	do
+	{
+		high_water = g_atomic_int_get(&ndef_pool_high_water);
+		if ((gint)held <= high_water)
+			break;
+	}
+	while (g_atomic_int_compare_and_exchange(&ndef_pool_high_water,
+				high_water, held) == FALSE);
+}
+
+static ndef_record_s *__net_nfc_ndef_pool_take_record(void)
+{
+	net_nfc_ndef_pool_s *pool = __net_nfc_ndef_pool_get();
+
+	if (NULL == pool)
+		return __net_nfc_ndef_pool_take(NULL, NULL, sizeof(ndef_record_s));
+
+	return __net_nfc_ndef_pool_take((void **)pool->records,
+			&pool->record_count, sizeof(ndef_record_s));
+}
+
+static void __net_nfc_ndef_pool_put_record(ndef_record_s *record)
+{
+	net_nfc_ndef_pool_s *pool = __net_nfc_ndef_pool_get();
+
+	if (NULL == pool)
+	{
+		_net_nfc_util_free_mem(record);
+		return;
+	}
+
+	__net_nfc_ndef_pool_put(pool, (void **)pool->records, &pool->record_count,
+			NET_NFC_NDEF_POOL_RECORD_MAX, record, sizeof(ndef_record_s));
+}
+
+/* blocks always hold NET_NFC_NDEF_POOL_BLOCK_RECORDS records */
+static ndef_record_s *__net_nfc_ndef_pool_take_block(void)
+{
+	net_nfc_ndef_pool_s *pool = __net_nfc_ndef_pool_get();
+	gsize size = NET_NFC_NDEF_POOL_BLOCK_RECORDS * sizeof(ndef_record_s);
+
+	if (NULL == pool)
+		return __net_nfc_ndef_pool_take(NULL, NULL, size);
+
+	return __net_nfc_ndef_pool_take((void **)pool->blocks, &pool->block_count,
+			size);
+}
+
+static void __net_nfc_ndef_pool_put_block(ndef_record_s *block)
+{
+	net_nfc_ndef_pool_s *pool = __net_nfc_ndef_pool_get();
+
+	if (NULL == pool)
+	{
+		_net_nfc_util_free_mem(block);
+		return;
+	}
+
+	__net_nfc_ndef_pool_put(pool, (void **)pool->blocks, &pool->block_count,
+			NET_NFC_NDEF_POOL_MESSAGE_MAX, block,
+			NET_NFC_NDEF_POOL_BLOCK_RECORDS * sizeof(ndef_record_s));
+}
+
+static void __net_nfc_ndef_pool_put_message(ndef_message_s *ndef_message)
+{
+	net_nfc_ndef_pool_s *pool = __net_nfc_ndef_pool_get();
+
+	if (NULL == pool)
+	{
+		_net_nfc_util_free_mem(ndef_message);
+		return;
+	}
+
+	__net_nfc_ndef_pool_put(pool, (void **)pool->messages, &pool->message_count,
+			NET_NFC_NDEF_POOL_MESSAGE_MAX, ndef_message, sizeof(ndef_message_s));
+}
+
+static ndef_record_s *__net_nfc_util_record_node_alloc(ndef_message_s *ndef)
+{
+	if (ndef->pooled && NULL == ndef->arena)
+		return __net_nfc_ndef_pool_take_record();
+
+	return __net_nfc_util_message_alloc(ndef, sizeof(ndef_record_s));
+}
+
+/* header of one record (or chunk) as it is laid out in the serial form */
+typedef struct _net_nfc_ndef_header_s
+{
+	uint8_t flags;
+	uint8_t type_length;
+	uint8_t id_length;
+	uint32_t payload_length;
+	uint32_t length; /* bytes of the header itself */
+} net_nfc_ndef_header_s;
+
+/* position of a parser in the record sequence of a message */
+typedef struct _net_nfc_ndef_sequence_s
+{
+	uint32_t count; /* complete records, chunks are counted once */
+	bool started;
+	bool in_chunk;
+	bool done;
+} net_nfc_ndef_sequence_s;
+
+#define NET_NFC_NDEF_HEADER_MAX_LENGTH	7
+
+/* layout of the header bytes, selected by the SR and IL flags */
+typedef struct _net_nfc_ndef_header_layout_s
+{
+	uint8_t length;
+	uint8_t id_mask; /* masks out the id length byte if IL is clear */
+} net_nfc_ndef_header_layout_s;
+
+#define NET_NFC_NDEF_HEADER_LAYOUT(flags)	(((flags) >> 3) & 0x03)
+
+static const net_nfc_ndef_header_layout_s header_layouts[4] =
+{
+	{ 6, 0x00 }, /* 4 bytes payload length */
+	{ 7, 0xff }, /* 4 bytes payload length, id length */
+	{ 3, 0x00 }, /* SR */
+	{ 4, 0xff }, /* SR, id length */
+};
+
+/* returns NET_NFC_BUFFER_TOO_SMALL if the header is not complete yet */
+static net_nfc_error_e __net_nfc_decode_record_header(const uint8_t *data,
+		uint32_t length, net_nfc_ndef_header_s *header)
+{
+	const net_nfc_ndef_header_layout_s *layout;
+
+	if (length < 1)
+		return NET_NFC_BUFFER_TOO_SMALL;
+
+	header->flags = data[0];
+
+	layout = &header_layouts[NET_NFC_NDEF_HEADER_LAYOUT(data[0])];
+	header->length = layout->length;
+
+	if (length < header->length)
+		return NET_NFC_BUFFER_TOO_SMALL;
+
+	header->type_length = data[1];
+
+	if (header->flags & NET_NFC_NDEF_RECORD_MASK_SR)
+		header->payload_length = data[2];
+	else
+		header->payload_length = ((uint32_t)data[2] << 24) | ((uint32_t)data[3] << 16)
+			| ((uint32_t)data[4] << 8) | (uint32_t)data[5];
+
+	/* without IL the last byte is the payload length, masked to zero */
+	header->id_length = data[header->length - 1] & layout->id_mask;
+
+	return NET_NFC_OK;
+}
+
+/* decode a header whose whole record has to be inside of data */
+static net_nfc_error_e __net_nfc_decode_record(const uint8_t *data,
+		uint32_t length, net_nfc_ndef_header_s *header)
+{
+	if (__net_nfc_decode_record_header(data, length, header) != NET_NFC_OK)
+		return NET_NFC_INVALID_FORMAT;
+
+	if ((uint64_t)header->length + header->type_length + header->id_length
+			+ header->payload_length > length)
+		return NET_NFC_INVALID_FORMAT;
+
+	return NET_NFC_OK;
+}
+
+static uint32_t __net_nfc_get_record_body_length(net_nfc_ndef_header_s *header)
+{
+	return header->type_length + header->id_length + header->payload_length;
+}
+
+/* a chunked record starts with CF set and a real TNF, and is followed by
+   chunks of TNF unchanged without type and id. the last one has CF clear */
+static net_nfc_error_e __net_nfc_check_record_sequence(
+		net_nfc_ndef_sequence_s *sequence, net_nfc_ndef_header_s *header)
+{
+	uint8_t tnf = header->flags & NET_NFC_NDEF_RECORD_MASK_TNF;
+
+	if (sequence->done)
+		return NET_NFC_INVALID_FORMAT;
+
+	/* first record has MB field */
+	if (sequence->started == false
+			&& (header->flags & NET_NFC_NDEF_RECORD_MASK_MB) == 0)
+		return NET_NFC_INVALID_FORMAT;
+
+	if (sequence->in_chunk)
+	{
+		if (tnf != NET_NFC_NDEF_TNF_UNCHANGED || header->type_length != 0
+				|| (header->flags & NET_NFC_NDEF_RECORD_MASK_IL))
+			return NET_NFC_INVALID_FORMAT;
+	}
+	else
+	{
+		/* first chunk or a single record should not be tnf unchanged */
+		if (tnf == NET_NFC_NDEF_TNF_UNCHANGED)
+			return NET_NFC_INVALID_FORMAT;
+
+		/* empty record check */
+		if (tnf == NET_NFC_NDEF_TNF_EMPTY && (header->type_length != 0
+					|| header->id_length != 0 || header->payload_length != 0
+					|| (header->flags & NET_NFC_NDEF_RECORD_MASK_CF)))
+			return NET_NFC_INVALID_FORMAT;
+
+		if (tnf == NET_NFC_NDEF_TNF_UNKNOWN && header->type_length != 0)
+			return NET_NFC_INVALID_FORMAT;
+	}
+
+	sequence->started = true;
+
+	if (header->flags & NET_NFC_NDEF_RECORD_MASK_CF)
+	{
+		/* the message can not end in the middle of a chunked record */
+		if (header->flags & NET_NFC_NDEF_RECORD_MASK_ME)
+			return NET_NFC_INVALID_FORMAT;
+
+		sequence->in_chunk = true;
+	}
+	else
+	{
+		sequence->in_chunk = false;
+		sequence->count++;
+	}
+
+	if (header->flags & NET_NFC_NDEF_RECORD_MASK_ME)
+		sequence->done = true;
+
+	return NET_NFC_OK;
+}
+
+static void __net_nfc_set_record_header(ndef_record_s *record,
+		net_nfc_ndef_header_s *header)
+{
+	record->MB = (header->flags & NET_NFC_NDEF_RECORD_MASK_MB) ? 1 : 0;
+	record->ME = (header->flags & NET_NFC_NDEF_RECORD_MASK_ME) ? 1 : 0;
+	record->CF = 0;
+	record->SR = (header->flags & NET_NFC_NDEF_RECORD_MASK_SR) ? 1 : 0;
+	record->IL = (header->flags & NET_NFC_NDEF_RECORD_MASK_IL) ? 1 : 0;
+	record->TNF = header->flags & NET_NFC_NDEF_RECORD_MASK_TNF;
+	record->type_s.length = header->type_length;
+	record->id_s.length = header->id_length;
+	record->payload_s.length = header->payload_length;
+}
+
+/* sum the payload of a chunked record starting at data */
+static net_nfc_error_e __net_nfc_measure_chunks(const uint8_t *data,
+		uint32_t length, uint32_t *payload_length)
+{
+	net_nfc_ndef_header_s header;
+	uint64_t total = 0;
+	uint32_t offset = 0;
+
+	do
+	{
+		if (__net_nfc_decode_record(data + offset, length - offset, &header) != NET_NFC_OK)
+			return NET_NFC_INVALID_FORMAT;
+
+		total += header.payload_length;
+		offset += header.length + __net_nfc_get_record_body_length(&header);
+	}
+	while (header.flags & NET_NFC_NDEF_RECORD_MASK_CF);
+
+	if (total > G_MAXUINT32)
+		return NET_NFC_INVALID_FORMAT;
+
+	*payload_length = total;
+
+	return NET_NFC_OK;
+}
+
+/* parse one record at *current, reassembling chunks into one record.
+   if borrow is true, buffers point into the raw data unless the record is
+   chunked, then the record owns copies of them and borrowed is cleared */
+static net_nfc_error_e __net_nfc_parse_record(ndef_message_s *ndef,
+		net_nfc_ndef_sequence_s *sequence, uint8_t **current, uint8_t *last,
+		ndef_record_s *record, bool borrow)
+{
+	net_nfc_ndef_header_s header;
+	uint8_t *pos = *current;
+	uint32_t payload_length;
+	uint32_t offset;
+
+	if (__net_nfc_decode_record(pos, last - pos, &header) != NET_NFC_OK)
+		return NET_NFC_INVALID_FORMAT;
+
+	if (__net_nfc_check_record_sequence(sequence, &header) != NET_NFC_OK)
+		return NET_NFC_INVALID_FORMAT;
+
+	__net_nfc_set_record_header(record, &header);
+	pos += header.length;
+
+	if (header.flags & NET_NFC_NDEF_RECORD_MASK_CF)
+	{
+		if (__net_nfc_measure_chunks(*current, last - *current,
+					&payload_length) != NET_NFC_OK)
+			return NET_NFC_INVALID_FORMAT;
+
+		record->payload_s.length = payload_length;
+		record->SR = (payload_length < 256) ? 1 : 0;
+
+		borrow = false;
+	}
+
+	record->borrowed = borrow ? 1 : 0;
+
+	if (borrow)
+	{
+		record->type_s.buffer = (record->type_s.length > 0) ? pos : NULL;
+		pos += record->type_s.length;
+
+		record->id_s.buffer = (record->id_s.length > 0) ? pos : NULL;
+		pos += record->id_s.length;
+
+		record->payload_s.buffer = (record->payload_s.length > 0) ? pos : NULL;
+		pos += record->payload_s.length;
+
+		*current = pos;
+
+		return NET_NFC_OK;
+	}
+
+	/* put Type buffer */
+	if (record->type_s.length > 0)
+	{
+		record->type_s.buffer = __net_nfc_util_message_alloc(ndef,
+				record->type_s.length);
+		if (NULL == record->type_s.buffer)
+			return NET_NFC_ALLOC_FAIL;
+
+		memcpy(record->type_s.buffer, pos, record->type_s.length);
+		pos += record->type_s.length;
+	}
+
+	/* put ID buffer */
+	if (record->id_s.length > 0)
+	{
+		record->id_s.buffer = __net_nfc_util_message_alloc(ndef,
+				record->id_s.length);
+		if (NULL == record->id_s.buffer)
+			return NET_NFC_ALLOC_FAIL;
+
+		memcpy(record->id_s.buffer, pos, record->id_s.length);
+		pos += record->id_s.length;
+	}
+
+	/* put Payload buffer */
+	if (record->payload_s.length > 0)
+	{
+		record->payload_s.buffer = __net_nfc_util_message_alloc(ndef,
+				record->payload_s.length);
+		if (NULL == record->payload_s.buffer)
+			return NET_NFC_ALLOC_FAIL;
+	}
+
+	if (header.payload_length > 0)
+		memcpy(record->payload_s.buffer, pos, header.payload_length);
+	pos += header.payload_length;
+	offset = header.payload_length;
+
+	/* append the following chunks, their lengths are checked by
+	   __net_nfc_measure_chunks */
+	while (header.flags & NET_NFC_NDEF_RECORD_MASK_CF)
+	{
+		__net_nfc_decode_record(pos, last - pos, &header);
+
+		if (__net_nfc_check_record_sequence(sequence, &header) != NET_NFC_OK)
+			return NET_NFC_INVALID_FORMAT;
+
+		pos += header.length;
+
+		if (header.payload_length > 0)
+			memcpy(record->payload_s.buffer + offset, pos, header.payload_length);
+		pos += header.payload_length;
+		offset += header.payload_length;
+
+		record->ME = (header.flags & NET_NFC_NDEF_RECORD_MASK_ME) ? 1 : 0;
+	}
+
+	*current = pos;
+
+	return NET_NFC_OK;
+}
 
 net_nfc_error_e net_nfc_util_convert_rawdata_to_ndef_message(
 		data_s *rawdata, ndef_message_s *ndef)
 {
 	uint8_t *last = NULL;
 	uint8_t *current = NULL;
-	uint8_t ndef_header = 0;
 	ndef_record_s *newRec = NULL;
 	ndef_record_s *prevRec = NULL;
+	net_nfc_ndef_sequence_s sequence = { 0, };
 	net_nfc_error_e	result = NET_NFC_OK;
 
 	RETV_IF(NULL == ndef, NET_NFC_NULL_PARAMETER);
 	RETV_IF(NULL == rawdata, NET_NFC_NULL_PARAMETER);
-	RETV_IF(rawdata->length < 0, NET_NFC_INVALID_FORMAT);
+	RETV_IF(NULL == rawdata->buffer && rawdata->length > 0, NET_NFC_NULL_PARAMETER);
 
 	current = rawdata->buffer;
 	last = current + rawdata->length;
 
-	for(ndef->recordCount = 0; current < last; ndef->recordCount++)
-	{
-		ndef_header = *current++;
-
-		if(ndef->recordCount == 0)
-		{
-			/* first record has MB field */
-			if((ndef_header & NET_NFC_NDEF_RECORD_MASK_MB) == 0)
-				return NET_NFC_INVALID_FORMAT;
+	__net_nfc_drop_record_index(ndef);
+	__net_nfc_drop_record_lookup(ndef);
 
-			/* first record should not be a chunked record */
-			if((ndef_header & NET_NFC_NDEF_RECORD_MASK_TNF) == NET_NFC_NDEF_TNF_UNCHANGED)
-				return NET_NFC_INVALID_FORMAT;
-		}
+	ndef->records = NULL;
+	ndef->tail = NULL;
+	ndef->recordCount = 0;
 
-		_net_nfc_util_alloc_mem(newRec, sizeof(ndef_record_s));
+	while (current < last && sequence.done == false)
+	{
+		newRec = __net_nfc_util_record_node_alloc(ndef);
 		if (NULL == newRec)
 		{
 			result = NET_NFC_ALLOC_FAIL;
 			goto error;
 		}
 
-		/* ndef header set */
-		if (ndef_header & NET_NFC_NDEF_RECORD_MASK_MB)
-			newRec->MB = 1;
+		newRec->arena = ndef->arena;
 
-		if (ndef_header & NET_NFC_NDEF_RECORD_MASK_ME)
-			newRec->ME = 1;
+		result = __net_nfc_parse_record(ndef, &sequence, &current, last,
+				newRec, false);
+		if (result != NET_NFC_OK)
+			goto error;
 
-		if (ndef_header & NET_NFC_NDEF_RECORD_MASK_CF)
-			newRec->CF = 1;
+		if (ndef->recordCount == 0)
+			ndef->records = newRec;
+		else
+			prevRec->next = newRec;
 
-		if (ndef_header & NET_NFC_NDEF_RECORD_MASK_SR)
-			newRec->SR = 1;
+		ndef->recordCount++;
+		prevRec = newRec;
+		newRec = NULL;
+	}
 
-		if (ndef_header & NET_NFC_NDEF_RECORD_MASK_IL)
-			newRec->IL = 1;
+	ndef->tail = prevRec;
 
-		newRec->TNF = ndef_header & NET_NFC_NDEF_RECORD_MASK_TNF;
+	if ((current != last) || (sequence.done == false && rawdata->length != 0))
+	{
+		result = NET_NFC_INVALID_FORMAT;
+		goto error;
+	}
 
-		newRec->type_s.length = *current++;
+	return NET_NFC_OK;
 
-		/* SR = 1 -> payload is 1 byte, SR = 0 -> payload is 4 bytes */
-		if(ndef_header & NET_NFC_NDEF_RECORD_MASK_SR)
-		{
-			newRec->payload_s.length = *current++;
-		}
-		else
-		{
-			newRec->payload_s.length = (uint32_t)((*current) << 24);
-			current++;
+error:
 
-			newRec->payload_s.length += (uint32_t)((*current) << 16);
-			current++;
+	NFC_ERR("parser error");
 
-			newRec->payload_s.length += (uint32_t)((*current) << 8);
-			current++;
+	/* records carved from an arena are left to it */
+	if (newRec)
+		net_nfc_util_free_record(newRec);
 
-			newRec->payload_s.length += (uint32_t)((*current));
-			current++;
-		}
+	prevRec = ndef->records;
 
-		/* ID length check */
-		if(ndef_header & NET_NFC_NDEF_RECORD_MASK_IL)
-			newRec->id_s.length = *current++;
-		else
-			newRec->id_s.length = 0;
+	while(prevRec)
+	{
+		ndef_record_s *tmpRec = NULL;
 
-		/* to do : chunked record */
+		tmpRec = prevRec->next;
+		net_nfc_util_free_record(prevRec);
+		prevRec = tmpRec;
+	}
 
-		/* empty record check */
-		if((ndef_header & NET_NFC_NDEF_RECORD_MASK_TNF) == NET_NFC_NDEF_TNF_EMPTY)
+	ndef->records = NULL;
+	ndef->tail = NULL;
+	ndef->recordCount = 0;
+
+	return (result == NET_NFC_ALLOC_FAIL) ? result : NET_NFC_INVALID_FORMAT;
+}
+
+static net_nfc_error_e __net_nfc_count_records(data_s *rawdata, uint32_t *count)
+{
+	uint8_t *current = rawdata->buffer;
+	uint8_t *last = current + rawdata->length;
+	net_nfc_ndef_sequence_s sequence = { 0, };
+	net_nfc_ndef_header_s header;
+
+	while (current < last && sequence.done == false)
+	{
+		if (__net_nfc_decode_record(current, last - current, &header) != NET_NFC_OK)
+			return NET_NFC_INVALID_FORMAT;
+
+		if (__net_nfc_check_record_sequence(&sequence, &header) != NET_NFC_OK)
+			return NET_NFC_INVALID_FORMAT;
+
+		current += header.length + __net_nfc_get_record_body_length(&header);
+	}
+
+	if ((current != last) || (sequence.done == false && rawdata->length != 0))
+		return NET_NFC_INVALID_FORMAT;
+
+	*count = sequence.count;
+
+	return NET_NFC_OK;
+}
+
+net_nfc_error_e net_nfc_util_convert_rawdata_to_ndef_message_view(
+		data_s *rawdata, ndef_message_s *ndef, ndef_record_s *records,
+		uint32_t max_records)
+{
+	uint8_t *last = NULL;
+	uint8_t *current = NULL;
+	uint32_t count = 0;
+	uint32_t idx;
+	net_nfc_ndef_sequence_s sequence = { 0, };
+	net_nfc_error_e result;
+
+	RETV_IF(NULL == ndef, NET_NFC_NULL_PARAMETER);
+	RETV_IF(NULL == rawdata, NET_NFC_NULL_PARAMETER);
+	RETV_IF(NULL == rawdata->buffer && rawdata->length > 0, NET_NFC_NULL_PARAMETER);
+
+	result = __net_nfc_count_records(rawdata, &count);
+	if (result != NET_NFC_OK)
+	{
+		NFC_ERR("parser error");
+		return result;
+	}
+
+	if (records == NULL)
+	{
+		if (count > 0)
 		{
-			if(newRec->type_s.length != 0 || newRec->id_s.length != 0
-				|| newRec->payload_s.length != 0)
-			{
-				result = NET_NFC_INVALID_FORMAT;
-				goto error;
-			}
+			if (ndef->pooled && count <= NET_NFC_NDEF_POOL_BLOCK_RECORDS)
+				ndef->record_block = __net_nfc_ndef_pool_take_block();
+			else
+				_net_nfc_util_alloc_mem(ndef->record_block, count * sizeof(ndef_record_s));
+
+			if (NULL == ndef->record_block)
+				return NET_NFC_ALLOC_FAIL;
 		}
 
-		if((ndef_header & NET_NFC_NDEF_RECORD_MASK_TNF) == NET_NFC_NDEF_TNF_UNKNOWN)
+		records = ndef->record_block;
+	}
+	else if (count > max_records)
+	{
+		return NET_NFC_BUFFER_TOO_SMALL;
+	}
+	else
+	{
+		memset(records, 0, count * sizeof(ndef_record_s));
+	}
+
+	ndef->is_view = true;
+	ndef->records = (count > 0) ? records : NULL;
+	ndef->tail = (count > 0) ? &records[count - 1] : NULL;
+	ndef->recordCount = count;
+
+	current = rawdata->buffer;
+	last = current + rawdata->length;
+
+	/* records are linked first, so that release can find owned buffers */
+	for (idx = 0; idx < count; idx++)
+	{
+		records[idx].borrowed = 1;
+		records[idx].next = (idx + 1 < count) ? &records[idx + 1] : NULL;
+	}
+
+	/* the sequence is already checked by __net_nfc_count_records */
+	for (idx = 0; idx < count; idx++)
+	{
+		result = __net_nfc_parse_record(ndef, &sequence, &current, last,
+				&records[idx], true);
+		if (result != NET_NFC_OK)
+			goto error;
+	}
+
+	return NET_NFC_OK;
+
+error :
+	NFC_ERR("parser error");
+
+	net_nfc_util_release_ndef_message_view(ndef);
+
+	return result;
+}
+
+void net_nfc_util_release_ndef_message_view(ndef_message_s *ndef)
+{
+	ndef_record_s *current;
+
+	RET_IF(NULL == ndef);
+
+	if (false == ndef->is_view)
+		return;
+
+	/* records which do not borrow the rawdata own their buffers */
+	for (current = ndef->records; current != NULL; current = current->next)
+		net_nfc_util_release_record_buffers(current);
+
+	if (ndef->pooled && ndef->record_block != NULL
+			&& ndef->recordCount <= NET_NFC_NDEF_POOL_BLOCK_RECORDS)
+	{
+		__net_nfc_ndef_pool_put_block(ndef->record_block);
+		ndef->record_block = NULL;
+	}
+	else
+	{
+		_net_nfc_util_free_mem(ndef->record_block);
+	}
+
+	__net_nfc_drop_record_index(ndef);
+	__net_nfc_drop_record_lookup(ndef);
+
+	ndef->records = NULL;
+	ndef->tail = NULL;
+	ndef->recordCount = 0;
+	ndef->is_view = false;
+}
+
+struct _net_nfc_util_ndef_parser_s
+{
+	net_nfc_util_ndef_parser_cb callback;
+	void *user_data;
+	net_nfc_ndef_sequence_s sequence;
+	net_nfc_error_e error;
+	uint8_t header_buffer[NET_NFC_NDEF_HEADER_MAX_LENGTH];
+	uint32_t header_offset; /* 0 while the body of a record is received */
+	net_nfc_ndef_header_s header;
+	uint32_t body_offset;
+	ndef_record_s *record; /* record being received, it spans chunks */
+	uint32_t payload_size; /* allocated bytes of record->payload_s */
+	bool in_body;
+};
+
+static net_nfc_error_e __net_nfc_ndef_parser_start_record(
+		net_nfc_util_ndef_parser_s *parser)
+{
+	ndef_record_s *record = NULL;
+
+	if (__net_nfc_check_record_sequence(&parser->sequence, &parser->header)
+			!= NET_NFC_OK)
+		return NET_NFC_INVALID_FORMAT;
+
+	/* a following chunk only adds payload */
+	if (parser->record != NULL)
+		return NET_NFC_OK;
+
+	_net_nfc_util_alloc_mem(record, sizeof(ndef_record_s));
+	if (NULL == record)
+		return NET_NFC_ALLOC_FAIL;
+
+	__net_nfc_set_record_header(record, &parser->header);
+	record->payload_s.length = 0;
+
+	if (record->type_s.length > 0)
+	{
+		_net_nfc_util_alloc_mem(record->type_s.buffer, record->type_s.length);
+		if (NULL == record->type_s.buffer)
+			goto ERROR;
+	}
+
+	if (record->id_s.length > 0)
+	{
+		_net_nfc_util_alloc_mem(record->id_s.buffer, record->id_s.length);
+		if (NULL == record->id_s.buffer)
+			goto ERROR;
+	}
+
+	parser->record = record;
+	parser->payload_size = 0;
+
+	return NET_NFC_OK;
+
+ERROR :
+	net_nfc_util_free_record(record);
+
+	return NET_NFC_ALLOC_FAIL;
+}
+
+/* payload grows with the data really received, not with the length
+   announced in the header */
+static net_nfc_error_e __net_nfc_ndef_parser_reserve(
+		net_nfc_util_ndef_parser_s *parser, uint32_t length, uint32_t limit)
+{
+	ndef_record_s *record = parser->record;
+	uint32_t size;
+
+	if (record->payload_s.length + length <= parser->payload_size)
+		return NET_NFC_OK;
+
+	size = MAX(record->payload_s.length + length, parser->payload_size * 2);
+	size = MIN(size, limit);
+
+	record->payload_s.buffer = g_realloc(record->payload_s.buffer, size);
+	if (NULL == record->payload_s.buffer)
+		return NET_NFC_ALLOC_FAIL;
+
+	parser->payload_size = size;
+
+	return NET_NFC_OK;
+}
+
+static uint32_t __net_nfc_ndef_parser_take_body(net_nfc_util_ndef_parser_s *parser,
+		const uint8_t *data, uint32_t length)
+{
+	net_nfc_ndef_header_s *header = &parser->header;
+	ndef_record_s *record = parser->record;
+	uint32_t offset = parser->body_offset;
+	uint32_t take;
+
+	if (offset < header->type_length)
+	{
+		take = MIN(length, header->type_length - offset);
+		memcpy(record->type_s.buffer + offset, data, take);
+	}
+	else if (offset < header->type_length + header->id_length)
+	{
+		offset -= header->type_length;
+		take = MIN(length, header->id_length - offset);
+		memcpy(record->id_s.buffer + offset, data, take);
+	}
+	else
+	{
+		offset -= header->type_length + header->id_length;
+		take = MIN(length, header->payload_length - offset);
+
+		if (__net_nfc_ndef_parser_reserve(parser, take, record->payload_s.length
+					+ header->payload_length - offset) != NET_NFC_OK)
+			return 0;
+
+		memcpy(record->payload_s.buffer + record->payload_s.length, data, take);
+		record->payload_s.length += take;
+	}
+
+	parser->body_offset += take;
+
+	return take;
+}
+
+static void __net_nfc_ndef_parser_end_chunk(net_nfc_util_ndef_parser_s *parser)
+{
+	ndef_record_s *record = parser->record;
+
+	parser->in_body = false;
+	parser->header_offset = 0;
+
+	if (parser->header.flags & NET_NFC_NDEF_RECORD_MASK_CF)
+		return;
+
+	/* the last chunk of a chunked record decides ME and the total its SR */
+	if ((parser->header.flags & NET_NFC_NDEF_RECORD_MASK_TNF) == NET_NFC_NDEF_TNF_UNCHANGED)
+	{
+		record->ME = (parser->header.flags & NET_NFC_NDEF_RECORD_MASK_ME) ? 1 : 0;
+		record->SR = (record->payload_s.length < 256) ? 1 : 0;
+	}
+
+	parser->record = NULL;
+
+	if (parser->callback != NULL)
+		parser->callback(record, parser->user_data);
+	else
+		net_nfc_util_free_record(record);
+}
+
+net_nfc_util_ndef_parser_s *net_nfc_util_ndef_parser_create(
+		net_nfc_util_ndef_parser_cb callback, void *user_data)
+{
+	net_nfc_util_ndef_parser_s *parser = NULL;
+
+	_net_nfc_util_alloc_mem(parser, sizeof(net_nfc_util_ndef_parser_s));
+	if (NULL == parser)
+		return NULL;
+
+	parser->callback = callback;
+	parser->user_data = user_data;
+	parser->error = NET_NFC_OK;
+
+	return parser;
+}
+
+net_nfc_error_e net_nfc_util_ndef_parser_feed(net_nfc_util_ndef_parser_s *parser,
+		const uint8_t *data, uint32_t length)
+{
+	net_nfc_error_e result;
+	uint32_t take;
+
+	RETV_IF(NULL == parser, NET_NFC_NULL_PARAMETER);
+	RETV_IF(NULL == data && length > 0, NET_NFC_NULL_PARAMETER);
+
+	if (parser->error != NET_NFC_OK)
+		return parser->error;
+
+	while (length > 0)
+	{
+		if (parser->in_body == false)
 		{
-			if(newRec->type_s.length != 0)
+			/* nothing may follow the last record */
+			if (parser->sequence.done)
 			{
 				result = NET_NFC_INVALID_FORMAT;
-				goto error;
+				goto ERROR;
 			}
-		}
 
-		/* put Type buffer */
-		if(newRec->type_s.length > 0)
-		{
-			_net_nfc_util_alloc_mem(newRec->type_s.buffer, newRec->type_s.length);
-			if (NULL == newRec->type_s.buffer)
-			{
-				result = NET_NFC_ALLOC_FAIL;
-				goto error;
-			}
+			parser->header_buffer[parser->header_offset++] = *data++;
+			length--;
+
+			if (__net_nfc_decode_record_header(parser->header_buffer,
+						parser->header_offset, &parser->header) != NET_NFC_OK)
+				continue;
+
+			result = __net_nfc_ndef_parser_start_record(parser);
+			if (result != NET_NFC_OK)
+				goto ERROR;
 
-			memcpy(newRec->type_s.buffer, current, newRec->type_s.length);
-			current += newRec->type_s.length;
+			parser->in_body = true;
+			parser->body_offset = 0;
 		}
 		else
 		{
-			newRec->type_s.buffer = NULL;
-		}
-
-		/* put ID buffer */
-		if(newRec->id_s.length > 0)
-		{
-			_net_nfc_util_alloc_mem(newRec->id_s.buffer, newRec->id_s.length);
-			if (NULL == newRec->id_s.buffer)
+			take = __net_nfc_ndef_parser_take_body(parser, data, length);
+			if (take == 0)
 			{
 				result = NET_NFC_ALLOC_FAIL;
-				goto error;
+				goto ERROR;
 			}
 
-			memcpy(newRec->id_s.buffer, current, newRec->id_s.length);
-			current += newRec->id_s.length;
-		}
-		else
-		{
-			newRec->id_s.buffer = NULL;
+			data += take;
+			length -= take;
 		}
 
-		/* put Payload buffer */
-		if(newRec->payload_s.length > 0)
-		{
-			_net_nfc_util_alloc_mem(newRec->payload_s.buffer, newRec->payload_s.length);
-			if (newRec->payload_s.buffer == NULL)
-			{
-				result = NET_NFC_ALLOC_FAIL;
-				goto error;
-			}
+		if (parser->body_offset == __net_nfc_get_record_body_length(&parser->header))
+			__net_nfc_ndef_parser_end_chunk(parser);
+	}
+
+	return NET_NFC_OK;
+
+ERROR :
+	NFC_ERR("parser error [%d]", result);
 
-			memcpy(newRec->payload_s.buffer, current, newRec->payload_s.length);
-			current += newRec->payload_s.length;
+	parser->error = result;
+
+	return result;
+}
+
+bool net_nfc_util_ndef_parser_is_complete(net_nfc_util_ndef_parser_s *parser)
+{
+	RETV_IF(NULL == parser, false);
+
+	return (parser->error == NET_NFC_OK && parser->sequence.done
+			&& parser->in_body == false);
+}
+
+void net_nfc_util_ndef_parser_destroy(net_nfc_util_ndef_parser_s *parser)
+{
+	RET_IF(NULL == parser);
+
+	if (parser->record != NULL)
+		net_nfc_util_free_record(parser->record);
+
+	_net_nfc_util_free_mem(parser);
+}
+
+static uint8_t *__net_nfc_encode_record_head(ndef_record_s *record, uint8_t *current)
+{
+	uint8_t ndef_header = 0x00;
+
+	if(record->MB)
+		ndef_header |= NET_NFC_NDEF_RECORD_MASK_MB;
+	if(record->ME)
+		ndef_header |= NET_NFC_NDEF_RECORD_MASK_ME;
+	if(record->CF)
+		ndef_header |= NET_NFC_NDEF_RECORD_MASK_CF;
+	if(record->SR)
+		ndef_header |= NET_NFC_NDEF_RECORD_MASK_SR;
+	if(record->IL)
+		ndef_header |= NET_NFC_NDEF_RECORD_MASK_IL;
+
+	ndef_header |= record->TNF;
+
+	*current++ = ndef_header;
+
+	/* check empty record */
+	if(record->TNF == NET_NFC_NDEF_TNF_EMPTY)
+	{
+		/* set type length to zero */
+		*current++ = 0x00;
+
+		/* set payload length to zero, as long as net_nfc_util_get_record_length counts */
+		if(record->SR)
+		{
+			*current++ = 0x00;
 		}
 		else
 		{
-			newRec->payload_s.buffer = NULL;
+			memset(current, 0, 4);
+			current += 4;
 		}
 
-		if (ndef->recordCount == 0)
-			ndef->records = newRec;
-		else
-			prevRec->next = newRec;
-
-		prevRec = newRec;
-		newRec = NULL;
-
-		if(ndef_header & NET_NFC_NDEF_RECORD_MASK_ME)
+		/* set ID length to zero */
+		if(record->IL)
 		{
-			break;
+			*current++ = 0x00;
 		}
-	}
 
-	ndef->recordCount++;
+		return current;
+	}
 
-	if((current != last) || (((ndef_header & NET_NFC_NDEF_RECORD_MASK_ME) == 0) && (rawdata->length != 0)))
+	/* set type length */
+	if(record->TNF == NET_NFC_NDEF_TNF_UNKNOWN || record->TNF == NET_NFC_NDEF_TNF_UNCHANGED)
 	{
-		result = NET_NFC_INVALID_FORMAT;
-		goto error;
+		*current++ = 0x00;
 	}
-
-	return NET_NFC_OK;
-
-error:
-
-	NFC_ERR("parser error");
-
-	if (newRec)
+	else
 	{
-		_net_nfc_util_free_mem(newRec->type_s.buffer);
-		_net_nfc_util_free_mem(newRec->id_s.buffer);
-		_net_nfc_util_free_mem(newRec->payload_s.buffer);
-		_net_nfc_util_free_mem(newRec);
+		*current++ = record->type_s.length;
 	}
 
-	prevRec = ndef->records;
+	/* set payload length */
+	if(record->SR)
+	{
+		*current++ = (uint8_t)(record->payload_s.length & 0x000000FF);
+	}
+	else
+	{
+		*current++ = (uint8_t)((record->payload_s.length & 0xFF000000) >> 24);
+		*current++ = (uint8_t)((record->payload_s.length & 0x00FF0000) >> 16);
+		*current++ = (uint8_t)((record->payload_s.length & 0x0000FF00) >> 8);
+		*current++ = (uint8_t)(record->payload_s.length & 0x000000FF) ;
+	}
 
-	while(prevRec)
+	/* set ID length */
+	if(record->IL)
 	{
-		ndef_record_s *tmpRec = NULL;
+		*current++ = record->id_s.length;
+	}
 
-		_net_nfc_util_free_mem(prevRec->type_s.buffer);
-		_net_nfc_util_free_mem(prevRec->id_s.buffer);
-		_net_nfc_util_free_mem(prevRec->payload_s.buffer);
+	/* set type buffer */
+	if((record->TNF != NET_NFC_NDEF_TNF_UNKNOWN) && (record->TNF != NET_NFC_NDEF_TNF_UNCHANGED)
+			&& record->type_s.length > 0)
+	{
+		memcpy(current, record->type_s.buffer, record->type_s.length);
+		current += record->type_s.length;
+	}
 
-		tmpRec = prevRec->next;
-		_net_nfc_util_free_mem(prevRec);
-		prevRec = tmpRec;
+	/* set ID buffer */
+	if(record->IL && record->id_s.length > 0)
+	{
+		memcpy(current, record->id_s.buffer, record->id_s.length);
+		current += record->id_s.length;
 	}
 
-	ndef->records = NULL;
+	return current;
+}
 
-	return result;
+static uint32_t __net_nfc_get_record_payload_length(ndef_record_s *record)
+{
+	return (record->TNF == NET_NFC_NDEF_TNF_EMPTY) ? 0 : record->payload_s.length;
 }
 
 net_nfc_error_e net_nfc_util_convert_ndef_message_to_rawdata(ndef_message_s *ndef, data_s *rawdata)
 {
 	ndef_record_s *record = NULL;
 	uint8_t *current = NULL;
-	uint8_t ndef_header;
+	uint32_t payload_length;
 
 	if (rawdata == NULL || ndef == NULL)
 		return NET_NFC_NULL_PARAMETER;
 
+	/* record lengths are cached, so this does not walk the fields again */
+	if (rawdata->length < net_nfc_util_get_ndef_message_length(ndef))
+		return NET_NFC_BUFFER_TOO_SMALL;
+
 	record = ndef->records;
 	current = rawdata->buffer;
 
 	while(record)
 	{
-		ndef_header = 0x00;
+		current = __net_nfc_encode_record_head(record, current);
 
-		if(record->MB)
-			ndef_header |= NET_NFC_NDEF_RECORD_MASK_MB;
-		if(record->ME)
-			ndef_header |= NET_NFC_NDEF_RECORD_MASK_ME;
-		if(record->CF)
-			ndef_header |= NET_NFC_NDEF_RECORD_MASK_CF;
-		if(record->SR)
-			ndef_header |= NET_NFC_NDEF_RECORD_MASK_SR;
-		if(record->IL)
-			ndef_header |= NET_NFC_NDEF_RECORD_MASK_IL;
+		/* set payload buffer */
+		payload_length = __net_nfc_get_record_payload_length(record);
+		if (payload_length > 0)
+		{
+			memcpy(current, record->payload_s.buffer, payload_length);
+			current += payload_length;
+		}
 
-		ndef_header |= record->TNF;
+		record = record->next;
+	}
+
+	return NET_NFC_OK;
+}
 
-		*current++ = ndef_header;
+net_nfc_error_e net_nfc_util_serialize_ndef_message(ndef_message_s *ndef,
+		uint32_t headroom, data_s *rawdata)
+{
+	net_nfc_error_e result;
+	uint32_t length;
+	data_s message;
 
-		/* check empty record */
-		if(record->TNF == NET_NFC_NDEF_TNF_EMPTY)
-		{
-			/* set type length to zero */
-			*current++ = 0x00;
+	RETV_IF(NULL == ndef, NET_NFC_NULL_PARAMETER);
+	RETV_IF(NULL == rawdata, NET_NFC_NULL_PARAMETER);
+
+	length = net_nfc_util_get_ndef_message_length(ndef);
+	if (headroom + length == 0)
+		return NET_NFC_INVALID_PARAM;
+
+	if (net_nfc_util_alloc_data(rawdata, headroom + length) == false)
+		return NET_NFC_ALLOC_FAIL;
+
+	message.buffer = rawdata->buffer + headroom;
+	message.length = length;
+
+	result = net_nfc_util_convert_ndef_message_to_rawdata(ndef, &message);
+	if (result != NET_NFC_OK)
+		net_nfc_util_free_data(rawdata);
+
+	return result;
+}
+
+net_nfc_error_e net_nfc_util_convert_ndef_message_to_iovec(ndef_message_s *ndef,
+		data_s *headers, struct iovec *iov, uint32_t *iov_count)
+{
+	ndef_record_s *record;
+	uint32_t length = 0;
+	uint32_t count = 0;
+	uint32_t payload_length;
+	uint8_t *current;
+	uint8_t *head;
+
+	RETV_IF(NULL == ndef, NET_NFC_NULL_PARAMETER);
+	RETV_IF(NULL == headers, NET_NFC_NULL_PARAMETER);
+	RETV_IF(NULL == iov, NET_NFC_NULL_PARAMETER);
+	RETV_IF(NULL == iov_count, NET_NFC_NULL_PARAMETER);
 
-			/* set payload length to zero */
-			*current++ = 0x00;
+	if (*iov_count < ndef->recordCount * 2)
+		return NET_NFC_BUFFER_TOO_SMALL;
 
-			/* set ID length to zero */
-			if(record->IL)
-			{
-				*current++ = 0x00;
-			}
+	for (record = ndef->records; record != NULL; record = record->next)
+	{
+		length += net_nfc_util_get_record_length(record)
+				- __net_nfc_get_record_payload_length(record);
+	}
 
-			record = record->next;
+	if (length == 0)
+	{
+		*iov_count = 0;
+		return NET_NFC_OK;
+	}
 
-			continue;
-		}
+	if (net_nfc_util_alloc_data(headers, length) == false)
+		return NET_NFC_ALLOC_FAIL;
 
-		/* set type length */
-		if(record->TNF == NET_NFC_NDEF_TNF_UNKNOWN || record->TNF == NET_NFC_NDEF_TNF_UNCHANGED)
-		{
-			*current++ = 0x00;
-		}
-		else
-		{
-			*current++ = record->type_s.length;
-		}
+	current = headers->buffer;
 
-		/* set payload length */
-		if(record->SR)
+	for (record = ndef->records; record != NULL; record = record->next)
+	{
+		head = current;
+		current = __net_nfc_encode_record_head(record, current);
+
+		/* adjacent headers are merged when there is no payload in between */
+		if (count > 0 && (uint8_t *)iov[count - 1].iov_base
+				+ iov[count - 1].iov_len == head)
 		{
-			*current++ = (uint8_t)(record->payload_s.length & 0x000000FF);
+			iov[count - 1].iov_len += current - head;
 		}
 		else
 		{
-			*current++ = (uint8_t)((record->payload_s.length & 0xFF000000) >> 24);
-			*current++ = (uint8_t)((record->payload_s.length & 0x00FF0000) >> 16);
-			*current++ = (uint8_t)((record->payload_s.length & 0x0000FF00) >> 8);
-			*current++ = (uint8_t)(record->payload_s.length & 0x000000FF) ;
-		}
-
-		/* set ID length */
-		if(record->IL)
-		{
-			*current++ = record->id_s.length;
+			iov[count].iov_base = head;
+			iov[count].iov_len = current - head;
+			count++;
 		}
 
-		/* set type buffer */
-		if((record->TNF != NET_NFC_NDEF_TNF_UNKNOWN) && (record->TNF != NET_NFC_NDEF_TNF_UNCHANGED))
+		payload_length = __net_nfc_get_record_payload_length(record);
+		if (payload_length > 0)
 		{
-			memcpy(current, record->type_s.buffer, record->type_s.length);
-			current += record->type_s.length;
+			iov[count].iov_base = record->payload_s.buffer;
+			iov[count].iov_len = payload_length;
+			count++;
 		}
-
-		/* set ID buffer */
-		memcpy(current, record->id_s.buffer, record->id_s.length);
-		current += record->id_s.length;
-
-		/* set payload buffer */
-		memcpy(current, record->payload_s.buffer, record->payload_s.length);
-		current += record->payload_s.length;
-
-		record = record->next;
 	}
 
+	*iov_count = count;
+
 	return NET_NFC_OK;
 }
 
 net_nfc_error_e net_nfc_util_append_record(ndef_message_s *msg, ndef_record_s *record)
 {
+	ndef_record_s *prev_tail;
+
 	if (msg == NULL || record == NULL)
 		return NET_NFC_NULL_PARAMETER;
 
-	if (msg->recordCount == 0)
-	{
-		// set short message and append
-		record->MB = 1;
-		record->ME = 1;
-		record->next = NULL;
+	RETV_IF(msg->is_view, NET_NFC_NOT_ALLOWED_OPERATION);
 
-		msg->records = record;
+	prev_tail = (msg->recordCount > 0) ? msg->tail : NULL;
+	if (msg->recordCount > 0 && NULL == prev_tail)
+		return NET_NFC_INVALID_FORMAT;
 
-		msg->recordCount++;
+	record->next = NULL;
+	record->MB = 0;
+	record->ME = 0;
 
-		NFC_DBG("record is added to NDEF message :: count [%d]", msg->recordCount);
-	}
+	if (NULL == prev_tail)
+		msg->records = record;
 	else
-	{
-		ndef_record_s *current = NULL;
-		ndef_record_s *prev = NULL;
-
-		// set flag :: this record is FIRST
-		current = msg->records;
-
-		if (current != NULL)
-		{
-			// first node
-			current->MB = 1;
-			current->ME = 0;
+		prev_tail->next = record;
 
-			prev = current;
+	if (msg->record_index != NULL)
+		g_ptr_array_add(msg->record_index, record);
 
-			// second node
-			current = current->next;
+	/* a later record never shadows an earlier one with the same key */
+	__net_nfc_lookup_add_record(msg, record);
 
-			while (current != NULL)
-			{
-				current->MB = 0;
-				current->ME = 0;
-				prev = current;
-				current = current->next;
-			}
-
-			// set flag :: this record is END
-			record->MB = 0;
-			record->ME = 1;
-
-			prev->next = record;
-			msg->recordCount++;
-		}
+	msg->tail = record;
+	msg->recordCount++;
 
-	}
+	NFC_DBG("record is added to NDEF message :: count [%d]", msg->recordCount);
 
-	return NET_NFC_OK;
+	/* only the previous tail loses its ME flag */
+	return __net_nfc_repair_record_flags(msg, prev_tail);
 }
 
 uint32_t net_nfc_util_get_ndef_message_length(ndef_message_s *message)
@@ -484,6 +1340,18 @@ net_nfc_error_e net_nfc_util_free_ndef_message(ndef_message_s *msg)
 	if (msg == NULL)
 		return NET_NFC_NULL_PARAMETER;
 
+	if (msg->is_view)
+	{
+		net_nfc_util_release_ndef_message_view(msg);
+
+		if (msg->pooled)
+			__net_nfc_ndef_pool_put_message(msg);
+		else
+			_net_nfc_util_free_mem(msg);
+
+		return NET_NFC_OK;
+	}
+
 	current = msg->records;
 
 	for (idx = 0; idx < msg->recordCount; idx++)
@@ -494,10 +1362,34 @@ net_nfc_error_e net_nfc_util_free_ndef_message(ndef_message_s *msg)
 		prev = current;
 		current = current->next;
 
-		net_nfc_util_free_record(prev);
+		/* records carved from the arena are skipped here */
+		if (msg->pooled && NULL == prev->arena)
+		{
+			net_nfc_util_release_record_buffers(prev);
+			__net_nfc_ndef_pool_put_record(prev);
+		}
+		else
+		{
+			net_nfc_util_free_record(prev);
+		}
+	}
+
+	__net_nfc_drop_record_index(msg);
+	__net_nfc_drop_record_lookup(msg);
+
+	if (msg->arena != NULL)
+	{
+		/* msg itself lives in the arena, an inner message does not own it */
+		if (msg->owns_arena)
+			net_nfc_util_arena_destroy(msg->arena);
+
+		return NET_NFC_OK;
 	}
 
-	_net_nfc_util_free_mem(msg);
+	if (msg->pooled)
+		__net_nfc_ndef_pool_put_message(msg);
+	else
+		_net_nfc_util_free_mem(msg);
 
 	return NET_NFC_OK;
 }
@@ -516,11 +1408,84 @@ net_nfc_error_e net_nfc_util_create_ndef_message(ndef_message_s **ndef_message)
 	return NET_NFC_OK;
 }
 
+net_nfc_error_e net_nfc_util_create_pooled_ndef_message(
+		ndef_message_s **ndef_message)
+{
+	net_nfc_ndef_pool_s *pool;
+
+	RETV_IF(NULL == ndef_message, NET_NFC_NULL_PARAMETER);
+
+	pool = __net_nfc_ndef_pool_get();
+	if (NULL == pool)
+		*ndef_message = __net_nfc_ndef_pool_take(NULL, NULL, sizeof(ndef_message_s));
+	else
+		*ndef_message = __net_nfc_ndef_pool_take((void **)pool->messages,
+				&pool->message_count, sizeof(ndef_message_s));
+
+	if (NULL == *ndef_message)
+		return NET_NFC_ALLOC_FAIL;
+
+	(*ndef_message)->pooled = true;
+
+	return NET_NFC_OK;
+}
+
+void net_nfc_util_get_ndef_pool_stats(net_nfc_util_ndef_pool_stats_s *stats)
+{
+	RET_IF(NULL == stats);
+
+	stats->hits = g_atomic_int_get(&ndef_pool_hits);
+	stats->misses = g_atomic_int_get(&ndef_pool_misses);
+	stats->high_water = g_atomic_int_get(&ndef_pool_high_water);
+}
+
+net_nfc_error_e net_nfc_util_create_ndef_message_with_arena(
+		ndef_message_s **ndef_message, uint32_t arena_size)
+{
+	net_nfc_util_arena_s *arena;
+
+	RETV_IF(NULL == ndef_message, NET_NFC_NULL_PARAMETER);
+
+	arena = net_nfc_util_arena_create(arena_size);
+	if (NULL == arena)
+		return NET_NFC_ALLOC_FAIL;
+
+	*ndef_message = net_nfc_util_arena_alloc(arena, sizeof(ndef_message_s));
+	if (NULL == *ndef_message)
+	{
+		net_nfc_util_arena_destroy(arena);
+		return NET_NFC_ALLOC_FAIL;
+	}
+
+	(*ndef_message)->arena = arena;
+	(*ndef_message)->owns_arena = true;
+
+	return NET_NFC_OK;
+}
+
+net_nfc_error_e net_nfc_util_create_inner_ndef_message(
+		ndef_message_s *parent, ndef_message_s **ndef_message)
+{
+	RETV_IF(NULL == parent, NET_NFC_NULL_PARAMETER);
+	RETV_IF(NULL == ndef_message, NET_NFC_NULL_PARAMETER);
+
+	if (NULL == parent->arena)
+		return net_nfc_util_create_ndef_message(ndef_message);
+
+	*ndef_message = net_nfc_util_arena_alloc(parent->arena, sizeof(ndef_message_s));
+	if (NULL == *ndef_message)
+		return NET_NFC_ALLOC_FAIL;
+
+	(*ndef_message)->arena = parent->arena;
+	(*ndef_message)->owns_arena = false;
+
+	return NET_NFC_OK;
+}
+
 net_nfc_error_e net_nfc_util_remove_record_by_index(ndef_message_s *ndef_message, int index)
 {
-	int current_idx = 0;
+	GPtrArray *record_index;
 	ndef_record_s *prev;
-	ndef_record_s *next;
 	ndef_record_s *current;
 
 	if (ndef_message == NULL)
@@ -528,47 +1493,45 @@ net_nfc_error_e net_nfc_util_remove_record_by_index(ndef_message_s *ndef_message
 		return NET_NFC_NULL_PARAMETER;
 	}
 
+	if (ndef_message->is_view)
+	{
+		return NET_NFC_NOT_ALLOWED_OPERATION;
+	}
+
 	if (index < 0 || index >= ndef_message->recordCount)
 	{
 		return NET_NFC_OUT_OF_BOUND;
 	}
 
-	if (index == 0)
+	record_index = __net_nfc_get_record_index(ndef_message);
+	if (record_index == NULL)
 	{
-		current = ndef_message->records;
-		next = ndef_message->records->next;
-		ndef_message->records = next;
+		return NET_NFC_INVALID_FORMAT;
 	}
+
+	current = g_ptr_array_index(record_index, index);
+	prev = (index > 0) ? g_ptr_array_index(record_index, index - 1) : NULL;
+
+	if (prev == NULL)
+		ndef_message->records = current->next;
 	else
-	{
-		prev = ndef_message->records;
-		for (; current_idx < index - 1; current_idx++)
-		{
-			prev = prev->next;
-			if (prev == NULL)
-			{
-				return NET_NFC_INVALID_FORMAT;
-			}
-		}
-		current = prev->next;
-		if (current == NULL)
-		{
-			return NET_NFC_INVALID_FORMAT;
-		}
-		next = current->next;
-		prev->next = next;
-	}
+		prev->next = current->next;
+
+	if (ndef_message->tail == current)
+		ndef_message->tail = prev;
+
+	g_ptr_array_remove_index(record_index, index);
+	__net_nfc_drop_record_lookup(ndef_message);
 
 	net_nfc_util_free_record(current);
 	(ndef_message->recordCount)--;
 
-	return __net_nfc_repair_record_flags(ndef_message);
+	return __net_nfc_repair_record_flags(ndef_message, NULL);
 }
 
 net_nfc_error_e net_nfc_util_get_record_by_index(ndef_message_s *ndef_message, int index, ndef_record_s **record)
 {
-	ndef_record_s *current;
-	int idx = 0;
+	GPtrArray *record_index;
 
 	if (ndef_message == NULL || record == NULL)
 	{
@@ -580,58 +1543,215 @@ net_nfc_error_e net_nfc_util_get_record_by_index(ndef_message_s *ndef_message, i
 		return NET_NFC_OUT_OF_BOUND;
 	}
 
-	current = ndef_message->records;
+	/* record nodes of a view are contiguous */
+	if (ndef_message->is_view)
+	{
+		*record = &ndef_message->records[index];
+
+		return NET_NFC_OK;
+	}
 
-	for (; current != NULL && idx < index; idx++)
+	record_index = __net_nfc_get_record_index(ndef_message);
+	if (record_index == NULL)
 	{
-		current = current->next;
+		return NET_NFC_INVALID_FORMAT;
 	}
 
-	*record = current;
+	*record = g_ptr_array_index(record_index, index);
 
 	return NET_NFC_OK;
 }
 
 net_nfc_error_e net_nfc_util_append_record_by_index(ndef_message_s *ndef_message, int index, ndef_record_s *record)
 {
-	int idx = 0;
+	GPtrArray *record_index;
 	ndef_record_s *prev;
-	ndef_record_s *next;
+	ndef_record_s *inner = NULL;
 
 	if (ndef_message == NULL || record == NULL)
 	{
 		return NET_NFC_NULL_PARAMETER;
 	}
 
+	if (ndef_message->is_view)
+	{
+		return NET_NFC_NOT_ALLOWED_OPERATION;
+	}
+
 	if (index < 0 || index > ndef_message->recordCount)
 	{
 		return NET_NFC_OUT_OF_BOUND;
 	}
 
-	prev = ndef_message->records;
+	if (index == ndef_message->recordCount)
+	{
+		return net_nfc_util_append_record(ndef_message, record);
+	}
+
+	record_index = __net_nfc_get_record_index(ndef_message);
+	if (record_index == NULL)
+	{
+		return NET_NFC_INVALID_FORMAT;
+	}
 
 	if (index == 0)
 	{
+		/* the previous head loses its MB flag */
+		inner = ndef_message->records;
+
+		record->next = ndef_message->records;
 		ndef_message->records = record;
-		record->next = prev;
 	}
 	else
 	{
-		for (; idx < index - 1; idx++)
-		{
-			prev = prev->next;
-			if (prev == NULL)
-			{
-				return NET_NFC_INVALID_FORMAT;
-			}
-		}
-		next = prev->next;
+		prev = g_ptr_array_index(record_index, index - 1);
+
+		record->next = prev->next;
 		prev->next = record;
-		record->next = next;
 	}
+
+	g_ptr_array_insert(record_index, index, record);
 	(ndef_message->recordCount)++;
 
-	return __net_nfc_repair_record_flags(ndef_message);
+	__net_nfc_drop_record_lookup(ndef_message);
+
+	record->MB = 0;
+	record->ME = 0;
+
+	return __net_nfc_repair_record_flags(ndef_message, inner);
+}
+
+/* smaller messages are scanned, building the tables costs more */
+#define NET_NFC_NDEF_LOOKUP_MIN_RECORDS	8
+
+typedef struct _net_nfc_ndef_lookup_key_s
+{
+	uint8_t tnf;
+	uint32_t length;
+	const uint8_t *data; /* points into the record */
+} net_nfc_ndef_lookup_key_s;
+
+static guint __net_nfc_lookup_key_hash(gconstpointer key)
+{
+	const net_nfc_ndef_lookup_key_s *lookup_key = key;
+	guint hash = 2166136261u ^ lookup_key->tnf;
+	uint32_t i;
+
+	/* FNV-1a */
+	for (i = 0; i < lookup_key->length; i++)
+	{
+		hash ^= lookup_key->data[i];
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+static gboolean __net_nfc_lookup_key_equal(gconstpointer a, gconstpointer b)
+{
+	const net_nfc_ndef_lookup_key_s *key_a = a;
+	const net_nfc_ndef_lookup_key_s *key_b = b;
+
+	return (key_a->tnf == key_b->tnf && key_a->length == key_b->length
+			&& (key_a->length == 0
+				|| memcmp(key_a->data, key_b->data, key_a->length) == 0));
+}
+
+/* the first record of a key wins, as it does for a linear search */
+static void __net_nfc_lookup_add(GHashTable *table, uint8_t tnf, data_s *data,
+		ndef_record_s *record)
+{
+	net_nfc_ndef_lookup_key_s *key;
+	net_nfc_ndef_lookup_key_s query = { tnf, data->length, data->buffer };
+
+	if (g_hash_table_lookup(table, &query) != NULL)
+		return;
+
+	key = g_new(net_nfc_ndef_lookup_key_s, 1);
+	*key = query;
+
+	g_hash_table_insert(table, key, record);
+}
+
+/* keys of stale tables may point at freed type or id buffers */
+static void __net_nfc_expire_record_lookup(ndef_message_s *ndef_message)
+{
+	uint32_t stamp = net_nfc_util_get_record_stamp();
+
+	if (ndef_message->lookup_stamp != stamp)
+	{
+		__net_nfc_drop_record_lookup(ndef_message);
+		ndef_message->lookup_stamp = stamp;
+	}
+}
+
+static void __net_nfc_lookup_add_record(ndef_message_s *ndef_message,
+		ndef_record_s *record)
+{
+	__net_nfc_expire_record_lookup(ndef_message);
+
+	if (ndef_message->type_lookup != NULL)
+		__net_nfc_lookup_add(ndef_message->type_lookup, record->TNF,
+				&record->type_s, record);
+
+	if (ndef_message->id_lookup != NULL)
+		__net_nfc_lookup_add(ndef_message->id_lookup, 0, &record->id_s, record);
+}
+
+static GHashTable *__net_nfc_build_lookup(ndef_message_s *ndef_message, bool by_id)
+{
+	GHashTable *table;
+	ndef_record_s *current;
+
+	table = g_hash_table_new_full(__net_nfc_lookup_key_hash,
+			__net_nfc_lookup_key_equal, g_free, NULL);
+
+	for (current = ndef_message->records; current != NULL; current = current->next)
+	{
+		if (by_id)
+			__net_nfc_lookup_add(table, 0, &current->id_s, current);
+		else
+			__net_nfc_lookup_add(table, current->TNF, &current->type_s, current);
+	}
+
+	return table;
+}
+
+static GHashTable *__net_nfc_get_type_lookup(ndef_message_s *ndef_message)
+{
+	/* records can be unshared after they are added */
+	__net_nfc_expire_record_lookup(ndef_message);
+
+	if (ndef_message->type_lookup == NULL)
+		ndef_message->type_lookup = __net_nfc_build_lookup(ndef_message, false);
+
+	return ndef_message->type_lookup;
+}
+
+static GHashTable *__net_nfc_get_id_lookup(ndef_message_s *ndef_message)
+{
+	/* ids can be changed after the records are added */
+	__net_nfc_expire_record_lookup(ndef_message);
+
+	if (ndef_message->id_lookup == NULL)
+		ndef_message->id_lookup = __net_nfc_build_lookup(ndef_message, true);
+
+	return ndef_message->id_lookup;
+}
+
+static void __net_nfc_drop_record_lookup(ndef_message_s *ndef_message)
+{
+	if (ndef_message->type_lookup != NULL)
+	{
+		g_hash_table_destroy(ndef_message->type_lookup);
+		ndef_message->type_lookup = NULL;
+	}
+
+	if (ndef_message->id_lookup != NULL)
+	{
+		g_hash_table_destroy(ndef_message->id_lookup);
+		ndef_message->id_lookup = NULL;
+	}
 }
 
 net_nfc_error_e net_nfc_util_search_record_by_type(ndef_message_s *ndef_message, net_nfc_record_tnf_e tnf, data_s *type, ndef_record_s **record)
@@ -660,6 +1780,15 @@ net_nfc_error_e net_nfc_util_search_record_by_type(ndef_message_s *ndef_message,
 		}
 	}
 
+	if (ndef_message->recordCount >= NET_NFC_NDEF_LOOKUP_MIN_RECORDS)
+	{
+		net_nfc_ndef_lookup_key_s query = { tnf, type_length, buf };
+
+		*record = g_hash_table_lookup(__net_nfc_get_type_lookup(ndef_message), &query);
+
+		return (*record != NULL) ? NET_NFC_OK : NET_NFC_NO_DATA_FOUND;
+	}
+
 	tmp_record = ndef_message->records;
 
 	for (; idx < ndef_message->recordCount; idx++)
@@ -701,6 +1830,15 @@ net_nfc_error_e net_nfc_util_search_record_by_id(ndef_message_s *ndef_message, d
 	id_length = id->length;
 	buf = id->buffer;
 
+	if (ndef_message->recordCount >= NET_NFC_NDEF_LOOKUP_MIN_RECORDS)
+	{
+		net_nfc_ndef_lookup_key_s query = { 0, id_length, buf };
+
+		*record = g_hash_table_lookup(__net_nfc_get_id_lookup(ndef_message), &query);
+
+		return (*record != NULL) ? NET_NFC_OK : NET_NFC_NO_DATA_FOUND;
+	}
+
 	record_in_msg = ndef_message->records;
 
 	for (; idx < ndef_message->recordCount; idx++)
@@ -725,56 +1863,69 @@ net_nfc_error_e net_nfc_util_search_record_by_id(ndef_message_s *ndef_message, d
 	return NET_NFC_NO_DATA_FOUND;
 }
 
-static net_nfc_error_e __net_nfc_repair_record_flags(ndef_message_s *ndef_message)
+/* records between the head and the tail keep MB = ME = 0, so only the
+   boundaries and a record that has just lost its boundary role need fixing */
+static net_nfc_error_e __net_nfc_repair_record_flags(ndef_message_s *ndef_message,
+		ndef_record_s *inner)
 {
-	int idx = 0;
-	ndef_record_s *record;
-
 	if (ndef_message == NULL)
 	{
 		return NET_NFC_NULL_PARAMETER;
 	}
 
-	record = ndef_message->records;
-
-	if (ndef_message->recordCount == 1)
+	if (inner != NULL)
 	{
-		if (record == NULL)
-		{
-			return NET_NFC_INVALID_FORMAT;
-		}
-
-		record->MB = 1;
-		record->ME = 1;
+		inner->MB = 0;
+		inner->ME = 0;
+	}
 
+	if (ndef_message->recordCount == 0)
+	{
 		return NET_NFC_OK;
 	}
 
-	for (idx = 0; idx < ndef_message->recordCount; idx++)
+	if (ndef_message->records == NULL || ndef_message->tail == NULL)
 	{
-		if (record == NULL)
-		{
-			return NET_NFC_INVALID_FORMAT;
-		}
-
-		if (idx == 0)
-		{
-			record->MB = 1;
-			record->ME = 0;
-		}
-		else if (idx == ndef_message->recordCount - 1)
-		{
-			record->MB = 0;
-			record->ME = 1;
-		}
-		else
-		{
-			record->MB = 0;
-			record->ME = 0;
-		}
-		record = record->next;
+		return NET_NFC_INVALID_FORMAT;
 	}
 
+	ndef_message->records->ME = 0;
+	ndef_message->records->MB = 1;
+
+	ndef_message->tail->MB = (ndef_message->recordCount == 1) ? 1 : 0;
+	ndef_message->tail->ME = 1;
+
 	return NET_NFC_OK;
 }
 
+static GPtrArray *__net_nfc_get_record_index(ndef_message_s *ndef_message)
+{
+	ndef_record_s *current;
+
+	if (ndef_message->record_index != NULL)
+		return ndef_message->record_index;
+
+	ndef_message->record_index = g_ptr_array_sized_new(ndef_message->recordCount);
+
+	for (current = ndef_message->records; current != NULL; current = current->next)
+		g_ptr_array_add(ndef_message->record_index, current);
+
+	if (ndef_message->record_index->len != ndef_message->recordCount)
+	{
+		NFC_ERR("record count mismatch [%d] [%d]",
+				ndef_message->record_index->len, ndef_message->recordCount);
+
+		__net_nfc_drop_record_index(ndef_message);
+	}
+
+	return ndef_message->record_index;
+}
+
+static void __net_nfc_drop_record_index(ndef_message_s *ndef_message)
+{
+	if (ndef_message->record_index != NULL)
+	{
+		g_ptr_array_free(ndef_message->record_index, TRUE);
+		ndef_message->record_index = NULL;
+	}
+}
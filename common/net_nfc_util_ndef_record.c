@@ -20,25 +20,209 @@
 #include "net_nfc_util_ndef_message.h"
 #include "net_nfc_util_ndef_record.h"
 
-net_nfc_error_e net_nfc_util_free_record(ndef_record_s *record)
+/* bumped whenever the id or the shared buffers of a record are replaced,
+   so the lookup tables of messages are rebuilt */
+static gint record_stamp;
+
+static void *__net_nfc_util_record_alloc(net_nfc_util_arena_s *arena, uint32_t size)
 {
-	RETV_IF(NULL == record, NET_NFC_NULL_PARAMETER);
+	void *mem = NULL;
+
+	if (arena != NULL)
+		return net_nfc_util_arena_alloc(arena, size);
+
+	_net_nfc_util_alloc_mem(mem, size);
+
+	return mem;
+}
+
+static void __net_nfc_util_record_free(net_nfc_util_arena_s *arena, void *mem)
+{
+	/* arena memory is released with the arena */
+	if (arena == NULL)
+		_net_nfc_util_free_mem(mem);
+}
+
+/* buffers of a record, owned by all records sharing them */
+struct _net_nfc_util_record_share_s
+{
+	gint ref_count;
+	uint8_t *type;
+	uint8_t *id;
+	uint8_t *payload;
+};
+
+static void __net_nfc_util_record_share_unref(net_nfc_util_record_share_s *share)
+{
+	if (g_atomic_int_dec_and_test(&share->ref_count) == FALSE)
+		return;
+
+	_net_nfc_util_free_mem(share->type);
+	_net_nfc_util_free_mem(share->id);
+	_net_nfc_util_free_mem(share->payload);
+	_net_nfc_util_free_mem(share);
+}
+
+static uint8_t *__net_nfc_util_record_dup(data_s *data)
+{
+	uint8_t *buffer = NULL;
+
+	if (data->buffer == NULL || data->length == 0)
+		return NULL;
+
+	_net_nfc_util_alloc_mem(buffer, data->length);
+	if (buffer != NULL)
+		memcpy(buffer, data->buffer, data->length);
+
+	return buffer;
+}
+
+void net_nfc_util_release_record_buffers(ndef_record_s *record)
+{
+	RET_IF(NULL == record);
 
-	if (record->type_s.buffer != NULL)
+	/* arena buffers are released with the arena of its message */
+	if (record->arena != NULL || record->borrowed)
+		return;
+
+	if (record->shared != NULL)
+	{
+		__net_nfc_util_record_share_unref(record->shared);
+		record->shared = NULL;
+	}
+	else
+	{
 		_net_nfc_util_free_mem(record->type_s.buffer);
-	if (record->id_s.buffer != NULL)
 		_net_nfc_util_free_mem(record->id_s.buffer);
-	if (record->payload_s.buffer != NULL)
 		_net_nfc_util_free_mem(record->payload_s.buffer);
+	}
+
+	record->type_s.buffer = NULL;
+	record->id_s.buffer = NULL;
+	record->payload_s.buffer = NULL;
+}
+
+net_nfc_error_e net_nfc_util_free_record(ndef_record_s *record)
+{
+	RETV_IF(NULL == record, NET_NFC_NULL_PARAMETER);
+
+	/* released with the arena of its message */
+	if (record->arena != NULL)
+		return NET_NFC_OK;
+
+	net_nfc_util_release_record_buffers(record);
 
 	_net_nfc_util_free_mem(record);
 
 	return NET_NFC_OK;
 }
 
-net_nfc_error_e net_nfc_util_create_record(net_nfc_record_tnf_e recordType,
-		const data_s *typeName, const data_s *id, const data_s *payload,
+net_nfc_error_e net_nfc_util_share_record(ndef_record_s *src,
 		ndef_record_s **record)
+{
+	net_nfc_util_record_share_s *share = NULL;
+	ndef_record_s *record_temp = NULL;
+
+	RETV_IF(NULL == src, NET_NFC_NULL_PARAMETER);
+	RETV_IF(NULL == record, NET_NFC_NULL_PARAMETER);
+
+	/* buffers of arena and borrowed records may go away with their owner */
+	if (src->arena != NULL || src->borrowed)
+		return net_nfc_util_create_record(src->TNF, &src->type_s, &src->id_s,
+				&src->payload_s, record);
+
+	_net_nfc_util_alloc_mem(record_temp, sizeof(ndef_record_s));
+	if (NULL == record_temp)
+		return NET_NFC_ALLOC_FAIL;
+
+	if (NULL == src->shared)
+	{
+		_net_nfc_util_alloc_mem(share, sizeof(*share));
+		if (NULL == share)
+		{
+			_net_nfc_util_free_mem(record_temp);
+			return NET_NFC_ALLOC_FAIL;
+		}
+
+		share->ref_count = 1;
+		share->type = src->type_s.buffer;
+		share->id = src->id_s.buffer;
+		share->payload = src->payload_s.buffer;
+
+		src->shared = share;
+	}
+
+	g_atomic_int_inc(&src->shared->ref_count);
+
+	/* same flags as a record made by net_nfc_util_create_record */
+	record_temp->TNF = src->TNF;
+	record_temp->type_s = src->type_s;
+	record_temp->id_s = src->id_s;
+	record_temp->payload_s = src->payload_s;
+	record_temp->SR = (src->payload_s.length < 256) ? 1 : 0;
+	record_temp->IL = (src->id_s.length > 0) ? 1 : 0;
+	record_temp->MB = 1;
+	record_temp->ME = 1;
+	record_temp->shared = src->shared;
+
+	*record = record_temp;
+
+	return NET_NFC_OK;
+}
+
+net_nfc_error_e net_nfc_util_unshare_record(ndef_record_s *record)
+{
+	net_nfc_util_record_share_s *share;
+	uint8_t *type;
+	uint8_t *id;
+	uint8_t *payload;
+
+	RETV_IF(NULL == record, NET_NFC_NULL_PARAMETER);
+
+	share = record->shared;
+	if (NULL == share)
+		return NET_NFC_OK;
+
+	/* the last owner keeps the buffers as they are */
+	if (g_atomic_int_get(&share->ref_count) == 1)
+	{
+		_net_nfc_util_free_mem(share);
+		record->shared = NULL;
+
+		return NET_NFC_OK;
+	}
+
+	type = __net_nfc_util_record_dup(&record->type_s);
+	id = __net_nfc_util_record_dup(&record->id_s);
+	payload = __net_nfc_util_record_dup(&record->payload_s);
+
+	if ((record->type_s.length > 0 && NULL == type)
+			|| (record->id_s.length > 0 && NULL == id)
+			|| (record->payload_s.length > 0 && NULL == payload))
+	{
+		_net_nfc_util_free_mem(type);
+		_net_nfc_util_free_mem(id);
+		_net_nfc_util_free_mem(payload);
+
+		return NET_NFC_ALLOC_FAIL;
+	}
+
+	record->type_s.buffer = type;
+	record->id_s.buffer = id;
+	record->payload_s.buffer = payload;
+	record->shared = NULL;
+
+	/* lookup tables of messages may still hold the old buffers */
+	g_atomic_int_inc(&record_stamp);
+
+	__net_nfc_util_record_share_unref(share);
+
+	return NET_NFC_OK;
+}
+
+net_nfc_error_e net_nfc_util_create_record_with_arena(net_nfc_util_arena_s *arena,
+		net_nfc_record_tnf_e recordType, const data_s *typeName, const data_s *id,
+		const data_s *payload, ndef_record_s **record)
 {
 	ndef_record_s *record_temp = NULL;
 
@@ -60,20 +244,23 @@ net_nfc_error_e net_nfc_util_create_record(net_nfc_record_tnf_e recordType,
 		}
 	}
 
-	_net_nfc_util_alloc_mem(record_temp, sizeof(ndef_record_s));
+	record_temp = __net_nfc_util_record_alloc(arena, sizeof(ndef_record_s));
 	if (NULL == record_temp)
 		return NET_NFC_ALLOC_FAIL;
 
+	record_temp->arena = arena;
+
 	// set type name and length and  TNF field
 	record_temp->TNF = recordType;
 	record_temp->type_s.length = typeName->length;
 
 	if(record_temp->type_s.length > 0)
 	{
-		_net_nfc_util_alloc_mem(record_temp->type_s.buffer, record_temp->type_s.length);
+		record_temp->type_s.buffer = __net_nfc_util_record_alloc(arena,
+				record_temp->type_s.length);
 		if (NULL == record_temp->type_s.buffer)
 		{
-			_net_nfc_util_free_mem(record_temp);
+			__net_nfc_util_record_free(arena, record_temp);
 
 			return NET_NFC_ALLOC_FAIL;
 		}
@@ -90,13 +277,13 @@ net_nfc_error_e net_nfc_util_create_record(net_nfc_record_tnf_e recordType,
 	record_temp->payload_s.length = payload->length;
 	if(payload->length >0)
 	{
-		_net_nfc_util_alloc_mem(record_temp->payload_s.buffer,
-			record_temp->payload_s.length);
+		record_temp->payload_s.buffer = __net_nfc_util_record_alloc(arena,
+				record_temp->payload_s.length);
 
 		if (NULL == record_temp->payload_s.buffer)
 		{
-			_net_nfc_util_free_mem(record_temp->type_s.buffer);
-			_net_nfc_util_free_mem(record_temp);
+			__net_nfc_util_record_free(arena, record_temp->type_s.buffer);
+			__net_nfc_util_record_free(arena, record_temp);
 
 			return NET_NFC_ALLOC_FAIL;
 		}
@@ -119,12 +306,13 @@ net_nfc_error_e net_nfc_util_create_record(net_nfc_record_tnf_e recordType,
 	if (id != NULL && id->buffer != NULL && id->length > 0)
 	{
 		record_temp->id_s.length = id->length;
-		_net_nfc_util_alloc_mem(record_temp->id_s.buffer, record_temp->id_s.length);
+		record_temp->id_s.buffer = __net_nfc_util_record_alloc(arena,
+				record_temp->id_s.length);
 		if (NULL == record_temp->id_s.buffer)
 		{
-			_net_nfc_util_free_mem(record_temp->payload_s.buffer);
-			_net_nfc_util_free_mem(record_temp->type_s.buffer);
-			_net_nfc_util_free_mem(record_temp);
+			__net_nfc_util_record_free(arena, record_temp->payload_s.buffer);
+			__net_nfc_util_record_free(arena, record_temp->type_s.buffer);
+			__net_nfc_util_record_free(arena, record_temp);
 
 			return NET_NFC_ALLOC_FAIL;
 		}
@@ -150,35 +338,61 @@ net_nfc_error_e net_nfc_util_create_record(net_nfc_record_tnf_e recordType,
 	return NET_NFC_OK;
 }
 
+net_nfc_error_e net_nfc_util_create_record(net_nfc_record_tnf_e recordType,
+		const data_s *typeName, const data_s *id, const data_s *payload,
+		ndef_record_s **record)
+{
+	return net_nfc_util_create_record_with_arena(NULL, recordType, typeName,
+			id, payload, record);
+}
+
 net_nfc_error_e net_nfc_util_create_uri_type_record(const char *uri,
 		net_nfc_schema_type_e protocol_schema, ndef_record_s **record)
 {
 	data_s type_data;
 	net_nfc_error_e error;
 	data_s payload_data = { NULL, 0 };
+	uint32_t prefix_length = 0;
+	uint32_t uri_length;
 
 	RETV_IF(NULL == uri, NET_NFC_NULL_PARAMETER);
+	RETV_IF(NULL == record, NET_NFC_NULL_PARAMETER);
 
-	payload_data.length = strlen((char *)uri) + 1;
-
-	RETV_IF(1 == payload_data.length, NET_NFC_INVALID_PARAM);
+	uri_length = strlen((char *)uri);
 
-	_net_nfc_util_alloc_mem(payload_data.buffer, payload_data.length);
-	if (NULL == payload_data.buffer)
-		return NET_NFC_ALLOC_FAIL;
+	RETV_IF(0 == uri_length, NET_NFC_INVALID_PARAM);
 
-	payload_data.buffer[0] = protocol_schema;	/* first byte of payload is protocol scheme */
-	memcpy(payload_data.buffer + 1, uri, payload_data.length - 1);
+	/* abbreviate the longest known prefix */
+	if (NET_NFC_SCHEMA_FULL_URI == protocol_schema)
+		protocol_schema = net_nfc_util_get_schema_type(uri, &prefix_length);
 
 	type_data.length = 1;
 	type_data.buffer = (uint8_t *)URI_RECORD_TYPE;
 
+	/* the payload is written in place instead of being copied in */
 	error = net_nfc_util_create_record(NET_NFC_RECORD_WELL_KNOWN_TYPE,
 			&type_data, NULL, &payload_data, record);
+	if (error != NET_NFC_OK)
+		return error;
 
-	_net_nfc_util_free_mem(payload_data.buffer);
+	payload_data.length = uri_length - prefix_length + 1;
 
-	return error;
+	_net_nfc_util_alloc_mem(payload_data.buffer, payload_data.length);
+	if (NULL == payload_data.buffer)
+	{
+		net_nfc_util_free_record(*record);
+		*record = NULL;
+
+		return NET_NFC_ALLOC_FAIL;
+	}
+
+	payload_data.buffer[0] = protocol_schema;	/* first byte of payload is protocol scheme */
+	memcpy(payload_data.buffer + 1, uri + prefix_length, payload_data.length - 1);
+
+	(*record)->payload_s = payload_data;
+	(*record)->SR = (payload_data.length < 256) ? 1 : 0;
+
+	return NET_NFC_OK;
 }
 
 net_nfc_error_e net_nfc_util_create_text_type_record(const char *text,
@@ -234,11 +448,15 @@ net_nfc_error_e net_nfc_util_set_record_id(ndef_record_s *record,
 	RETV_IF(NULL == data, NET_NFC_NULL_PARAMETER);
 	RETV_IF(NULL == record, NET_NFC_NULL_PARAMETER);
 	RETV_IF(length < 1, NET_NFC_OUT_OF_BOUND);
+	RETV_IF(record->borrowed, NET_NFC_NOT_ALLOWED_OPERATION);
+
+	if (net_nfc_util_unshare_record(record) != NET_NFC_OK)
+		return NET_NFC_ALLOC_FAIL;
 
 	if (record->id_s.buffer != NULL && record->id_s.length > 0)
-		_net_nfc_util_free_mem(record->id_s.buffer);
+		__net_nfc_util_record_free(record->arena, record->id_s.buffer);
 
-	_net_nfc_util_alloc_mem(record->id_s.buffer, length);
+	record->id_s.buffer = __net_nfc_util_record_alloc(record->arena, length);
 
 	if (record->id_s.buffer == NULL)
 		return NET_NFC_ALLOC_FAIL;
@@ -246,16 +464,27 @@ net_nfc_error_e net_nfc_util_set_record_id(ndef_record_s *record,
 	memcpy(record->id_s.buffer, data, length);
 	record->id_s.length = length;
 	record->IL = 1;
+	record->encoded_length = 0;
+
+	g_atomic_int_inc(&record_stamp);
 
 	return NET_NFC_OK;
 }
 
+uint32_t net_nfc_util_get_record_stamp(void)
+{
+	return g_atomic_int_get(&record_stamp);
+}
+
 uint32_t net_nfc_util_get_record_length(ndef_record_s *Record)
 {
 	uint32_t RecordLength = 1;
 
 	RETV_IF(NULL == Record, 0);
 
+	if (Record->encoded_length > 0)
+		return Record->encoded_length;
+
 	/* Type length is present only for following TNF
 	   NET_NFC_TNF_NFCWELLKNOWN
 	   NET_NFC_TNF_MEDIATYPE
@@ -296,70 +525,92 @@ uint32_t net_nfc_util_get_record_length(ndef_record_s *Record)
 		RecordLength++;
 	}
 
+	Record->encoded_length = RecordLength;
+
 	return RecordLength;
 }
 
-net_nfc_error_e net_nfc_util_create_uri_string_from_uri_record(
-	ndef_record_s *record, char **uri)
+net_nfc_error_e net_nfc_util_get_uri_string_from_uri_record(
+	ndef_record_s *record, char *buffer, uint32_t *length)
 {
-	net_nfc_error_e result = NET_NFC_OK;
+	const char *scheme = NULL;
+	uint32_t scheme_length = 0;
+	const uint8_t *rest;
+	uint32_t rest_length;
 
-	RETV_IF(NULL == uri, NET_NFC_INVALID_PARAM);
 	RETV_IF(NULL == record, NET_NFC_INVALID_PARAM);
-
-	*uri = NULL;
+	RETV_IF(NULL == length, NET_NFC_INVALID_PARAM);
 
 	if (NET_NFC_RECORD_WELL_KNOWN_TYPE == record->TNF &&
 			(record->type_s.length == 1 && record->type_s.buffer[0] == 'U'))
 	{
 		data_s *payload = &record->payload_s;
 
-		if (payload->length > 0)
-		{
-			int length = 0;
-			const char *scheme = NULL;
-
-			/* buffer length include a schema byte.
-			 * so it does not need to allocate one more byte for string. */
-			if ((scheme = net_nfc_util_get_schema_string(payload->buffer[0])) != NULL)
-				length = strlen(scheme);
-
-			*uri = (char *)calloc(1, length + payload->length);
-			if (*uri != NULL)
-			{
-				if (length > 0)
-					memcpy(*uri, scheme, length);
-				memcpy(*uri + length, payload->buffer + 1, payload->length - 1);
-			}
-			else
-			{
-				result = NET_NFC_ALLOC_FAIL;
-			}
-		}
-		else
-		{
-			NFC_ERR("invalid payload in record");
-		}
+		if (0 == payload->length)
+			return NET_NFC_NO_DATA_FOUND;
+
+		if ((scheme = net_nfc_util_get_schema_string(payload->buffer[0])) != NULL)
+			scheme_length = strlen(scheme);
+
+		rest = payload->buffer + 1;
+		rest_length = payload->length - 1;
 	}
 	else if (NET_NFC_RECORD_URI == record->TNF)
 	{
-		data_s *type = &record->type_s;
+		if (0 == record->type_s.length)
+			return NET_NFC_NO_DATA_FOUND;
 
-		if (type->length > 0)
-		{
-			*uri = (char *)calloc(1, type->length + 1);
-
-			if (*uri != NULL)
-				memcpy(*uri, type->buffer, type->length);
-			else
-				result = NET_NFC_ALLOC_FAIL;
-		}
+		rest = record->type_s.buffer;
+		rest_length = record->type_s.length;
 	}
 	else
+	{
+		return NET_NFC_NDEF_RECORD_IS_NOT_EXPECTED_TYPE;
+	}
+
+	if (NULL == buffer || *length < scheme_length + rest_length + 1)
+	{
+		*length = scheme_length + rest_length + 1;
+
+		return NET_NFC_BUFFER_TOO_SMALL;
+	}
+
+	if (scheme_length > 0)
+		memcpy(buffer, scheme, scheme_length);
+	memcpy(buffer + scheme_length, rest, rest_length);
+	buffer[scheme_length + rest_length] = '\0';
+
+	*length = scheme_length + rest_length + 1;
+
+	return NET_NFC_OK;
+}
+
+net_nfc_error_e net_nfc_util_create_uri_string_from_uri_record(
+	ndef_record_s *record, char **uri)
+{
+	net_nfc_error_e result;
+	uint32_t length = 0;
+
+	RETV_IF(NULL == uri, NET_NFC_INVALID_PARAM);
+	RETV_IF(NULL == record, NET_NFC_INVALID_PARAM);
+
+	*uri = NULL;
+
+	result = net_nfc_util_get_uri_string_from_uri_record(record, NULL, &length);
+	if (NET_NFC_NO_DATA_FOUND == result)
+	{
+		NFC_ERR("invalid payload in record");
+		return NET_NFC_OK;
+	}
+	else if (result != NET_NFC_BUFFER_TOO_SMALL)
 	{
 		NFC_ERR("no uri record");
-		result = NET_NFC_NDEF_RECORD_IS_NOT_EXPECTED_TYPE;
+		return result;
 	}
 
-	return result;
+	*uri = (char *)calloc(1, length);
+	if (NULL == *uri)
+		return NET_NFC_ALLOC_FAIL;
+
+	return net_nfc_util_get_uri_string_from_uri_record(record, *uri, &length);
 }
@@ -78,6 +78,140 @@ pid_t net_nfc_server_gdbus_get_pid(const char *name)
 	return pid;
 }
 
+typedef struct _PidData PidData;
+
+struct _PidData
+{
+	gchar *name;
+	net_nfc_server_gdbus_pid_cb callback;
+	void *user_data;
+};
+
+typedef struct _WatchData WatchData;
+
+struct _WatchData
+{
+	net_nfc_server_gdbus_vanished_cb callback;
+	void *user_data;
+};
+
+static void _get_pid_async_cb(GObject *source_object, GAsyncResult *res,
+		gpointer user_data)
+{
+	guint pid = 0;
+	GVariant *_ret;
+	GVariant *credentials;
+	GError *error = NULL;
+	PidData *data = user_data;
+
+	_ret = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source_object),
+			res, &error);
+	if (_ret != NULL)
+	{
+		g_variant_get(_ret, "(@a{sv})", &credentials);
+
+		if (g_variant_lookup(credentials, "ProcessID", "u", &pid) == FALSE)
+			NFC_ERR("no ProcessID in credentials of [%s]", data->name);
+
+		g_variant_unref(credentials);
+		g_variant_unref(_ret);
+	}
+	else
+	{
+		NFC_ERR("can not get credentials of [%s] : %s", data->name,
+				error->message);
+		g_error_free(error);
+	}
+
+	data->callback(data->name, (pid_t)pid, data->user_data);
+
+	g_free(data->name);
+	g_free(data);
+}
+
+void net_nfc_server_gdbus_get_pid_async(const char *name,
+		net_nfc_server_gdbus_pid_cb callback, void *user_data)
+{
+	PidData *data;
+
+	RET_IF(NULL == name);
+	RET_IF(NULL == callback);
+
+	if (NULL == connection)
+	{
+		callback(name, 0, user_data);
+		return;
+	}
+
+	data = g_new0(PidData, 1);
+	data->name = g_strdup(name);
+	data->callback = callback;
+	data->user_data = user_data;
+
+	g_dbus_connection_call(connection,
+			"org.freedesktop.DBus",
+			"/org/freedesktop/DBus",
+			"org.freedesktop.DBus",
+			"GetConnectionCredentials",
+			g_variant_new("(s)", name),
+			G_VARIANT_TYPE("(a{sv})"),
+			G_DBUS_CALL_FLAGS_NONE,
+			-1,
+			NULL,
+			_get_pid_async_cb,
+			data);
+}
+
+static void _name_owner_changed_cb(GDBusConnection *conn,
+		const gchar *sender_name,
+		const gchar *object_path,
+		const gchar *interface_name,
+		const gchar *signal_name,
+		GVariant *parameters,
+		gpointer user_data)
+{
+	const gchar *name;
+	const gchar *old_owner;
+	const gchar *new_owner;
+	WatchData *data = user_data;
+
+	g_variant_get(parameters, "(&s&s&s)", &name, &old_owner, &new_owner);
+
+	/* clients are known by their unique name, which never gets a new owner */
+	if (name[0] == ':' && new_owner[0] == '\0')
+		data->callback(name, data->user_data);
+}
+
+guint net_nfc_server_gdbus_watch_clients(
+		net_nfc_server_gdbus_vanished_cb callback, void *user_data)
+{
+	WatchData *data;
+
+	RETV_IF(NULL == callback, 0);
+	RETV_IF(NULL == connection, 0);
+
+	data = g_new0(WatchData, 1);
+	data->callback = callback;
+	data->user_data = user_data;
+
+	return g_dbus_connection_signal_subscribe(connection,
+			"org.freedesktop.DBus",
+			"org.freedesktop.DBus",
+			"NameOwnerChanged",
+			"/org/freedesktop/DBus",
+			NULL,
+			G_DBUS_SIGNAL_FLAGS_NONE,
+			_name_owner_changed_cb,
+			data,
+			g_free);
+}
+
+void net_nfc_server_gdbus_unwatch_clients(guint id)
+{
+	if (connection != NULL && id > 0)
+		g_dbus_connection_signal_unsubscribe(connection, id);
+}
+
 void net_nfc_manager_quit()
 {
 	NFC_DBG("net_nfc_manager_quit kill the nfc-manager daemon!!");
@@ -16,8 +16,22 @@
 #ifndef __NET_NFC_SERVER_H__
 #define __NET_NFC_SERVER_H__
 
+typedef void (*net_nfc_server_gdbus_pid_cb)(const char *name, pid_t pid,
+		void *user_data);
+
+typedef void (*net_nfc_server_gdbus_vanished_cb)(const char *name,
+		void *user_data);
+
 pid_t net_nfc_server_gdbus_get_pid(const char *name);
 
+void net_nfc_server_gdbus_get_pid_async(const char *name,
+		net_nfc_server_gdbus_pid_cb callback, void *user_data);
+
+guint net_nfc_server_gdbus_watch_clients(
+		net_nfc_server_gdbus_vanished_cb callback, void *user_data);
+
+void net_nfc_server_gdbus_unwatch_clients(guint id);
+
 void net_nfc_manager_quit();
 
 
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#define _GNU_SOURCE
+#include <pthread.h>
 #include <vconf.h>
 
 #include "net_nfc_debug_internal.h"
@@ -25,57 +27,270 @@
 #include "net_nfc_server_tag.h"
 #include "net_nfc_server_llcp.h"
 #include "net_nfc_server_se.h"
+#include "net_nfc_server_manager.h"
+#include "net_nfc_server_context.h"
+#include "net_nfc_server_statistics.h"
 
 
+/* every step a job waits counts as one class higher, so housekeeping
+   still runs under a steady stream of discovery events */
+#define CONTROLLER_AGING_STEP	(200 * G_TIME_SPAN_MILLISECOND)
+
+#define CONTROLLER_WAIT_BUCKETS	5
+
+/* threads shared by the handle lanes of a re-entrant plugin */
+#define CONTROLLER_LANE_WORKERS	3
+
 typedef struct _ControllerFuncData ControllerFuncData;
 
 struct _ControllerFuncData
 {
 	net_nfc_server_controller_func func;
 	gpointer data;
+	gint64 queued;
+	net_nfc_controller_priority_e priority;
+
+	/* set by net_nfc_server_controller_async_queue_push_job() */
+	net_nfc_target_handle_s *handle;
+	gchar *client_id;
+	gint64 deadline;
+	gboolean cancelled;
+	gboolean dropped;
 };
 
-static GAsyncQueue *controller_async_queue = NULL;
+typedef struct _ControllerQueueStats ControllerQueueStats;
 
-static GThread *controller_thread = NULL;
+struct _ControllerQueueStats
+{
+	guint max_depth;
+	guint64 jobs;
+	guint64 aged;
+	guint64 dropped;
+	guint64 waits[CONTROLLER_WAIT_BUCKETS];
+};
+
+typedef struct _ControllerLane ControllerLane;
+
+struct _ControllerLane
+{
+	gpointer handle;
+	GQueue jobs;
+};
+
+/* histogram names of the job phases, wait from push to start, run
+   and total from push to the end of the job */
+static const gchar *controller_trace_names[3][NET_NFC_CONTROLLER_PRIORITY_MAX] =
+{
+	{ "wait.discovery", "wait.tag", "wait.se", "wait.p2p", "wait.housekeeping" },
+	{ "run.discovery", "run.tag", "run.se", "run.p2p", "run.housekeeping" },
+	{ "total.discovery", "total.tag", "total.se", "total.p2p", "total.housekeeping" },
+};
 
-static gboolean controller_is_running = FALSE;
+static gint controller_trace_slots[3][NET_NFC_CONTROLLER_PRIORITY_MAX];
+
+static const gchar *controller_queue_names[NET_NFC_CONTROLLER_PRIORITY_MAX] =
+{
+	"discovery",
+	"tag",
+	"se",
+	"p2p",
+	"housekeeping",
+};
+
+static GQueue controller_queues[NET_NFC_CONTROLLER_PRIORITY_MAX];
+static ControllerQueueStats controller_stats[NET_NFC_CONTROLLER_PRIORITY_MAX];
+static gboolean controller_queue_ready = FALSE;
+static net_nfc_controller_priority_e controller_running =
+	NET_NFC_CONTROLLER_PRIORITY_MAX;
+
+/* handle -> ControllerLane, a lane lives while it has jobs */
+static GHashTable *controller_lanes = NULL;
+static GThreadPool *controller_lane_pool = NULL;
+static guint controller_lane_pending[NET_NFC_CONTROLLER_PRIORITY_MAX];
+
+/* the job the calling thread runs, for job_is_live() */
+static GPrivate controller_current_job;
+static pthread_mutex_t controller_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t controller_cond = PTHREAD_COND_INITIALIZER;
+
+/* lane jobs hold the read side, controller thread jobs the write side.
+   the controller thread has jobs without a handle, discovery, deinit and
+   secure element modes among them, which must not overlap any lane.
+   writers go first, lanes can not keep the controller thread waiting */
+static pthread_rwlock_t controller_lane_lock =
+	PTHREAD_RWLOCK_WRITER_NONRECURSIVE_INITIALIZER_NP;
+
+static GThread *controller_thread = NULL;
 
 static guint32 server_state = NET_NFC_SERVER_IDLE;
 
 
-static gpointer controller_thread_func(gpointer user_data)
+static guint controller_wait_bucket(gint64 wait)
 {
-	if (NULL == controller_async_queue)
+	guint i;
+	gint64 limit = G_TIME_SPAN_MILLISECOND;
+
+	for (i = 0; i < CONTROLLER_WAIT_BUCKETS - 1; i++, limit *= 10)
 	{
-		g_thread_exit(NULL);
+		if (wait < limit)
+			break;
+	}
+
+	return i;
+}
+
+static void controller_func_data_free(ControllerFuncData *func_data)
+{
+	g_free(func_data->client_id);
+	g_free(func_data);
+}
+
+static void controller_func_data_run(ControllerFuncData *func_data)
+{
+	gint64 started, finished;
+	net_nfc_controller_priority_e priority = func_data->priority;
+
+	started = g_get_monotonic_time();
+
+	g_private_set(&controller_current_job, func_data);
+
+	if (func_data->func)
+		func_data->func(func_data->data);
+
+	g_private_set(&controller_current_job, NULL);
+
+	finished = g_get_monotonic_time();
+
+	net_nfc_server_statistics_add(&controller_trace_slots[0][priority],
+			controller_trace_names[0][priority], started - func_data->queued);
+	net_nfc_server_statistics_add(&controller_trace_slots[1][priority],
+			controller_trace_names[1][priority], finished - started);
+	net_nfc_server_statistics_add(&controller_trace_slots[2][priority],
+			controller_trace_names[2][priority], finished - func_data->queued);
+}
+
+static ControllerQueueStats *controller_stats_account_no_lock(
+		ControllerFuncData *func_data, gint64 now)
+{
+	ControllerQueueStats *stats = &controller_stats[func_data->priority];
+
+	stats->jobs++;
+	stats->waits[controller_wait_bucket(now - func_data->queued)]++;
+
+	return stats;
+}
+
+static ControllerFuncData *controller_queue_pop_no_lock(void)
+{
+	gint i;
+	gint best = -1;
+	gint64 rank;
+	gint64 best_rank = 0;
+	gint64 now = g_get_monotonic_time();
+	ControllerFuncData *func_data;
+	ControllerQueueStats *stats;
+
+	/* only the heads matter, each class is fifo */
+	for (i = 0; i < NET_NFC_CONTROLLER_PRIORITY_MAX; i++)
+	{
+		func_data = g_queue_peek_head(&controller_queues[i]);
+		if (NULL == func_data)
+			continue;
+
+		rank = i - (now - func_data->queued) / CONTROLLER_AGING_STEP;
+		if (best < 0 || rank < best_rank)
+		{
+			best = i;
+			best_rank = rank;
+		}
+	}
+
+	if (best < 0)
 		return NULL;
+
+	func_data = g_queue_pop_head(&controller_queues[best]);
+
+	stats = controller_stats_account_no_lock(func_data, now);
+
+	for (i = 0; i < best; i++)
+	{
+		if (g_queue_is_empty(&controller_queues[i]) == FALSE)
+		{
+			stats->aged++;
+			break;
+		}
 	}
 
-	controller_is_running = TRUE;
-	while(controller_is_running)
+	return func_data;
+}
+
+static gpointer controller_thread_func(gpointer user_data)
+{
+	while (TRUE)
 	{
 		ControllerFuncData *func_data;
 
-		func_data = g_async_queue_pop(controller_async_queue);
-		if (func_data->func)
-			func_data->func(func_data->data);
+		pthread_mutex_lock(&controller_lock);
 
-		g_free(func_data);
+		/* after thread_deinit, only until the queues are empty */
+		while ((func_data = controller_queue_pop_no_lock()) == NULL &&
+				TRUE == controller_queue_ready)
+			pthread_cond_wait(&controller_cond, &controller_lock);
+
+		if (NULL == func_data)
+		{
+			pthread_mutex_unlock(&controller_lock);
+			break;
+		}
+
+		controller_running = func_data->priority;
+
+		pthread_mutex_unlock(&controller_lock);
+
+		pthread_rwlock_wrlock(&controller_lane_lock);
+		controller_func_data_run(func_data);
+		pthread_rwlock_unlock(&controller_lane_lock);
+
+		pthread_mutex_lock(&controller_lock);
+		controller_running = NET_NFC_CONTROLLER_PRIORITY_MAX;
+		pthread_mutex_unlock(&controller_lock);
+
+		controller_func_data_free(func_data);
 	}
 
 	g_thread_exit(NULL);
 	return NULL;
 }
 
-static void controller_async_queue_free_func(gpointer user_data)
+static void controller_lane_func(gpointer data, gpointer user_data)
 {
-	g_free(user_data);
-}
+	ControllerLane *lane = data;
+	ControllerFuncData *func_data;
 
-static void controller_thread_deinit_thread_func(gpointer user_data)
-{
-	controller_is_running = FALSE;
+	pthread_mutex_lock(&controller_lock);
+
+	while ((func_data = g_queue_pop_head(&lane->jobs)) != NULL)
+	{
+		controller_stats_account_no_lock(func_data, g_get_monotonic_time());
+
+		pthread_mutex_unlock(&controller_lock);
+
+		pthread_rwlock_rdlock(&controller_lane_lock);
+		controller_func_data_run(func_data);
+		pthread_rwlock_unlock(&controller_lane_lock);
+
+		pthread_mutex_lock(&controller_lock);
+
+		controller_lane_pending[func_data->priority]--;
+		controller_func_data_free(func_data);
+	}
+
+	/* drained, the next job for this handle starts a new lane */
+	g_hash_table_remove(controller_lanes, lane->handle);
+
+	pthread_mutex_unlock(&controller_lock);
+
+	g_free(lane);
 }
 
 /* FIXME: it works as broadcast only now */
@@ -220,7 +435,8 @@ static void _controller_llcp_event_cb(gpointer user_data)
 /* FIXME : net_nfc_dispatcher_queue_push() need to be removed */
 static void controller_llcp_event_cb(void *info, void *user_context)
 {
-	if(net_nfc_server_controller_async_queue_push(
+	if(net_nfc_server_controller_async_queue_push_priority(
+				NET_NFC_CONTROLLER_PRIORITY_P2P,
 				_controller_llcp_event_cb, info) == FALSE)
 	{
 		NFC_ERR("Failed to push onto the queue");
@@ -322,7 +538,19 @@ gboolean net_nfc_server_controller_thread_init(void)
 {
 	GError *error = NULL;
 
-	controller_async_queue = g_async_queue_new_full(controller_async_queue_free_func);
+	controller_lane_pool = g_thread_pool_new(controller_lane_func, NULL,
+			CONTROLLER_LANE_WORKERS, FALSE, &error);
+	if (NULL == controller_lane_pool)
+	{
+		NFC_ERR("can not create lane pool: %s", error->message);
+		g_error_free(error);
+		return FALSE;
+	}
+
+	pthread_mutex_lock(&controller_lock);
+	controller_lanes = g_hash_table_new(g_direct_hash, g_direct_equal);
+	controller_queue_ready = TRUE;
+	pthread_mutex_unlock(&controller_lock);
 
 	controller_thread = g_thread_try_new("controller_thread", controller_thread_func,
 			NULL, &error);
@@ -339,23 +567,34 @@ gboolean net_nfc_server_controller_thread_init(void)
 
 void net_nfc_server_controller_thread_deinit(void)
 {
-	if(net_nfc_server_controller_async_queue_push(controller_thread_deinit_thread_func,
-				NULL)==FALSE)
-	{
-		NFC_ERR("Failed to push onto the queue");
-	}
+	/* refuse new jobs. the controller thread and the lanes still run every
+	   queued one, so each invocation gets its reply and its data is freed */
+	pthread_mutex_lock(&controller_lock);
+
+	controller_queue_ready = FALSE;
+	pthread_cond_signal(&controller_cond);
+
+	pthread_mutex_unlock(&controller_lock);
 
 	g_thread_join(controller_thread);
 	controller_thread = NULL;
 
-	g_async_queue_unref(controller_async_queue);
-	controller_async_queue = NULL;
+	g_thread_pool_free(controller_lane_pool, FALSE, TRUE);
+	controller_lane_pool = NULL;
+
+	pthread_mutex_lock(&controller_lock);
+
+	g_hash_table_destroy(controller_lanes);
+	controller_lanes = NULL;
+
+	pthread_mutex_unlock(&controller_lock);
 }
 
 void net_nfc_server_controller_init(void)
 {
-	if(net_nfc_server_controller_async_queue_push(controller_init_thread_func,
-				NULL)==FALSE)
+	if(net_nfc_server_controller_async_queue_push_priority(
+				NET_NFC_CONTROLLER_PRIORITY_DISCOVERY,
+				controller_init_thread_func, NULL)==FALSE)
 	{
 		NFC_ERR("Failed to push onto the queue");
 	}
@@ -366,7 +605,9 @@ void net_nfc_server_controller_deinit(void)
 {
 	int ret;
 
-	ret = net_nfc_server_controller_async_queue_push(controller_deinit_thread_func, NULL);
+	ret = net_nfc_server_controller_async_queue_push_priority(
+			NET_NFC_CONTROLLER_PRIORITY_DISCOVERY,
+			controller_deinit_thread_func, NULL);
 	if (FALSE == ret)
 	{
 		NFC_ERR("Failed to push onto the queue");
@@ -374,31 +615,268 @@ void net_nfc_server_controller_deinit(void)
 }
 #endif
 
-gboolean net_nfc_server_controller_async_queue_push(
+static ControllerFuncData *controller_func_data_new(
+		net_nfc_controller_priority_e priority,
 		net_nfc_server_controller_func func, gpointer user_data)
 {
 	ControllerFuncData *func_data;
 
-	if(NULL == controller_async_queue)
+	func_data = g_new0(ControllerFuncData, 1);
+	func_data->func = func;
+	func_data->data = user_data;
+	func_data->queued = g_get_monotonic_time();
+	func_data->priority = priority;
+
+	return func_data;
+}
+
+/* the lane of handle when the plugin is re-entrant, the controller
+   thread otherwise. func_data is freed on failure */
+static gboolean controller_queue_push(ControllerFuncData *func_data,
+		net_nfc_target_handle_s *handle)
+{
+	guint depth;
+	ControllerLane *lane;
+	net_nfc_controller_priority_e priority = func_data->priority;
+
+	NET_NFC_SERVER_PROBE2(enqueue, priority, handle);
+
+	if (handle != NULL && net_nfc_controller_is_reentrant() == false)
+		handle = NULL;
+
+	pthread_mutex_lock(&controller_lock);
+
+	if (FALSE == controller_queue_ready)
 	{
-		NFC_ERR("controller_async_queue is not initialized");
+		pthread_mutex_unlock(&controller_lock);
+
+		NFC_ERR("controller queue is not initialized");
+		controller_func_data_free(func_data);
 
 		return FALSE;
 	}
 
-	func_data = g_new0(ControllerFuncData, 1);
-	func_data->func = func;
-	func_data->data = user_data;
+	if (NULL == handle)
+	{
+		g_queue_push_tail(&controller_queues[priority], func_data);
+
+		depth = g_queue_get_length(&controller_queues[priority]);
+		if (depth > controller_stats[priority].max_depth)
+			controller_stats[priority].max_depth = depth;
+
+		pthread_cond_signal(&controller_cond);
+	}
+	else
+	{
+		lane = g_hash_table_lookup(controller_lanes, handle);
+		if (NULL == lane)
+		{
+			lane = g_new0(ControllerLane, 1);
+			lane->handle = handle;
+			g_queue_init(&lane->jobs);
+
+			g_hash_table_insert(controller_lanes, handle, lane);
 
-	g_async_queue_push(controller_async_queue, func_data);
+			/* one worker per lane at a time keeps the handle in order */
+			g_thread_pool_push(controller_lane_pool, lane, NULL);
+		}
+
+		g_queue_push_tail(&lane->jobs, func_data);
+		controller_lane_pending[priority]++;
+	}
+
+	pthread_mutex_unlock(&controller_lock);
 
 	return TRUE;
 }
 
+gboolean net_nfc_server_controller_async_queue_push(
+		net_nfc_server_controller_func func, gpointer user_data)
+{
+	return net_nfc_server_controller_async_queue_push_priority(
+			NET_NFC_CONTROLLER_PRIORITY_TAG, func, user_data);
+}
+
+gboolean net_nfc_server_controller_async_queue_push_priority(
+		net_nfc_controller_priority_e priority,
+		net_nfc_server_controller_func func, gpointer user_data)
+{
+	RETV_IF(priority >= NET_NFC_CONTROLLER_PRIORITY_MAX, FALSE);
+
+	return controller_queue_push(
+			controller_func_data_new(priority, func, user_data), NULL);
+}
+
+gboolean net_nfc_server_controller_async_queue_push_handle(
+		net_nfc_controller_priority_e priority,
+		net_nfc_target_handle_s *handle,
+		net_nfc_server_controller_func func, gpointer user_data)
+{
+	RETV_IF(priority >= NET_NFC_CONTROLLER_PRIORITY_MAX, FALSE);
+
+	return controller_queue_push(
+			controller_func_data_new(priority, func, user_data), handle);
+}
+
+gboolean net_nfc_server_controller_async_queue_push_job(
+		net_nfc_controller_priority_e priority,
+		net_nfc_target_handle_s *handle,
+		GDBusMethodInvocation *invocation,
+		net_nfc_server_controller_func func, gpointer user_data)
+{
+	ControllerFuncData *func_data;
+
+	RETV_IF(priority >= NET_NFC_CONTROLLER_PRIORITY_MAX, FALSE);
+
+	func_data = controller_func_data_new(priority, func, user_data);
+	func_data->handle = handle;
+	func_data->deadline = func_data->queued + NET_NFC_SERVER_JOB_TIMEOUT;
+
+	if (invocation != NULL)
+		func_data->client_id = g_strdup(
+				g_dbus_method_invocation_get_sender(invocation));
+
+	return controller_queue_push(func_data, handle);
+}
+
+static void controller_cancel_queue_no_lock(GQueue *queue,
+		net_nfc_target_handle_s *handle)
+{
+	GList *list;
+	ControllerFuncData *func_data;
+
+	for (list = queue->head; list != NULL; list = list->next)
+	{
+		func_data = list->data;
+
+		if (func_data->handle == handle)
+			func_data->cancelled = TRUE;
+	}
+}
+
+void net_nfc_server_controller_cancel_handle(net_nfc_target_handle_s *handle)
+{
+	gint i;
+	ControllerLane *lane;
+
+	RET_IF(NULL == handle);
+
+	pthread_mutex_lock(&controller_lock);
+
+	for (i = 0; i < NET_NFC_CONTROLLER_PRIORITY_MAX; i++)
+		controller_cancel_queue_no_lock(&controller_queues[i], handle);
+
+	if (controller_lanes != NULL)
+	{
+		lane = g_hash_table_lookup(controller_lanes, handle);
+		if (lane != NULL)
+			controller_cancel_queue_no_lock(&lane->jobs, handle);
+	}
+
+	pthread_mutex_unlock(&controller_lock);
+}
+
+gboolean net_nfc_server_controller_job_is_live(net_nfc_error_e *result)
+{
+	gboolean cancelled;
+	ControllerFuncData *func_data = g_private_get(&controller_current_job);
+	net_nfc_error_e reason = NET_NFC_OK;
+
+	if (NULL == func_data || 0 == func_data->deadline)
+		return TRUE;
+
+	pthread_mutex_lock(&controller_lock);
+	cancelled = func_data->cancelled;
+	pthread_mutex_unlock(&controller_lock);
+
+	/* the watchdog does not poll while tag jobs are pending, so a tag
+	   job is also stale once a newer or no target is current */
+	if (TRUE == cancelled || (NET_NFC_CONTROLLER_PRIORITY_TAG ==
+				func_data->priority && func_data->handle != NULL &&
+				net_nfc_server_target_connected(func_data->handle) == FALSE))
+		reason = NET_NFC_TARGET_IS_MOVED_AWAY;
+	else if (g_get_monotonic_time() > func_data->deadline)
+		reason = NET_NFC_BUSY;
+	else if (func_data->client_id != NULL &&
+			net_nfc_server_gdbus_check_client_is_running(
+				func_data->client_id) == false)
+		reason = NET_NFC_IPC_FAIL;
+
+	if (NET_NFC_OK == reason)
+		return TRUE;
+
+	if (FALSE == func_data->dropped)
+	{
+		NFC_ERR("drop stale job, class [%s], reason [%d]",
+				controller_queue_names[func_data->priority], reason);
+
+		func_data->dropped = TRUE;
+
+		pthread_mutex_lock(&controller_lock);
+		controller_stats[func_data->priority].dropped++;
+		pthread_mutex_unlock(&controller_lock);
+	}
+
+	if (result != NULL)
+		*result = reason;
+
+	return FALSE;
+}
+
+guint net_nfc_server_controller_get_pending(
+		net_nfc_controller_priority_e priority)
+{
+	guint pending;
+
+	RETV_IF(priority >= NET_NFC_CONTROLLER_PRIORITY_MAX, 0);
+
+	pthread_mutex_lock(&controller_lock);
+
+	pending = g_queue_get_length(&controller_queues[priority]) +
+		controller_lane_pending[priority];
+	if (controller_running == priority)
+		pending++;
+
+	pthread_mutex_unlock(&controller_lock);
+
+	return pending;
+}
+
+GVariant *net_nfc_server_controller_get_queue_statistics(void)
+{
+	gint i;
+	GVariantBuilder builder;
+	ControllerQueueStats *stats;
+
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("a(suutttat)"));
+
+	pthread_mutex_lock(&controller_lock);
+
+	for (i = 0; i < NET_NFC_CONTROLLER_PRIORITY_MAX; i++)
+	{
+		stats = &controller_stats[i];
+
+		g_variant_builder_add(&builder, "(suuttt@at)",
+				controller_queue_names[i],
+				g_queue_get_length(&controller_queues[i]),
+				stats->max_depth,
+				stats->jobs,
+				stats->aged,
+				stats->dropped,
+				g_variant_new_fixed_array(G_VARIANT_TYPE_UINT64, stats->waits,
+					CONTROLLER_WAIT_BUCKETS, sizeof(guint64)));
+	}
+
+	pthread_mutex_unlock(&controller_lock);
+
+	return g_variant_builder_end(&builder);
+}
+
 void net_nfc_server_restart_polling_loop(void)
 {
-	if(net_nfc_server_controller_async_queue_push(restart_polling_loop_thread_func,
-				NULL) == FALSE)
+	if(net_nfc_server_controller_async_queue_push_priority(
+				NET_NFC_CONTROLLER_PRIORITY_DISCOVERY,
+				restart_polling_loop_thread_func, NULL) == FALSE)
 	{
 		NFC_ERR("Failed to push onto the queue");
 	}
@@ -410,11 +888,17 @@ void net_nfc_server_set_state(guint32 state)
 		server_state &= NET_NFC_SERVER_IDLE;
 	else
 		server_state |= state;
+
+	net_nfc_server_manager_update_state("server_state",
+			g_variant_new_uint32(server_state));
 }
 
 void net_nfc_server_unset_state(guint32 state)
 {
 	server_state &= ~state;
+
+	net_nfc_server_manager_update_state("server_state",
+			g_variant_new_uint32(server_state));
 }
 
 guint32 net_nfc_server_get_state(void)
@@ -17,11 +17,25 @@
 #define __NET_NFC_SERVER_COMMON_H__
 
 #include <glib.h>
+#include <gio/gio.h>
 
 #include "net_nfc_typedef.h"
 
 typedef void (*net_nfc_server_controller_func)(gpointer user_data);
 
+/* classes of controller jobs, a lower class runs first. a job moves up
+   one class for every CONTROLLER_AGING_STEP it waits */
+typedef enum
+{
+	NET_NFC_CONTROLLER_PRIORITY_DISCOVERY = 0, /* rf events, polling, activation */
+	NET_NFC_CONTROLLER_PRIORITY_TAG, /* user facing tag i/o */
+	NET_NFC_CONTROLLER_PRIORITY_SE, /* secure element apdus */
+	NET_NFC_CONTROLLER_PRIORITY_P2P, /* llcp, snep, handover, phdc */
+	NET_NFC_CONTROLLER_PRIORITY_HOUSEKEEPING,
+	NET_NFC_CONTROLLER_PRIORITY_MAX,
+}
+net_nfc_controller_priority_e;
+
 gboolean net_nfc_server_controller_thread_init(void);
 
 void net_nfc_server_controller_thread_deinit(void);
@@ -30,10 +44,60 @@ void net_nfc_server_controller_init(void);
 #ifndef ESE_ALWAYS_ON
 void net_nfc_server_controller_deinit(void);
 #endif
+/* queues func as NET_NFC_CONTROLLER_PRIORITY_TAG */
 gboolean net_nfc_server_controller_async_queue_push(
 		net_nfc_server_controller_func func,
 		gpointer user_data);
 
+gboolean net_nfc_server_controller_async_queue_push_priority(
+		net_nfc_controller_priority_e priority,
+		net_nfc_server_controller_func func,
+		gpointer user_data);
+
+/* runs func in the lane of handle, lanes of different handles run in
+   parallel when the plugin is re-entrant, otherwise this is the same
+   as net_nfc_server_controller_async_queue_push_priority().
+   every job that talks to a target must use this, so it never runs
+   beside its lane on the controller thread */
+gboolean net_nfc_server_controller_async_queue_push_handle(
+		net_nfc_controller_priority_e priority,
+		net_nfc_target_handle_s *handle,
+		net_nfc_server_controller_func func,
+		gpointer user_data);
+
+/* jobs of the class that are queued or running right now */
+guint net_nfc_server_controller_get_pending(
+		net_nfc_controller_priority_e priority);
+
+/* the default d-bus call timeout, nobody waits for a job older than this */
+#define NET_NFC_SERVER_JOB_TIMEOUT	(25 * G_TIME_SPAN_SECOND)
+
+/* like net_nfc_server_controller_async_queue_push_handle(), but the job
+   goes stale when the caller of invocation is gone, when it is older
+   than NET_NFC_SERVER_JOB_TIMEOUT or when its handle is cancelled,
+   a NET_NFC_CONTROLLER_PRIORITY_TAG job also once its target is gone.
+   func still runs to complete the call, it must ask
+   net_nfc_server_controller_job_is_live() before calling the plugin */
+gboolean net_nfc_server_controller_async_queue_push_job(
+		net_nfc_controller_priority_e priority,
+		net_nfc_target_handle_s *handle,
+		GDBusMethodInvocation *invocation,
+		net_nfc_server_controller_func func,
+		gpointer user_data);
+
+/* makes the queued jobs of handle stale, once its target is gone */
+void net_nfc_server_controller_cancel_handle(net_nfc_target_handle_s *handle);
+
+/* FALSE with the reason in result when the running job went stale,
+   the drop is counted in the queue statistics */
+gboolean net_nfc_server_controller_job_is_live(net_nfc_error_e *result);
+
+/* a(suutttat) : per class name, depth, max depth, jobs run, jobs run
+   ahead of a higher class because of their age, stale jobs dropped,
+   and a wait time
+   histogram of < 1ms, < 10ms, < 100ms, < 1s and longer */
+GVariant *net_nfc_server_controller_get_queue_statistics(void);
+
 void net_nfc_server_restart_polling_loop(void);
 
 void net_nfc_server_set_state(guint32 state);
@@ -15,7 +15,11 @@
  */
 
 #define _GNU_SOURCE
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <glib.h>
 
 #include "vconf.h"
@@ -28,20 +32,69 @@
 #include "net_nfc_server_context.h"
 
 
+/* the kernel answers "1" or "0" to a "subject object access" rule */
+#define SMACK_ACCESS_PATH	"/sys/fs/smackfs/access2"
+
 static GHashTable *client_contexts;
 static pthread_mutex_t context_lock = PTHREAD_MUTEX_INITIALIZER;
 
+/* read only copy of the ids in client_contexts, replaced as a whole on
+   every add and cleanup so known senders are found without context_lock */
+static GHashTable *client_snapshot;
+static guint client_watch_id;
+
 static void _cleanup_client_context(gpointer data)
 {
 	net_nfc_client_context_info_t *info = data;
 
 	if (info != NULL)
 	{
+		if (info->ndef_types != NULL)
+			g_variant_unref(info->ndef_types);
+
 		g_free(info->id);
 		g_free(info);
 	}
 }
 
+static gboolean _release_client_snapshot(gpointer user_data)
+{
+	g_hash_table_unref(user_data);
+
+	return FALSE;
+}
+
+/* must be called with context_lock held */
+static void _update_client_snapshot_no_lock()
+{
+	char *id;
+	GHashTable *snapshot = NULL;
+	GHashTable *old;
+	GHashTableIter iter;
+
+	if (client_contexts != NULL)
+	{
+		snapshot = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+		g_hash_table_iter_init(&iter, client_contexts);
+		while (g_hash_table_iter_next(&iter, (gpointer *)&id, NULL) == true)
+			g_hash_table_add(snapshot, g_strdup(id));
+	}
+
+	old = g_atomic_pointer_get(&client_snapshot);
+	g_atomic_pointer_set(&client_snapshot, snapshot);
+
+	/* readers run on the main loop, so nobody uses the old one
+	   any more once an idle gets dispatched */
+	if (old != NULL)
+		g_idle_add(_release_client_snapshot, old);
+}
+
+static void _client_vanished_cb(const char *id, void *user_data)
+{
+	net_nfc_server_gdbus_cleanup_client_context(id);
+}
+
 void net_nfc_server_gdbus_init_client_context()
 {
 	pthread_mutex_lock(&context_lock);
@@ -50,10 +103,19 @@ void net_nfc_server_gdbus_init_client_context()
 		client_contexts = g_hash_table_new(g_str_hash, g_str_equal);
 
 	pthread_mutex_unlock(&context_lock);
+
+	if (0 == client_watch_id)
+		client_watch_id = net_nfc_server_gdbus_watch_clients(
+				_client_vanished_cb, NULL);
 }
 
 void net_nfc_server_gdbus_deinit_client_context()
 {
+	GHashTable *snapshot;
+
+	net_nfc_server_gdbus_unwatch_clients(client_watch_id);
+	client_watch_id = 0;
+
 	pthread_mutex_lock(&context_lock);
 
 	if (client_contexts != NULL) {
@@ -61,7 +123,13 @@ void net_nfc_server_gdbus_deinit_client_context()
 		client_contexts = NULL;
 	}
 
+	snapshot = g_atomic_pointer_get(&client_snapshot);
+	g_atomic_pointer_set(&client_snapshot, NULL);
+
 	pthread_mutex_unlock(&context_lock);
+
+	if (snapshot != NULL)
+		g_hash_table_unref(snapshot);
 }
 
 /* TODO */
@@ -75,6 +143,43 @@ bool net_nfc_server_gdbus_check_privilege(GDBusMethodInvocation *invocation,
 	return true;
 }
 
+bool net_nfc_server_gdbus_check_label_privilege(const char *label,
+		const char *object, const char *right)
+{
+	int fd;
+	int length;
+	char answer = '0';
+	char rule[256 * 2 + 8];
+
+	if (access(SMACK_ACCESS_PATH, F_OK) < 0)
+		return true;
+
+	RETV_IF(NULL == label || '\0' == label[0], false);
+	RETV_IF(NULL == object, false);
+	RETV_IF(NULL == right, false);
+
+	length = snprintf(rule, sizeof(rule), "%s %s %s", label, object, right);
+	if (length < 0 || length >= sizeof(rule))
+		return false;
+
+	fd = open(SMACK_ACCESS_PATH, O_RDWR | O_CLOEXEC);
+	if (fd < 0)
+	{
+		NFC_ERR("can not open [%s], [%d]", SMACK_ACCESS_PATH, errno);
+		return false;
+	}
+
+	if (write(fd, rule, length) != length || read(fd, &answer, 1) != 1)
+	{
+		NFC_ERR("smack access check failed, [%d]", errno);
+		answer = '0';
+	}
+
+	close(fd);
+
+	return ('1' == answer);
+}
+
 size_t net_nfc_server_gdbus_get_client_count_no_lock()
 {
 	return g_hash_table_size(client_contexts);
@@ -117,9 +222,38 @@ net_nfc_client_context_info_t *net_nfc_server_gdbus_get_client_context(
 	return result;
 }
 
+static void _client_pid_cb(const char *id, pid_t pid, void *user_data)
+{
+	net_nfc_client_context_info_t *info;
+
+	pthread_mutex_lock(&context_lock);
+
+	info = net_nfc_server_gdbus_get_client_context_no_lock(id);
+	if (info != NULL)
+	{
+		NFC_DBG("client id : [%s], pid [%d]", id, pid);
+
+		info->pid = pid;
+		info->pgid = (pid > 0) ? getpgid(pid) : 0;
+		info->credentials_ready = (info->pgid > 0);
+	}
+
+	pthread_mutex_unlock(&context_lock);
+}
+
 void net_nfc_server_gdbus_add_client_context(const char *id,
 		client_state_e state)
 {
+	bool added = false;
+	GHashTable *snapshot;
+
+	RET_IF(NULL == id);
+
+	/* fast path, every call of a known client ends here */
+	snapshot = g_atomic_pointer_get(&client_snapshot);
+	if (snapshot != NULL && g_hash_table_contains(snapshot, id))
+		return;
+
 	pthread_mutex_lock(&context_lock);
 
 	if (net_nfc_server_gdbus_get_client_context_no_lock(id) == NULL)
@@ -129,20 +263,20 @@ void net_nfc_server_gdbus_add_client_context(const char *id,
 		info = g_new0(net_nfc_client_context_info_t, 1);
 		if (info != NULL)
 		{
-			pid_t pid;
-
-			pid = net_nfc_server_gdbus_get_pid(id);
-			NFC_DBG("added client id : [%s], pid [%d]", id, pid);
+			NFC_DBG("added client id : [%s]", id);
 
+			/* pid and pgid are filled when the bus answers, the client
+			   is unknown to pid based lookups until credentials_ready */
 			info->id = g_strdup(id);
-			info->pid = pid;
-			info->pgid = getpgid(pid);
 			info->state = state;
 			info->launch_popup_state = NET_NFC_LAUNCH_APP_SELECT;
 			info->launch_popup_state_no_check = NET_NFC_LAUNCH_APP_SELECT;
 
 			g_hash_table_insert(client_contexts, (gpointer)info->id, (gpointer)info);
 
+			_update_client_snapshot_no_lock();
+			added = true;
+
 			NFC_DBG("current client count = [%d]",
 					net_nfc_server_gdbus_get_client_count_no_lock());
 		}
@@ -153,6 +287,9 @@ void net_nfc_server_gdbus_add_client_context(const char *id,
 	}
 
 	pthread_mutex_unlock(&context_lock);
+
+	if (true == added)
+		net_nfc_server_gdbus_get_pid_async(id, _client_pid_cb, NULL);
 }
 
 void net_nfc_server_gdbus_cleanup_client_context(const char *id)
@@ -170,6 +307,8 @@ void net_nfc_server_gdbus_cleanup_client_context(const char *id)
 
 		_cleanup_client_context(info);
 
+		_update_client_snapshot_no_lock();
+
 		NFC_DBG("current client count = [%d]",
 				net_nfc_server_gdbus_get_client_count_no_lock());
 
@@ -300,7 +439,8 @@ net_nfc_launch_popup_state_e net_nfc_server_gdbus_get_client_popup_state(
 			break;
 		}
 
-		if (pid == temp->pgid)
+		/* pgid is still 0 before the bus answered */
+		if (temp->credentials_ready && pid == temp->pgid)
 		{
 			info = temp;
 			break;
@@ -315,6 +455,150 @@ net_nfc_launch_popup_state_e net_nfc_server_gdbus_get_client_popup_state(
 	return state;
 }
 
+void net_nfc_server_gdbus_set_event_filter(const char *id, guint32 tech_mask,
+		GVariant *ndef_types, bool raw_data)
+{
+	net_nfc_client_context_info_t *info;
+
+	pthread_mutex_lock(&context_lock);
+
+	info = net_nfc_server_gdbus_get_client_context_no_lock(id);
+	if (info != NULL)
+	{
+		NFC_DBG("event filter of [%s] : tech [%x], ndef types [%d], raw data [%d]",
+				id, tech_mask, (int)g_variant_n_children(ndef_types), raw_data);
+
+		if (info->ndef_types != NULL)
+			g_variant_unref(info->ndef_types);
+
+		info->has_event_filter = true;
+		info->tech_mask = tech_mask;
+		info->ndef_types = g_variant_ref(ndef_types);
+		info->raw_data = raw_data;
+	}
+
+	pthread_mutex_unlock(&context_lock);
+}
+
+static bool _event_filter_match_ndef(GVariant *ndef_types, ndef_message_s *ndef)
+{
+	guint8 tnf;
+	GVariant *type;
+	GVariantIter iter;
+	ndef_record_s *record;
+	const guint8 *bytes;
+	gsize length;
+	bool result = false;
+
+	if (NULL == ndef_types || g_variant_n_children(ndef_types) == 0)
+		return true;
+
+	g_variant_iter_init(&iter, ndef_types);
+
+	while (false == result && g_variant_iter_next(&iter, "(y@ay)", &tnf, &type))
+	{
+		bytes = g_variant_get_fixed_array(type, &length, sizeof(guint8));
+
+		for (record = ndef->records; record != NULL; record = record->next)
+		{
+			if (record->TNF != tnf)
+				continue;
+
+			if (0 == length || (record->type_s.length == length &&
+						memcmp(record->type_s.buffer, bytes, length) == 0))
+			{
+				result = true;
+				break;
+			}
+		}
+
+		g_variant_unref(type);
+	}
+
+	return result;
+}
+
+static void _event_emit(GDBusConnection *connection, const char *destination,
+		GDBusInterfaceSkeleton *skeleton, const gchar *signal_name,
+		GVariant *parameters)
+{
+	GError *error = NULL;
+
+	if (g_dbus_connection_emit_signal(connection,
+				destination,
+				g_dbus_interface_skeleton_get_object_path(skeleton),
+				g_dbus_interface_skeleton_get_info(skeleton)->name,
+				signal_name,
+				parameters,
+				&error) == FALSE)
+	{
+		NFC_ERR("can not emit [%s] : %s", signal_name, error->message);
+		g_error_free(error);
+	}
+}
+
+void net_nfc_server_gdbus_emit_event(GDBusInterfaceSkeleton *skeleton,
+		const gchar *signal_name,
+		guint32 tech,
+		ndef_message_s *ndef,
+		GVariant *parameters,
+		GVariant *parameters_no_raw)
+{
+	char *id;
+	GList *list;
+	GList *connections;
+	GHashTableIter iter;
+	net_nfc_client_context_info_t *info;
+
+	RET_IF(NULL == skeleton);
+	RET_IF(NULL == parameters);
+
+	g_variant_ref_sink(parameters);
+	if (parameters_no_raw != NULL)
+		g_variant_ref_sink(parameters_no_raw);
+
+	connections = g_dbus_interface_skeleton_get_connections(skeleton);
+
+	/* the payload goes first, so a client which gets both keeps the copy
+	   with the payload and drops the broadcast as a duplicate */
+	if (parameters_no_raw != NULL)
+	{
+		pthread_mutex_lock(&context_lock);
+
+		if (client_contexts != NULL)
+		{
+			g_hash_table_iter_init(&iter, client_contexts);
+			while (g_hash_table_iter_next(&iter, (gpointer *)&id, (gpointer *)&info) == true)
+			{
+				if (false == info->has_event_filter || false == info->raw_data)
+					continue;
+
+				if ((info->tech_mask & tech) == 0)
+					continue;
+
+				if (ndef != NULL &&
+						_event_filter_match_ndef(info->ndef_types, ndef) == false)
+					continue;
+
+				for (list = connections; list != NULL; list = list->next)
+					_event_emit(list->data, id, skeleton, signal_name, parameters);
+			}
+		}
+
+		pthread_mutex_unlock(&context_lock);
+	}
+
+	for (list = connections; list != NULL; list = list->next)
+		_event_emit(list->data, NULL, skeleton, signal_name,
+				parameters_no_raw != NULL ? parameters_no_raw : parameters);
+
+	g_list_free_full(connections, g_object_unref);
+
+	if (parameters_no_raw != NULL)
+		g_variant_unref(parameters_no_raw);
+	g_variant_unref(parameters);
+}
+
 void net_nfc_server_gdbus_increase_se_count(const char *id)
 {
 	net_nfc_client_context_info_t *info;
@@ -28,6 +28,7 @@ typedef struct _net_nfc_client_context_info_t
 	char *id;
 	pid_t pid;
 	pid_t pgid;
+	bool credentials_ready; /* pid and pgid came from the bus */
 
 	/* changed by client state */
 	int ref_se;
@@ -35,6 +36,12 @@ typedef struct _net_nfc_client_context_info_t
 	net_nfc_launch_popup_state_e launch_popup_state;
 	net_nfc_launch_popup_state_e launch_popup_state_no_check;
 
+	/* set by SetEventFilter, only the broadcast without payload if not */
+	bool has_event_filter;
+	guint32 tech_mask;
+	GVariant *ndef_types;
+	bool raw_data;
+
 } net_nfc_client_context_info_t;
 
 typedef void (*net_nfc_server_gdbus_for_each_client_cb)(
@@ -49,6 +56,13 @@ bool net_nfc_server_gdbus_check_privilege(GDBusMethodInvocation *invocation,
 		const char *object,
 		const char *right);
 
+/* the smack check for peers that are not on d-bus, label is what
+   SO_PEERSEC gave for the peer. it passes when smack is not enabled,
+   the socket permissions are all there is then */
+bool net_nfc_server_gdbus_check_label_privilege(const char *label,
+		const char *object,
+		const char *right);
+
 void net_nfc_server_gdbus_add_client_context(const char *id,
 		client_state_e state);
 
@@ -81,6 +95,21 @@ net_nfc_launch_popup_state_e net_nfc_server_gdbus_get_launch_state(
 net_nfc_launch_popup_state_e net_nfc_server_gdbus_get_client_popup_state(
 		pid_t pid);
 
+void net_nfc_server_gdbus_set_event_filter(const char *id, guint32 tech_mask,
+		GVariant *ndef_types, bool raw_data);
+
+/* send a signal of skeleton. it is broadcast once with parameters_no_raw,
+   the event without its payload. clients whose filter asked for raw data
+   and matches tech and, if ndef is not NULL, ndef get parameters as a
+   unicast before it. parameters_no_raw is NULL for events without a
+   payload, parameters is broadcast then */
+void net_nfc_server_gdbus_emit_event(GDBusInterfaceSkeleton *skeleton,
+		const gchar *signal_name,
+		guint32 tech,
+		ndef_message_s *ndef,
+		GVariant *parameters,
+		GVariant *parameters_no_raw);
+
 void net_nfc_server_gdbus_increase_se_count(const char *id);
 void net_nfc_server_gdbus_decrease_se_count(const char *id);
 
@@ -31,9 +31,34 @@
 #include "net_nfc_util_internal.h"
 #include "net_nfc_debug_internal.h"
 #include "net_nfc_server_tag.h"
+#include "net_nfc_server_common.h"
+#include "net_nfc_server_statistics.h"
 
 #define NET_NFC_DEFAULT_PLUGIN	"libnfc-plugin.so"
 
+/* calls the plugin and adds the time it took to the "oem.<op>" histogram */
+#define CONTROLLER_CALL(op, ...) \
+	({ \
+		static gint __slot; \
+		gint64 __start = g_get_monotonic_time(); \
+		bool __ret = g_interface.op(__VA_ARGS__); \
+		net_nfc_server_statistics_add(&__slot, "oem." #op, \
+				g_get_monotonic_time() - __start); \
+		__ret; \
+	})
+
+/* like CONTROLLER_CALL() for a call on a target, once it reports the
+   target gone whatever is still queued for handle would only time out */
+#define CONTROLLER_TARGET_CALL(op, handle, result, ...) \
+	({ \
+		bool __target_ret = CONTROLLER_CALL(op, handle, ##__VA_ARGS__, \
+				result); \
+		if (NET_NFC_TARGET_IS_MOVED_AWAY == *(result) || \
+				NET_NFC_RF_TIMEOUT == *(result)) \
+			net_nfc_server_controller_cancel_handle(handle); \
+		__target_ret; \
+	})
+
 static net_nfc_oem_interface_s g_interface;
 
 static void *net_nfc_controller_load_file(const char *dir_path, const char *filename)
@@ -169,7 +194,7 @@ bool net_nfc_controller_init(net_nfc_error_e *result)
 {
 	if (g_interface.init != NULL)
 	{
-		return g_interface.init(result);
+		return CONTROLLER_CALL(init, result);
 	}
 	else
 	{
@@ -183,7 +208,7 @@ bool net_nfc_controller_deinit(void)
 {
 	if (g_interface.deinit != NULL)
 	{
-		return g_interface.deinit();
+		return CONTROLLER_CALL(deinit);
 	}
 	else
 	{
@@ -199,7 +224,7 @@ bool net_nfc_controller_register_listener(
 {
 	if (g_interface.register_listener != NULL)
 	{
-		return g_interface.register_listener(target_detection_listener,
+		return CONTROLLER_CALL(register_listener, target_detection_listener,
 				se_transaction_listener, llcp_event_listener, result);
 	}
 	else
@@ -214,7 +239,7 @@ bool net_nfc_controller_unregister_listener()
 {
 	if (g_interface.unregister_listener != NULL)
 	{
-		return g_interface.unregister_listener();
+		return CONTROLLER_CALL(unregister_listener);
 	}
 	else
 	{
@@ -228,7 +253,7 @@ bool net_nfc_controller_get_firmware_version(data_s **data,
 {
 	if (g_interface.get_firmware_version != NULL)
 	{
-		return g_interface.get_firmware_version(data, result);
+		return CONTROLLER_CALL(get_firmware_version, data, result);
 	}
 	else
 	{
@@ -242,7 +267,7 @@ bool net_nfc_controller_check_firmware_version(net_nfc_error_e *result)
 {
 	if (g_interface.check_firmware_version != NULL)
 	{
-		return g_interface.check_firmware_version(result);
+		return CONTROLLER_CALL(check_firmware_version, result);
 	}
 	else
 	{
@@ -256,7 +281,7 @@ bool net_nfc_controller_update_firmware(net_nfc_error_e *result)
 {
 	if (g_interface.update_firmeware != NULL)
 	{
-		return g_interface.update_firmeware(result);
+		return CONTROLLER_CALL(update_firmeware, result);
 	}
 	else
 	{
@@ -271,7 +296,7 @@ bool net_nfc_controller_get_stack_information(
 {
 	if (g_interface.get_stack_information != NULL)
 	{
-		return g_interface.get_stack_information(stack_info, result);
+		return CONTROLLER_CALL(get_stack_information, stack_info, result);
 	}
 	else
 	{
@@ -286,7 +311,7 @@ bool net_nfc_controller_configure_discovery(net_nfc_discovery_mode_e mode,
 {
 	if (g_interface.configure_discovery != NULL)
 	{
-		return g_interface.configure_discovery(mode, config, result);
+		return CONTROLLER_CALL(configure_discovery, mode, config, result);
 	}
 	else
 	{
@@ -303,7 +328,7 @@ bool net_nfc_controller_get_secure_element_list(
 {
 	if (g_interface.get_secure_element_list != NULL)
 	{
-		return g_interface.get_secure_element_list(list, count, result);
+		return CONTROLLER_CALL(get_secure_element_list, list, count, result);
 	}
 	else
 	{
@@ -320,7 +345,7 @@ bool net_nfc_controller_set_secure_element_mode(
 {
 	if (g_interface.set_secure_element_mode != NULL)
 	{
-		return g_interface.set_secure_element_mode(element_type, mode, result);
+		return CONTROLLER_CALL(set_secure_element_mode, element_type, mode, result);
 	}
 	else
 	{
@@ -343,7 +368,7 @@ bool net_nfc_controller_secure_element_open(
 
 	if (g_interface.secure_element_open != NULL)
 	{
-		return g_interface.secure_element_open(element_type, handle, result);
+		return CONTROLLER_CALL(secure_element_open, element_type, handle, result);
 	}
 	else
 	{
@@ -358,7 +383,7 @@ bool net_nfc_controller_secure_element_get_atr(net_nfc_target_handle_s *handle,
 {
 	if (g_interface.secure_element_get_atr != NULL)
 	{
-		return g_interface.secure_element_get_atr(handle, atr, result);
+		return CONTROLLER_CALL(secure_element_get_atr, handle, atr, result);
 	}
 	else
 	{
@@ -376,7 +401,7 @@ bool net_nfc_controller_secure_element_send_apdu(
 {
 	if (g_interface.secure_element_send_apdu != NULL)
 	{
-		return g_interface.secure_element_send_apdu(handle, command, response, result);
+		return CONTROLLER_CALL(secure_element_send_apdu, handle, command, response, result);
 	}
 	else
 	{
@@ -396,7 +421,7 @@ bool net_nfc_controller_secure_element_close(net_nfc_target_handle_s *handle,
 
 	if (g_interface.secure_element_close != NULL)
 	{
-		return g_interface.secure_element_close(handle, result);
+		return CONTROLLER_CALL(secure_element_close, handle, result);
 	}
 	else
 	{
@@ -411,7 +436,7 @@ bool net_nfc_controller_check_target_presence(net_nfc_target_handle_s *handle,
 {
 	if (g_interface.check_presence != NULL)
 	{
-		return g_interface.check_presence(handle, result);
+		return CONTROLLER_CALL(check_presence, handle, result);
 	}
 	else
 	{
@@ -432,7 +457,7 @@ bool net_nfc_controller_connect(net_nfc_target_handle_s *handle,
 
 	if (g_interface.connect != NULL)
 	{
-		return g_interface.connect(handle, result);
+		return CONTROLLER_CALL(connect, handle, result);
 	}
 	else
 	{
@@ -455,7 +480,7 @@ bool net_nfc_controller_disconnect(net_nfc_target_handle_s *handle,
 	{
 		net_nfc_server_free_target_info();
 
-		return g_interface.disconnect(handle, result);
+		return CONTROLLER_CALL(disconnect, handle, result);
 	}
 	else
 	{
@@ -473,8 +498,8 @@ bool net_nfc_controller_check_ndef(net_nfc_target_handle_s *handle,
 {
 	if (g_interface.check_ndef != NULL)
 	{
-		return g_interface.check_ndef(handle, ndef_card_state, max_data_size,
-				real_data_size, result);
+		return CONTROLLER_TARGET_CALL(check_ndef, handle, result,
+				ndef_card_state, max_data_size, real_data_size);
 	}
 	else
 	{
@@ -489,7 +514,7 @@ bool net_nfc_controller_read_ndef(net_nfc_target_handle_s *handle, data_s **data
 {
 	if (g_interface.read_ndef != NULL)
 	{
-		return g_interface.read_ndef(handle, data, result);
+		return CONTROLLER_TARGET_CALL(read_ndef, handle, result, data);
 	}
 	else
 	{
@@ -504,7 +529,7 @@ bool net_nfc_controller_write_ndef(net_nfc_target_handle_s *handle, data_s *data
 {
 	if (g_interface.write_ndef != NULL)
 	{
-		return g_interface.write_ndef(handle, data, result);
+		return CONTROLLER_TARGET_CALL(write_ndef, handle, result, data);
 	}
 	else
 	{
@@ -519,7 +544,7 @@ bool net_nfc_controller_make_read_only_ndef(net_nfc_target_handle_s *handle,
 {
 	if (g_interface.make_read_only_ndef != NULL)
 	{
-		return g_interface.make_read_only_ndef(handle, result);
+		return CONTROLLER_TARGET_CALL(make_read_only_ndef, handle, result);
 	}
 	else
 	{
@@ -534,7 +559,8 @@ bool net_nfc_controller_format_ndef(net_nfc_target_handle_s *handle,
 {
 	if (g_interface.format_ndef != NULL)
 	{
-		return g_interface.format_ndef(handle, secure_key, result);
+		return CONTROLLER_TARGET_CALL(format_ndef, handle, result,
+				secure_key);
 	}
 	else
 	{
@@ -549,7 +575,8 @@ bool net_nfc_controller_transceive(net_nfc_target_handle_s *handle,
 {
 	if (g_interface.transceive != NULL)
 	{
-		return g_interface.transceive(handle, info, data, result);
+		return CONTROLLER_TARGET_CALL(transceive, handle, result,
+				info, data);
 	}
 	else
 	{
@@ -563,7 +590,7 @@ bool net_nfc_controller_exception_handler()
 {
 	if (g_interface.exception_handler != NULL)
 	{
-		return g_interface.exception_handler();
+		return CONTROLLER_CALL(exception_handler);
 	}
 	else
 	{
@@ -576,7 +603,7 @@ bool net_nfc_controller_is_ready(net_nfc_error_e *result)
 {
 	if (g_interface.is_ready != NULL)
 	{
-		return g_interface.is_ready(result);
+		return CONTROLLER_CALL(is_ready, result);
 	}
 	else
 	{
@@ -591,7 +618,7 @@ bool net_nfc_controller_llcp_check_llcp(net_nfc_target_handle_s *handle,
 {
 	if (g_interface.check_llcp_status != NULL)
 	{
-		return g_interface.check_llcp_status(handle, result);
+		return CONTROLLER_CALL(check_llcp_status, handle, result);
 	}
 	else
 	{
@@ -605,7 +632,7 @@ bool net_nfc_controller_llcp_activate_llcp(net_nfc_target_handle_s *handle,
 {
 	if (g_interface.activate_llcp != NULL)
 	{
-		return g_interface.activate_llcp(handle, result);
+		return CONTROLLER_CALL(activate_llcp, handle, result);
 	}
 	else
 	{
@@ -709,7 +736,7 @@ bool net_nfc_controller_llcp_create_socket(net_nfc_llcp_socket_t *socket,
 			return false;
 		}
 
-		ret = g_interface.create_llcp_socket(socket, socketType, miu, rw, result, NULL);
+		ret = CONTROLLER_CALL(create_llcp_socket, socket, socketType, miu, rw, result, NULL);
 		if (true == ret)
 		{
 			info->socket = *socket;
@@ -736,7 +763,7 @@ bool net_nfc_controller_llcp_bind(net_nfc_llcp_socket_t socket,
 {
 	if (g_interface.bind_llcp_socket != NULL)
 	{
-		return g_interface.bind_llcp_socket(socket, service_access_point, result);
+		return CONTROLLER_CALL(bind_llcp_socket, socket, service_access_point, result);
 	}
 	else
 	{
@@ -788,7 +815,7 @@ bool net_nfc_controller_llcp_listen(net_nfc_target_handle_s* handle,
 		info->work_cb = cb;
 		info->work_param = user_param;
 
-		return g_interface.listen_llcp_socket(handle, service_access_name, socket,
+		return CONTROLLER_CALL(listen_llcp_socket, handle, service_access_name, socket,
 				result, info);
 	}
 	else
@@ -817,7 +844,7 @@ bool net_nfc_controller_llcp_accept(net_nfc_llcp_socket_t socket,
 		info->err_cb = cb;
 		info->err_param = user_param;
 
-		return g_interface.accept_llcp_socket(socket, result, NULL);
+		return CONTROLLER_CALL(accept_llcp_socket, socket, result, NULL);
 	}
 	else
 	{
@@ -834,7 +861,7 @@ bool net_nfc_controller_llcp_reject(net_nfc_target_handle_s *handle,
 	{
 		bool ret;
 
-		ret = g_interface.reject_llcp(handle, socket, result);
+		ret = CONTROLLER_CALL(reject_llcp, handle, socket, result);
 		if (true == ret)
 			_remove_socket_info(socket);
 
@@ -890,7 +917,7 @@ bool net_nfc_controller_llcp_connect_by_url(net_nfc_target_handle_s *handle,
 		param->cb = cb;
 		param->user_param = user_param;
 
-		return g_interface.connect_llcp_by_url(handle, socket, service_access_name,
+		return CONTROLLER_CALL(connect_llcp_by_url, handle, socket, service_access_name,
 				result, param);
 	}
 	else
@@ -929,7 +956,7 @@ bool net_nfc_controller_llcp_connect(net_nfc_target_handle_s *handle,
 		param->cb = cb;
 		param->user_param = user_param;
 
-		return g_interface.connect_llcp(handle, socket, service_access_point, result, param);
+		return CONTROLLER_CALL(connect_llcp, handle, socket, service_access_point, result, param);
 	}
 	else
 	{
@@ -980,7 +1007,7 @@ bool net_nfc_controller_llcp_disconnect(net_nfc_target_handle_s *handle,
 		param->cb = cb;
 		param->user_param = user_param;
 
-		return g_interface.disconnect_llcp(handle, socket, result, param);
+		return CONTROLLER_CALL(disconnect_llcp, handle, socket, result, param);
 	}
 	else
 	{
@@ -995,7 +1022,7 @@ bool net_nfc_controller_llcp_socket_close(net_nfc_llcp_socket_t socket,
 {
 	if (g_interface.close_llcp_socket != NULL)
 	{
-		return g_interface.close_llcp_socket(socket, result);
+		return CONTROLLER_CALL(close_llcp_socket, socket, result);
 	}
 	else
 	{
@@ -1056,7 +1083,7 @@ bool net_nfc_controller_llcp_recv(net_nfc_target_handle_s *handle,
 		}
 		param->user_param = user_param;
 
-		return g_interface.recv_llcp(handle, socket, &param->data, result, param);
+		return CONTROLLER_CALL(recv_llcp, handle, socket, &param->data, result, param);
 	}
 	else
 	{
@@ -1102,7 +1129,7 @@ bool net_nfc_controller_llcp_send(net_nfc_target_handle_s *handle,
 		param->cb = cb;
 		param->user_param = user_param;
 
-		return g_interface.send_llcp(handle, socket, data, result, param);
+		return CONTROLLER_CALL(send_llcp, handle, socket, data, result, param);
 	}
 	else
 	{
@@ -1146,7 +1173,7 @@ bool net_nfc_controller_llcp_recv_from(net_nfc_target_handle_s *handle,
 		}
 		param->user_param = user_param;
 
-		return g_interface.recv_from_llcp(handle, socket, &param->data, result, param);
+		return CONTROLLER_CALL(recv_from_llcp, handle, socket, &param->data, result, param);
 	}
 	else
 	{
@@ -1179,7 +1206,7 @@ bool net_nfc_controller_llcp_send_to(net_nfc_target_handle_s *handle,
 		param->cb = cb;
 		param->user_param = user_param;
 
-		return g_interface.send_to_llcp(handle, socket, data, service_access_point,
+		return CONTROLLER_CALL(send_to_llcp, handle, socket, data, service_access_point,
 				result, param);
 	}
 	else
@@ -1195,7 +1222,7 @@ bool net_nfc_controller_llcp_get_remote_config(net_nfc_target_handle_s *handle,
 {
 	if (g_interface.get_remote_config != NULL)
 	{
-		return g_interface.get_remote_config(handle, config, result);
+		return CONTROLLER_CALL(get_remote_config, handle, config, result);
 	}
 	else
 	{
@@ -1212,7 +1239,7 @@ bool net_nfc_controller_llcp_get_remote_socket_info(
 {
 	if (g_interface.get_remote_socket_info != NULL)
 	{
-		return g_interface.get_remote_socket_info(handle, socket, option, result);
+		return CONTROLLER_CALL(get_remote_socket_info, handle, socket, option, result);
 	}
 	else
 	{
@@ -1227,7 +1254,7 @@ bool net_nfc_controller_sim_test(net_nfc_error_e *result)
 {
 	if (g_interface.sim_test != NULL)
 	{
-		return g_interface.sim_test(result);
+		return CONTROLLER_CALL(sim_test, result);
 	}
 	else
 	{
@@ -1242,7 +1269,7 @@ bool net_nfc_controller_prbs_test(net_nfc_error_e *result, uint32_t tech,
 {
 	if (g_interface.prbs_test != NULL)
 	{
-		return g_interface.prbs_test(result, tech, rate);
+		return CONTROLLER_CALL(prbs_test, result, tech, rate);
 	}
 	else
 	{
@@ -1256,7 +1283,7 @@ bool net_nfc_controller_test_mode_on(net_nfc_error_e *result)
 {
 	if (g_interface.test_mode_on != NULL)
 	{
-		return g_interface.test_mode_on(result);
+		return CONTROLLER_CALL(test_mode_on, result);
 	}
 	else
 	{
@@ -1270,7 +1297,7 @@ bool net_nfc_controller_test_mode_off(net_nfc_error_e *result)
 {
 	if (g_interface.test_mode_off != NULL)
 	{
-		return g_interface.test_mode_off(result);
+		return CONTROLLER_CALL(test_mode_off, result);
 	}
 	else
 	{
@@ -1284,7 +1311,7 @@ bool net_nfc_controller_support_nfc(net_nfc_error_e *result)
 {
 	if (g_interface.support_nfc != NULL)
 	{
-		return g_interface.support_nfc(result);
+		return CONTROLLER_CALL(support_nfc, result);
 	}
 	else
 	{
@@ -1294,12 +1321,17 @@ bool net_nfc_controller_support_nfc(net_nfc_error_e *result)
 	}
 }
 
+bool net_nfc_controller_is_reentrant(void)
+{
+	return (g_interface.capabilities & NET_NFC_OEM_CAPABILITY_REENTRANT_HANDLES) != 0;
+}
+
 bool net_nfc_controller_eedata_register_set(net_nfc_error_e *result,
 		uint32_t mode, uint32_t reg_id, data_s *data)
 {
 	if (g_interface.eedata_register_set != NULL)
 	{
-		return g_interface.eedata_register_set(result, mode, reg_id, data);
+		return CONTROLLER_CALL(eedata_register_set, result, mode, reg_id, data);
 	}
 	else
 	{
@@ -39,6 +39,7 @@ bool net_nfc_controller_register_listener(
 		net_nfc_error_e* result);
 bool net_nfc_controller_unregister_listener(void);
 bool net_nfc_controller_support_nfc(net_nfc_error_e *result);
+bool net_nfc_controller_is_reentrant(void);
 bool net_nfc_controller_get_firmware_version(data_s **data,
 		net_nfc_error_e *result);
 bool net_nfc_controller_check_firmware_version(net_nfc_error_e *result);
@@ -87,7 +87,8 @@ static gboolean handover_handle_request(NetNfcGDbusHandover *hdover,
 	data->handle = arg_handle;
 	data->type = arg_type;
 
-	result = net_nfc_server_controller_async_queue_push(
+	result = net_nfc_server_controller_async_queue_push_handle(
+			NET_NFC_CONTROLLER_PRIORITY_P2P, GUINT_TO_POINTER(data->handle),
 			handover_request_thread_func, data);
 	if (FALSE == result)
 	{
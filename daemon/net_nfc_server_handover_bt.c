@@ -665,8 +665,7 @@ net_nfc_error_e net_nfc_server_handover_bt_process_carrier_record(
 		context->cb = cb;
 		context->user_param = user_param;
 		context->step = NET_NFC_LLCP_STEP_01;
-		net_nfc_util_create_record(record->TNF, &record->type_s,
-				&record->id_s, &record->payload_s, &context->carrier);
+		net_nfc_util_share_record(record, &context->carrier);
 
 		g_idle_add(
 				(GSourceFunc)_net_nfc_handover_bt_process_carrier_record,
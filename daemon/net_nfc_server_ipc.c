@@ -0,0 +1,434 @@
+/*
+ * Copyright (c) 2012-2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 				 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <grp.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <glib.h>
+#include <glib-unix.h>
+
+#include "net_nfc_typedef_internal.h"
+#include "net_nfc_debug_internal.h"
+#include "net_nfc_util_internal.h"
+#include "net_nfc_util_ipc_internal.h"
+#include "net_nfc_server_controller.h"
+#include "net_nfc_server_common.h"
+#include "net_nfc_server_tag.h"
+#include "net_nfc_server_context.h"
+#include "net_nfc_server_ipc.h"
+
+/* a reply the client does not read within this time closes it, so one
+   stuck client can not hold up the controller thread */
+#define IPC_SEND_TIMEOUT	1
+
+typedef struct _IpcClient IpcClient;
+
+struct _IpcClient
+{
+	gint ref_count;
+	int fd;
+	guint source;
+	pid_t pid;
+	/* the d-bus Transceive check, done once at accept */
+	gboolean can_transceive;
+	uint8_t buffer[sizeof(net_nfc_ipc_header_s) + NET_NFC_IPC_PAYLOAD_MAX];
+};
+
+typedef struct _IpcTransceiveData IpcTransceiveData;
+
+struct _IpcTransceiveData
+{
+	IpcClient *client;
+	uint32_t id;
+	guint handle;
+	net_nfc_transceive_info_s transceive_info;
+};
+
+static int ipc_socket = -1;
+static guint ipc_source = 0;
+static GList *ipc_clients = NULL;
+
+static IpcClient *ipc_client_ref(IpcClient *client)
+{
+	g_atomic_int_inc(&client->ref_count);
+
+	return client;
+}
+
+static void ipc_client_unref(IpcClient *client)
+{
+	if (g_atomic_int_dec_and_test(&client->ref_count) == FALSE)
+		return;
+
+	/* nothing can reply on the fd any more, it is safe to reuse */
+	close(client->fd);
+	g_free(client);
+}
+
+static void ipc_client_close(IpcClient *client)
+{
+	NFC_DBG("ipc client [%d] closed", client->pid);
+
+	if (client->source > 0)
+	{
+		g_source_remove(client->source);
+		client->source = 0;
+	}
+
+	/* wakes up a reply blocked in the controller thread */
+	shutdown(client->fd, SHUT_RDWR);
+
+	ipc_clients = g_list_remove(ipc_clients, client);
+
+	ipc_client_unref(client);
+}
+
+static void ipc_client_reply(IpcClient *client, uint32_t id, uint16_t type,
+		net_nfc_error_e result, const void *payload, uint32_t length)
+{
+	net_nfc_ipc_header_s header = { 0, };
+
+	header.id = id;
+	header.type = type;
+	header.flags = NET_NFC_IPC_FLAG_REPLY;
+	header.result = result;
+
+	/* a failure shows up as a hang up on the main loop */
+	if (net_nfc_util_ipc_send(client->fd, &header, payload, length) == false)
+		shutdown(client->fd, SHUT_RDWR);
+}
+
+static void ipc_transceive_thread_func(gpointer user_data)
+{
+	bool ret;
+	data_s *data = NULL;
+	net_nfc_error_e result = NET_NFC_OK;
+	IpcTransceiveData *transceive_data = user_data;
+	net_nfc_target_handle_s *handle =
+		GUINT_TO_POINTER(transceive_data->handle);
+
+	if (net_nfc_server_controller_job_is_live(&result) == FALSE)
+	{
+		NFC_ERR("stale transceive dropped");
+	}
+	else if (net_nfc_server_target_connected(handle) == true)
+	{
+		ret = net_nfc_controller_transceive(handle,
+				&transceive_data->transceive_info, &data, &result);
+		if (false == ret && NET_NFC_OK == result)
+			result = NET_NFC_OPERATION_FAIL;
+	}
+	else
+	{
+		result = NET_NFC_TARGET_IS_MOVED_AWAY;
+	}
+
+	NFC_DBG("transceive result : %d", result);
+
+	/* straight from this thread, the reply does not wait for the main loop */
+	ipc_client_reply(transceive_data->client, transceive_data->id,
+			NET_NFC_IPC_TRANSCEIVE, result,
+			(data != NULL) ? data->buffer : NULL,
+			(data != NULL) ? data->length : 0);
+
+	if (data != NULL)
+	{
+		g_free(data->buffer);
+		g_free(data);
+	}
+
+	if (transceive_data->transceive_info.trans_data.buffer != NULL)
+		net_nfc_util_free_data(&transceive_data->transceive_info.trans_data);
+
+	ipc_client_unref(transceive_data->client);
+
+	g_free(transceive_data);
+}
+
+static net_nfc_error_e ipc_handle_transceive(IpcClient *client,
+		net_nfc_ipc_header_s *header, const uint8_t *payload)
+{
+	uint32_t params[2];
+	IpcTransceiveData *data;
+
+	if (header->length < sizeof(params))
+		return NET_NFC_INVALID_PARAM;
+
+	memcpy(params, payload, sizeof(params));
+
+	data = g_try_new0(IpcTransceiveData, 1);
+	if (NULL == data)
+		return NET_NFC_ALLOC_FAIL;
+
+	data->id = header->id;
+	data->handle = params[0];
+	data->transceive_info.dev_type = params[1];
+
+	if (header->length > sizeof(params))
+	{
+		if (net_nfc_util_alloc_data(&data->transceive_info.trans_data,
+					header->length - sizeof(params)) == false)
+		{
+			g_free(data);
+
+			return NET_NFC_ALLOC_FAIL;
+		}
+
+		memcpy(data->transceive_info.trans_data.buffer,
+				payload + sizeof(params),
+				data->transceive_info.trans_data.length);
+	}
+
+	data->client = ipc_client_ref(client);
+
+	if (net_nfc_server_controller_async_queue_push_job(
+				NET_NFC_CONTROLLER_PRIORITY_TAG, GUINT_TO_POINTER(data->handle),
+				NULL, ipc_transceive_thread_func, data) == FALSE)
+	{
+		if (data->transceive_info.trans_data.buffer != NULL)
+			net_nfc_util_free_data(&data->transceive_info.trans_data);
+		ipc_client_unref(data->client);
+		g_free(data);
+
+		return NET_NFC_OPERATION_FAIL;
+	}
+
+	return NET_NFC_OK;
+}
+
+static void ipc_client_dispatch(IpcClient *client)
+{
+	uint32_t state;
+	net_nfc_error_e result;
+	net_nfc_ipc_header_s *header = (net_nfc_ipc_header_s *)client->buffer;
+	const uint8_t *payload = client->buffer + sizeof(*header);
+
+	switch (header->type)
+	{
+	case NET_NFC_IPC_PING :
+		ipc_client_reply(client, header->id, header->type, NET_NFC_OK, NULL, 0);
+		break;
+
+	case NET_NFC_IPC_GET_SERVER_STATE :
+		state = net_nfc_server_get_state();
+
+		ipc_client_reply(client, header->id, header->type, NET_NFC_OK,
+				&state, sizeof(state));
+		break;
+
+	case NET_NFC_IPC_TRANSCEIVE :
+		if (FALSE == client->can_transceive)
+		{
+			NFC_ERR("transceive denied to [%d]", client->pid);
+
+			ipc_client_reply(client, header->id, header->type,
+					NET_NFC_SECURITY_FAIL, NULL, 0);
+			break;
+		}
+
+		/* answered by the controller thread, later requests of this
+		   client may complete first */
+		result = ipc_handle_transceive(client, header, payload);
+		if (result != NET_NFC_OK)
+			ipc_client_reply(client, header->id, header->type, result, NULL, 0);
+		break;
+
+	default :
+		NFC_ERR("unknown request [%d] from [%d]", header->type, client->pid);
+
+		ipc_client_reply(client, header->id, header->type,
+				NET_NFC_NOT_SUPPORTED, NULL, 0);
+		break;
+	}
+}
+
+static gboolean ipc_client_cb(gint fd, GIOCondition condition,
+		gpointer user_data)
+{
+	ssize_t ret;
+	IpcClient *client = user_data;
+
+	if (condition & G_IO_IN)
+	{
+		/* drain what is queued, one frame per request */
+		while ((ret = net_nfc_util_ipc_recv(fd, client->buffer,
+						MSG_DONTWAIT)) > 0)
+		{
+			ipc_client_dispatch(client);
+		}
+
+		if (ret < 0 && (EAGAIN == errno || EWOULDBLOCK == errno))
+			return G_SOURCE_CONTINUE;
+	}
+
+	client->source = 0;
+	ipc_client_close(client);
+
+	return G_SOURCE_REMOVE;
+}
+
+static gboolean ipc_accept_cb(gint fd, GIOCondition condition,
+		gpointer user_data)
+{
+	int client_fd;
+	IpcClient *client;
+	struct ucred cred = { 0, };
+	socklen_t length = sizeof(cred);
+	char label[256] = { 0, };
+	struct timeval timeout = { IPC_SEND_TIMEOUT, 0 };
+
+	client_fd = accept4(fd, NULL, NULL, SOCK_CLOEXEC);
+	if (client_fd < 0)
+	{
+		NFC_ERR("accept failed, [%d]", errno);
+		return G_SOURCE_CONTINUE;
+	}
+
+	if (getsockopt(client_fd, SOL_SOCKET, SO_PEERCRED, &cred, &length) < 0)
+		NFC_ERR("SO_PEERCRED failed, [%d]", errno);
+
+	/* no label without smack, the check passes on its own then */
+	length = sizeof(label) - 1;
+	if (getsockopt(client_fd, SOL_SOCKET, SO_PEERSEC, label, &length) < 0)
+		label[0] = '\0';
+
+	/* the same rights the d-bus calls ask for */
+	if (net_nfc_server_gdbus_check_label_privilege(label,
+				"nfc-manager", "r") == false)
+	{
+		NFC_ERR("ipc client [%d] denied", cred.pid);
+		close(client_fd);
+
+		return G_SOURCE_CONTINUE;
+	}
+
+	setsockopt(client_fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+	client = g_new0(IpcClient, 1);
+	client->ref_count = 1;
+	client->fd = client_fd;
+	client->pid = cred.pid;
+	client->can_transceive = net_nfc_server_gdbus_check_label_privilege(label,
+			"nfc-manager", "rw");
+	client->source = g_unix_fd_add(client_fd, G_IO_IN | G_IO_HUP | G_IO_ERR,
+			ipc_client_cb, client);
+
+	ipc_clients = g_list_prepend(ipc_clients, client);
+
+	NFC_DBG("ipc client [%d] connected", client->pid);
+
+	return G_SOURCE_CONTINUE;
+}
+
+/* the directory keeps others from taking the socket path while the
+   daemon is not running, it must be ours and only writable by us */
+static gboolean ipc_prepare_dir(void)
+{
+	struct stat st;
+
+	if (mkdir(NET_NFC_IPC_SOCKET_DIR, 0755) < 0 && errno != EEXIST)
+	{
+		NFC_ERR("can not create [%s], [%d]", NET_NFC_IPC_SOCKET_DIR, errno);
+		return FALSE;
+	}
+
+	if (lstat(NET_NFC_IPC_SOCKET_DIR, &st) < 0 || S_ISDIR(st.st_mode) == 0
+			|| st.st_uid != geteuid())
+	{
+		NFC_ERR("[%s] is not owned by the daemon", NET_NFC_IPC_SOCKET_DIR);
+		return FALSE;
+	}
+
+	if ((st.st_mode & (S_IWGRP | S_IWOTH)) != 0
+			&& chmod(NET_NFC_IPC_SOCKET_DIR, 0755) < 0)
+	{
+		NFC_ERR("can not restrict [%s], [%d]", NET_NFC_IPC_SOCKET_DIR, errno);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static gid_t ipc_socket_group(void)
+{
+	struct group *group = getgrnam(NET_NFC_IPC_SOCKET_GROUP);
+
+	return (group != NULL) ? group->gr_gid : getegid();
+}
+
+gboolean net_nfc_server_ipc_init(void)
+{
+	struct sockaddr_un addr = { 0, };
+
+	if (ipc_socket >= 0)
+		return TRUE;
+
+	if (ipc_prepare_dir() == FALSE)
+		return FALSE;
+
+	ipc_socket = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (ipc_socket < 0)
+	{
+		NFC_ERR("socket failed, [%d]", errno);
+		return FALSE;
+	}
+
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, NET_NFC_IPC_SOCKET_PATH, sizeof(addr.sun_path) - 1);
+
+	unlink(NET_NFC_IPC_SOCKET_PATH);
+
+	if (bind(ipc_socket, (struct sockaddr *)&addr, sizeof(addr)) < 0
+			|| chown(NET_NFC_IPC_SOCKET_PATH, -1, ipc_socket_group()) < 0
+			|| chmod(NET_NFC_IPC_SOCKET_PATH, 0660) < 0
+			|| listen(ipc_socket, SOMAXCONN) < 0)
+	{
+		NFC_ERR("can not listen on [%s], [%d]", NET_NFC_IPC_SOCKET_PATH, errno);
+
+		net_nfc_server_ipc_deinit();
+
+		return FALSE;
+	}
+
+	ipc_source = g_unix_fd_add(ipc_socket, G_IO_IN, ipc_accept_cb, NULL);
+
+	return TRUE;
+}
+
+void net_nfc_server_ipc_deinit(void)
+{
+	while (ipc_clients != NULL)
+		ipc_client_close(ipc_clients->data);
+
+	if (ipc_source > 0)
+	{
+		g_source_remove(ipc_source);
+		ipc_source = 0;
+	}
+
+	if (ipc_socket >= 0)
+	{
+		close(ipc_socket);
+		ipc_socket = -1;
+
+		unlink(NET_NFC_IPC_SOCKET_PATH);
+	}
+}
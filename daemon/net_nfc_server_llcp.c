@@ -13,6 +13,11 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <glib-unix.h>
 #include <dd-display.h>/*for pm lock*/
 
 #include "net_nfc_debug_internal.h"
@@ -38,6 +43,13 @@
 
 static NetNfcGDbusLlcp *llcp_skeleton = NULL;
 
+/* client_socket -> LlcpStream, touched from the main loop only */
+static GHashTable *llcp_streams = NULL;
+
+/* client_socket -> bus name of the client which created or accepted it */
+static GHashTable *llcp_socket_owners = NULL;
+static pthread_mutex_t llcp_socket_owners_lock = PTHREAD_MUTEX_INITIALIZER;
+
 static net_nfc_llcp_config_info_s llcp_config =
 {
 	NET_NFC_LLCP_MIU,
@@ -147,6 +159,7 @@ struct _LlcpSendData
 	guint32 client_socket;
 
 	data_s data;
+	GMappedFile *mapped; /* set when data came as a memfd */
 };
 
 typedef struct _LlcpSendToData LlcpSendToData;
@@ -161,6 +174,7 @@ struct _LlcpSendToData
 	guint8 sap;
 
 	data_s data;
+	GMappedFile *mapped; /* set when data came as a memfd */
 };
 
 typedef struct _LlcpReceiveData LlcpReceiveData;
@@ -197,6 +211,48 @@ struct _LlcpDisconnectData
 	guint32 client_socket;
 };
 
+typedef struct _LlcpOpenStreamData LlcpOpenStreamData;
+
+struct _LlcpOpenStreamData
+{
+	NetNfcGDbusLlcp *llcp;
+	GDBusMethodInvocation *invocation;
+
+	guint32 handle;
+	guint32 client_socket;
+	net_nfc_llcp_socket_option_s option;
+	net_nfc_error_e result;
+};
+
+typedef struct _LlcpStream LlcpStream;
+
+struct _LlcpStream
+{
+	gint ref_count;
+
+	guint32 handle;
+	guint32 client_socket;
+	guint16 miu; /* of the remote socket, written PDUs must fit in it */
+	guint8 rw; /* of the remote socket */
+
+	int fd;
+	guint in_source; /* 0 while rw sends are in flight */
+	guint out_source; /* set while pending waits for the client */
+	guint in_flight;
+	data_s pending; /* received pdu the client has no room for yet */
+	bool closed;
+};
+
+typedef struct _LlcpStreamJob LlcpStreamJob;
+
+struct _LlcpStreamJob
+{
+	LlcpStream *stream;
+
+	data_s data;
+	net_nfc_error_e result;
+};
+
 typedef struct _LlcpSimpleData LlcpSimpleData;
 
 struct _LlcpSimpleData
@@ -209,6 +265,44 @@ struct _LlcpSimpleData
 	gpointer user_data;
 };
 
+static void llcp_socket_set_owner(net_nfc_llcp_socket_t socket, const char *id)
+{
+	pthread_mutex_lock(&llcp_socket_owners_lock);
+
+	if (NULL == llcp_socket_owners)
+		llcp_socket_owners = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+				NULL, g_free);
+
+	g_hash_table_insert(llcp_socket_owners, GUINT_TO_POINTER(socket), g_strdup(id));
+
+	pthread_mutex_unlock(&llcp_socket_owners_lock);
+}
+
+static void llcp_socket_remove_owner(net_nfc_llcp_socket_t socket)
+{
+	pthread_mutex_lock(&llcp_socket_owners_lock);
+
+	if (llcp_socket_owners != NULL)
+		g_hash_table_remove(llcp_socket_owners, GUINT_TO_POINTER(socket));
+
+	pthread_mutex_unlock(&llcp_socket_owners_lock);
+}
+
+static bool llcp_socket_is_owner(net_nfc_llcp_socket_t socket, const char *id)
+{
+	bool result = false;
+
+	pthread_mutex_lock(&llcp_socket_owners_lock);
+
+	if (llcp_socket_owners != NULL)
+		result = (g_strcmp0(g_hash_table_lookup(llcp_socket_owners,
+						GUINT_TO_POINTER(socket)), id) == 0);
+
+	pthread_mutex_unlock(&llcp_socket_owners_lock);
+
+	return result;
+}
+
 static void llcp_socket_error_cb(net_nfc_llcp_socket_t socket,
 		net_nfc_error_e result, data_s *data, void *extra, void *user_param)
 {
@@ -244,6 +338,9 @@ static void llcp_incoming_cb(net_nfc_llcp_socket_t socket,
 	GError *error = NULL;
 	llcp_client_data *client_data = user_param;
 
+	/* the incoming socket goes to the client of the listening socket */
+	llcp_socket_set_owner(socket, client_data->id);
+
 	ret = g_dbus_connection_emit_signal(
 				client_data->connection,
 				client_data->id,
@@ -303,19 +400,35 @@ static void llcp_connect_cb(net_nfc_llcp_socket_t socket,
 	g_free(llcp_data);
 }
 
-static void llcp_send_cb(net_nfc_llcp_socket_t socket,
-		net_nfc_error_e result, data_s *data, void *extra, void *user_param)
+static void llcp_send_complete(LlcpSendData *llcp_data,
+		net_nfc_error_e result, guint32 socket)
 {
-	LlcpSendData *llcp_data = user_param;
+	if (llcp_data->mapped != NULL)
+		net_nfc_gdbus_llcp_complete_send_fd(llcp_data->llcp,
+				llcp_data->invocation, NULL, result, socket);
+	else
+		net_nfc_gdbus_llcp_complete_send(llcp_data->llcp,
+				llcp_data->invocation, result, socket);
 
-	g_assert(llcp_data != NULL);
-	g_assert(llcp_data->llcp != NULL);
-	g_assert(llcp_data->invocation != NULL);
+	net_nfc_util_gdbus_release_data_s(&llcp_data->data, llcp_data->mapped);
 
-	net_nfc_gdbus_llcp_complete_send(llcp_data->llcp, llcp_data->invocation,
-			result, socket);
+	g_object_unref(llcp_data->invocation);
+	g_object_unref(llcp_data->llcp);
 
-	net_nfc_util_free_data(&llcp_data->data);
+	g_free(llcp_data);
+}
+
+static void llcp_send_to_complete(LlcpSendToData *llcp_data,
+		net_nfc_error_e result, guint32 socket)
+{
+	if (llcp_data->mapped != NULL)
+		net_nfc_gdbus_llcp_complete_send_to_fd(llcp_data->llcp,
+				llcp_data->invocation, NULL, result, socket);
+	else
+		net_nfc_gdbus_llcp_complete_send_to(llcp_data->llcp,
+				llcp_data->invocation, result, socket);
+
+	net_nfc_util_gdbus_release_data_s(&llcp_data->data, llcp_data->mapped);
 
 	g_object_unref(llcp_data->invocation);
 	g_object_unref(llcp_data->llcp);
@@ -323,24 +436,28 @@ static void llcp_send_cb(net_nfc_llcp_socket_t socket,
 	g_free(llcp_data);
 }
 
-static void llcp_send_to_cb(net_nfc_llcp_socket_t socket,
+static void llcp_send_cb(net_nfc_llcp_socket_t socket,
 		net_nfc_error_e result, data_s *data, void *extra, void *user_param)
 {
-	LlcpSendToData *llcp_data = user_param;
+	LlcpSendData *llcp_data = user_param;
 
 	g_assert(llcp_data != NULL);
 	g_assert(llcp_data->llcp != NULL);
 	g_assert(llcp_data->invocation != NULL);
 
-	net_nfc_gdbus_llcp_complete_send_to(llcp_data->llcp, llcp_data->invocation,
-			result, socket);
+	llcp_send_complete(llcp_data, result, socket);
+}
 
-	net_nfc_util_free_data(&llcp_data->data);
+static void llcp_send_to_cb(net_nfc_llcp_socket_t socket,
+		net_nfc_error_e result, data_s *data, void *extra, void *user_param)
+{
+	LlcpSendToData *llcp_data = user_param;
 
-	g_object_unref(llcp_data->invocation);
-	g_object_unref(llcp_data->llcp);
+	g_assert(llcp_data != NULL);
+	g_assert(llcp_data->llcp != NULL);
+	g_assert(llcp_data->invocation != NULL);
 
-	g_free(llcp_data);
+	llcp_send_to_complete(llcp_data, result, socket);
 }
 
 static void llcp_receive_cb(net_nfc_llcp_socket_t socket, net_nfc_error_e result,
@@ -440,6 +557,7 @@ static void llcp_handle_listen_thread_func(gpointer user_data)
 	}
 
 	client_data->socket = socket;
+	llcp_socket_set_owner(socket, client_data->id);
 
 	if (net_nfc_controller_llcp_bind(socket, data->sap, &result) == false)
 	{
@@ -476,7 +594,10 @@ ERROR :
 	net_nfc_gdbus_llcp_complete_listen(data->llcp, data->invocation, result, -1);
 
 	if (socket != -1)
+	{
+		llcp_socket_remove_owner(socket);
 		net_nfc_controller_llcp_socket_close(socket, &result);
+	}
 
 	g_free(client_data);
 
@@ -603,6 +724,7 @@ static void llcp_handle_connect_thread_func(gpointer user_data)
 	}
 
 	client_data->socket = socket;
+	llcp_socket_set_owner(socket, client_data->id);
 
 	ret = net_nfc_controller_llcp_connect_by_url(
 				GUINT_TO_POINTER(data->handle),
@@ -630,7 +752,10 @@ ERROR :
 	net_nfc_gdbus_llcp_complete_connect(data->llcp, data->invocation, result, -1);
 
 	if (socket != -1)
+	{
+		llcp_socket_remove_owner(socket);
 		net_nfc_controller_llcp_socket_close(socket, &result);
+	}
 
 	g_free(client_data);
 
@@ -677,6 +802,7 @@ static void llcp_handle_connect_sap_thread_func(gpointer user_data)
 	}
 
 	client_data->socket = socket;
+	llcp_socket_set_owner(socket, client_data->id);
 
 	ret = net_nfc_controller_llcp_connect(GUINT_TO_POINTER(data->handle), socket,
 				data->sap, &result, llcp_connect_cb, data);
@@ -699,7 +825,10 @@ ERROR :
 	net_nfc_gdbus_llcp_complete_connect_sap(data->llcp, data->invocation, result, -1);
 
 	if (socket != -1)
+	{
+		llcp_socket_remove_owner(socket);
 		net_nfc_controller_llcp_socket_close(socket, &result);
+	}
 
 	g_free(client_data);
 
@@ -726,15 +855,7 @@ static void llcp_handle_send_thread_func(gpointer user_data)
 	{
 		NFC_ERR("net_nfc_controller_llcp_send failed [%d]", result);
 
-		net_nfc_gdbus_llcp_complete_send(data->llcp, data->invocation, result,
-				data->client_socket);
-
-		net_nfc_util_free_data(&data->data);
-
-		g_object_unref(data->invocation);
-		g_object_unref(data->llcp);
-
-		g_free(data);
+		llcp_send_complete(data, result, data->client_socket);
 	}
 }
 
@@ -760,15 +881,7 @@ static void llcp_handle_send_to_thread_func(gpointer user_data)
 	{
 		NFC_ERR("net_nfc_controller_llcp_send_to failed [%d]", result);
 
-		net_nfc_gdbus_llcp_complete_send_to(data->llcp, data->invocation, result,
-				data->client_socket);
-
-		net_nfc_util_free_data(&data->data);
-
-		g_object_unref(data->invocation);
-		g_object_unref(data->llcp);
-
-		g_free(data);
+		llcp_send_to_complete(data, result, data->client_socket);
 	}
 }
 
@@ -843,6 +956,7 @@ static void llcp_handle_close_thread_func(gpointer user_data)
 	g_assert(data->llcp != NULL);
 	g_assert(data->invocation != NULL);
 
+	llcp_socket_remove_owner(data->client_socket);
 	net_nfc_controller_llcp_socket_close(data->client_socket, &result);
 
 	net_nfc_gdbus_llcp_complete_close(data->llcp, data->invocation, result,
@@ -885,6 +999,350 @@ static void llcp_handle_disconnect_thread_func(gpointer user_data)
 	}
 }
 
+static LlcpStream *llcp_stream_ref(LlcpStream *stream)
+{
+	g_atomic_int_inc(&stream->ref_count);
+
+	return stream;
+}
+
+static void llcp_stream_unref(LlcpStream *stream)
+{
+	if (g_atomic_int_dec_and_test(&stream->ref_count) == FALSE)
+		return;
+
+	g_free(stream->pending.buffer);
+	g_free(stream);
+}
+
+static void llcp_stream_job_free(LlcpStreamJob *job)
+{
+	llcp_stream_unref(job->stream);
+
+	g_free(job->data.buffer);
+	g_free(job);
+}
+
+static void llcp_stream_close(LlcpStream *stream)
+{
+	if (stream->closed)
+		return;
+
+	NFC_DBG("stream of socket [%x] closed, in flight [%d]",
+			stream->client_socket, stream->in_flight);
+
+	stream->closed = true;
+
+	if (stream->in_source > 0)
+	{
+		g_source_remove(stream->in_source);
+		stream->in_source = 0;
+	}
+
+	if (stream->out_source > 0)
+	{
+		g_source_remove(stream->out_source);
+		stream->out_source = 0;
+	}
+
+	close(stream->fd);
+	stream->fd = -1;
+
+	/* drops the reference of the table, jobs in flight hold their own */
+	g_hash_table_remove(llcp_streams, GUINT_TO_POINTER(stream->client_socket));
+}
+
+static void llcp_stream_close_socket(guint32 client_socket)
+{
+	LlcpStream *stream;
+
+	if (NULL == llcp_streams)
+		return;
+
+	stream = g_hash_table_lookup(llcp_streams, GUINT_TO_POINTER(client_socket));
+	if (stream != NULL)
+		llcp_stream_close(stream);
+}
+
+static gboolean llcp_stream_close_all(gpointer user_data)
+{
+	GList *streams, *pos;
+
+	if (NULL == llcp_streams)
+		return G_SOURCE_REMOVE;
+
+	streams = g_hash_table_get_values(llcp_streams);
+
+	for (pos = streams; pos != NULL; pos = pos->next)
+		llcp_stream_close(pos->data);
+
+	g_list_free(streams);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void llcp_stream_receive(LlcpStream *stream);
+static gboolean llcp_stream_readable(gint fd, GIOCondition condition,
+		gpointer user_data);
+
+/* LlcpStreamJob completions run here, in the main loop, so the stream
+   state needs no lock */
+static gboolean llcp_stream_send_done(gpointer user_data)
+{
+	LlcpStreamJob *job = user_data;
+	LlcpStream *stream = job->stream;
+
+	stream->in_flight--;
+
+	if (stream->closed == false)
+	{
+		if (job->result != NET_NFC_OK)
+		{
+			NFC_ERR("stream send failed [%d]", job->result);
+
+			llcp_stream_close(stream);
+		}
+		else if (0 == stream->in_source)
+		{
+			stream->in_source = g_unix_fd_add(stream->fd,
+					G_IO_IN | G_IO_HUP | G_IO_ERR, llcp_stream_readable, stream);
+		}
+	}
+
+	llcp_stream_job_free(job);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void llcp_stream_send_cb(net_nfc_llcp_socket_t socket,
+		net_nfc_error_e result, data_s *data, void *extra, void *user_param)
+{
+	LlcpStreamJob *job = user_param;
+
+	g_assert(job != NULL);
+
+	job->result = result;
+
+	g_idle_add(llcp_stream_send_done, job);
+}
+
+static void llcp_stream_send_thread_func(gpointer user_data)
+{
+	bool ret;
+	net_nfc_error_e result;
+	LlcpStreamJob *job = user_data;
+
+	g_assert(job != NULL);
+
+	ret = net_nfc_controller_llcp_send(GUINT_TO_POINTER(job->stream->handle),
+			job->stream->client_socket, &job->data, &result,
+			llcp_stream_send_cb, job);
+	if (false == ret)
+	{
+		NFC_ERR("net_nfc_controller_llcp_send failed [%d]", result);
+
+		job->result = result;
+
+		g_idle_add(llcp_stream_send_done, job);
+	}
+}
+
+static gboolean llcp_stream_readable(gint fd, GIOCondition condition,
+		gpointer user_data)
+{
+	LlcpStream *stream = user_data;
+
+	/* keep up to rw pdus queued to the controller */
+	while (stream->in_flight < stream->rw)
+	{
+		ssize_t length;
+		LlcpStreamJob *job;
+		guint8 *buffer;
+
+		buffer = g_malloc(stream->miu);
+
+		length = recv(fd, buffer, stream->miu, MSG_DONTWAIT | MSG_TRUNC);
+		if (length <= 0 || length > stream->miu)
+		{
+			g_free(buffer);
+
+			if (length < 0 && (EAGAIN == errno || EINTR == errno))
+				return G_SOURCE_CONTINUE;
+
+			if (length > stream->miu)
+				NFC_ERR("pdu of %zd bytes exceeds miu [%d]", length, stream->miu);
+
+			/* the client closed its end */
+			stream->in_source = 0;
+			llcp_stream_close(stream);
+
+			return G_SOURCE_REMOVE;
+		}
+
+		job = g_new0(LlcpStreamJob, 1);
+		job->stream = llcp_stream_ref(stream);
+		job->data.buffer = buffer;
+		job->data.length = length;
+
+		if (net_nfc_server_controller_async_queue_push_handle(
+					NET_NFC_CONTROLLER_PRIORITY_P2P,
+					GUINT_TO_POINTER(job->stream->handle),
+					llcp_stream_send_thread_func, job) == FALSE)
+		{
+			NFC_ERR("can not push to controller thread");
+
+			llcp_stream_job_free(job);
+
+			stream->in_source = 0;
+			llcp_stream_close(stream);
+
+			return G_SOURCE_REMOVE;
+		}
+
+		stream->in_flight++;
+	}
+
+	/* window is full, llcp_stream_send_done() resumes reading */
+	stream->in_source = 0;
+
+	return G_SOURCE_REMOVE;
+}
+
+static gboolean llcp_stream_writable(gint fd, GIOCondition condition,
+		gpointer user_data)
+{
+	ssize_t length;
+	LlcpStream *stream = user_data;
+
+	length = send(fd, stream->pending.buffer, stream->pending.length,
+			MSG_DONTWAIT | MSG_NOSIGNAL);
+	if (length < 0 && (EAGAIN == errno || EINTR == errno))
+		return G_SOURCE_CONTINUE;
+
+	g_free(stream->pending.buffer);
+	stream->pending.buffer = NULL;
+	stream->pending.length = 0;
+
+	stream->out_source = 0;
+
+	if (length < 0)
+		llcp_stream_close(stream);
+	else
+		llcp_stream_receive(stream);
+
+	return G_SOURCE_REMOVE;
+}
+
+static gboolean llcp_stream_receive_done(gpointer user_data)
+{
+	ssize_t length = 0;
+	LlcpStreamJob *job = user_data;
+	LlcpStream *stream = job->stream;
+
+	if (stream->closed)
+	{
+		llcp_stream_job_free(job);
+
+		return G_SOURCE_REMOVE;
+	}
+
+	if (job->result != NET_NFC_OK)
+	{
+		NFC_ERR("stream receive failed [%d]", job->result);
+
+		llcp_stream_close(stream);
+		llcp_stream_job_free(job);
+
+		return G_SOURCE_REMOVE;
+	}
+
+	/* an empty packet would read as end of stream */
+	if (job->data.length > 0)
+		length = send(stream->fd, job->data.buffer, job->data.length,
+				MSG_DONTWAIT | MSG_NOSIGNAL);
+
+	if (length < 0 && (EAGAIN == errno || EINTR == errno))
+	{
+		/* hold further receives until the client catches up */
+		stream->pending = job->data;
+		job->data.buffer = NULL;
+
+		stream->out_source = g_unix_fd_add(stream->fd, G_IO_OUT,
+				llcp_stream_writable, stream);
+	}
+	else if (length < 0)
+	{
+		llcp_stream_close(stream);
+	}
+	else
+	{
+		llcp_stream_receive(stream);
+	}
+
+	llcp_stream_job_free(job);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void llcp_stream_receive_cb(net_nfc_llcp_socket_t socket,
+		net_nfc_error_e result, data_s *data, void *extra, void *user_param)
+{
+	LlcpStreamJob *job = user_param;
+
+	g_assert(job != NULL);
+
+	job->result = result;
+
+	/* data belongs to the controller once we return */
+	if (NET_NFC_OK == result && data != NULL && data->length > 0)
+	{
+		job->data.buffer = g_memdup(data->buffer, data->length);
+		job->data.length = data->length;
+	}
+
+	g_idle_add(llcp_stream_receive_done, job);
+}
+
+static void llcp_stream_receive_thread_func(gpointer user_data)
+{
+	bool ret;
+	net_nfc_error_e result;
+	LlcpStreamJob *job = user_data;
+
+	g_assert(job != NULL);
+
+	ret = net_nfc_controller_llcp_recv(GUINT_TO_POINTER(job->stream->handle),
+			job->stream->client_socket, net_nfc_server_llcp_get_miu(), &result,
+			llcp_stream_receive_cb, job);
+	if (false == ret)
+	{
+		NFC_ERR("net_nfc_controller_llcp_recv failed [%d]", result);
+
+		job->result = result;
+
+		g_idle_add(llcp_stream_receive_done, job);
+	}
+}
+
+static void llcp_stream_receive(LlcpStream *stream)
+{
+	LlcpStreamJob *job;
+
+	job = g_new0(LlcpStreamJob, 1);
+	job->stream = llcp_stream_ref(stream);
+
+	if (net_nfc_server_controller_async_queue_push_handle(
+				NET_NFC_CONTROLLER_PRIORITY_P2P,
+				GUINT_TO_POINTER(job->stream->handle),
+				llcp_stream_receive_thread_func, job) == FALSE)
+	{
+		NFC_ERR("can not push to controller thread");
+
+		llcp_stream_close(stream);
+		llcp_stream_job_free(job);
+	}
+}
+
 static gboolean llcp_handle_listen(NetNfcGDbusLlcp *llcp,
 		GDBusMethodInvocation *invocation,
 		guint32 arg_handle,
@@ -933,8 +1391,9 @@ static gboolean llcp_handle_listen(NetNfcGDbusLlcp *llcp,
 	data->sap = arg_sap;
 	data->service_name = g_strdup(arg_service_name);
 
-	result = net_nfc_server_controller_async_queue_push(llcp_handle_listen_thread_func,
-			data);
+	result = net_nfc_server_controller_async_queue_push_handle(
+			NET_NFC_CONTROLLER_PRIORITY_P2P, GUINT_TO_POINTER(data->handle),
+			llcp_handle_listen_thread_func, data);
 
 	if (FALSE == result)
 	{
@@ -991,8 +1450,9 @@ static gboolean llcp_handle_accept(NetNfcGDbusLlcp *llcp,
 	data->handle = arg_handle;
 	data->client_socket = arg_client_socket;
 
-	result = net_nfc_server_controller_async_queue_push(llcp_handle_accept_thread_func,
-			data);
+	result = net_nfc_server_controller_async_queue_push_handle(
+			NET_NFC_CONTROLLER_PRIORITY_P2P, GUINT_TO_POINTER(data->handle),
+			llcp_handle_accept_thread_func, data);
 
 	if (FALSE == result)
 	{
@@ -1046,8 +1506,9 @@ static gboolean llcp_handle_reject(NetNfcGDbusLlcp *llcp,
 	data->handle = arg_handle;
 	data->client_socket = arg_client_socket;
 
-	result = net_nfc_server_controller_async_queue_push(llcp_handle_reject_thread_func,
-			data);
+	result = net_nfc_server_controller_async_queue_push_handle(
+			NET_NFC_CONTROLLER_PRIORITY_P2P, GUINT_TO_POINTER(data->handle),
+			llcp_handle_reject_thread_func, data);
 
 	if (FALSE == result)
 	{
@@ -1109,8 +1570,9 @@ static gboolean llcp_handle_connect(NetNfcGDbusLlcp *llcp,
 	data->type = arg_type;
 	data->service_name = g_strdup(arg_service_name);
 
-	result = net_nfc_server_controller_async_queue_push(llcp_handle_connect_thread_func,
-			data);
+	result = net_nfc_server_controller_async_queue_push_handle(
+			NET_NFC_CONTROLLER_PRIORITY_P2P, GUINT_TO_POINTER(data->handle),
+			llcp_handle_connect_thread_func, data);
 
 	if (FALSE == result)
 	{
@@ -1174,7 +1636,8 @@ static gboolean llcp_handle_connect_sap(NetNfcGDbusLlcp *llcp,
 	data->type = arg_type;
 	data->sap = arg_sap;
 
-	result = net_nfc_server_controller_async_queue_push(
+	result = net_nfc_server_controller_async_queue_push_handle(
+			NET_NFC_CONTROLLER_PRIORITY_P2P, GUINT_TO_POINTER(data->handle),
 			llcp_handle_connect_sap_thread_func, data);
 
 	if (FALSE == result)
@@ -1192,36 +1655,24 @@ static gboolean llcp_handle_connect_sap(NetNfcGDbusLlcp *llcp,
 	return result;
 }
 
-static gboolean llcp_handle_send(NetNfcGDbusLlcp *llcp,
+static gboolean llcp_send_push(NetNfcGDbusLlcp *llcp,
 		GDBusMethodInvocation *invocation,
 		guint32 arg_handle,
 		guint32 arg_client_socket,
-		GVariant *arg_data,
-		GVariant *smack_privilege,
-		gpointer user_data)
+		data_s *arg_data,
+		GMappedFile *mapped)
 {
-	bool ret;
 	gboolean result;
 	LlcpSendData *data;
 
-	NFC_INFO(">>> REQUEST from [%s]", g_dbus_method_invocation_get_sender(invocation));
-
-	/* check privilege and update client context */
-	ret = net_nfc_server_gdbus_check_privilege(invocation, smack_privilege,
-				"nfc-manager::p2p", "w");
-	if (false == ret)
-	{
-		NFC_ERR("permission denied, and finished request");
-
-		return FALSE;
-	}
-
 	data = g_try_new0(LlcpSendData, 1);
 	if (NULL == data)
 	{
 		g_dbus_method_invocation_return_dbus_error(invocation,
 				"org.tizen.NetNfcService.AllocationError", "Can not allocate memory");
 
+		net_nfc_util_gdbus_release_data_s(arg_data, mapped);
+
 		return FALSE;
 	}
 
@@ -1229,11 +1680,12 @@ static gboolean llcp_handle_send(NetNfcGDbusLlcp *llcp,
 	data->invocation = g_object_ref(invocation);
 	data->handle = arg_handle;
 	data->client_socket = arg_client_socket;
+	data->data = *arg_data;
+	data->mapped = mapped;
 
-	net_nfc_util_gdbus_variant_to_data_s(arg_data, &data->data);
-
-	result = net_nfc_server_controller_async_queue_push(llcp_handle_send_thread_func,
-			data);
+	result = net_nfc_server_controller_async_queue_push_handle(
+			NET_NFC_CONTROLLER_PRIORITY_P2P, GUINT_TO_POINTER(data->handle),
+			llcp_handle_send_thread_func, data);
 
 	if (FALSE == result)
 	{
@@ -1241,7 +1693,7 @@ static gboolean llcp_handle_send(NetNfcGDbusLlcp *llcp,
 				"org.tizen.NetNfcService.Llcp.ThreadError",
 				"can not push to controller thread");
 
-		net_nfc_util_free_data(&data->data);
+		net_nfc_util_gdbus_release_data_s(&data->data, data->mapped);
 
 		g_object_unref(data->invocation);
 		g_object_unref(data->llcp);
@@ -1252,24 +1704,22 @@ static gboolean llcp_handle_send(NetNfcGDbusLlcp *llcp,
 	return result;
 }
 
-static gboolean llcp_handle_send_to(NetNfcGDbusLlcp *llcp,
+static gboolean llcp_handle_send(NetNfcGDbusLlcp *llcp,
 		GDBusMethodInvocation *invocation,
 		guint32 arg_handle,
 		guint32 arg_client_socket,
-		guint8 arg_sap,
 		GVariant *arg_data,
 		GVariant *smack_privilege,
 		gpointer user_data)
 {
 	bool ret;
-	gboolean result;
-	LlcpSendToData *data;
+	data_s data = { NULL, 0 };
 
 	NFC_INFO(">>> REQUEST from [%s]", g_dbus_method_invocation_get_sender(invocation));
 
 	/* check privilege and update client context */
 	ret = net_nfc_server_gdbus_check_privilege(invocation, smack_privilege,
-				"nfc-manager::p2p", "rw");
+				"nfc-manager::p2p", "w");
 	if (false == ret)
 	{
 		NFC_ERR("permission denied, and finished request");
@@ -1277,12 +1727,69 @@ static gboolean llcp_handle_send_to(NetNfcGDbusLlcp *llcp,
 		return FALSE;
 	}
 
+	net_nfc_util_gdbus_variant_to_data_s(arg_data, &data);
+
+	return llcp_send_push(llcp, invocation, arg_handle, arg_client_socket,
+			&data, NULL);
+}
+
+static gboolean llcp_handle_send_fd(NetNfcGDbusLlcp *llcp,
+		GDBusMethodInvocation *invocation,
+		GUnixFDList *fd_list,
+		guint32 arg_handle,
+		guint32 arg_client_socket,
+		gint32 arg_data,
+		GVariant *smack_privilege,
+		gpointer user_data)
+{
+	bool ret;
+	GMappedFile *mapped;
+	data_s data = { NULL, 0 };
+
+	NFC_INFO(">>> REQUEST from [%s]", g_dbus_method_invocation_get_sender(invocation));
+
+	/* check privilege and update client context */
+	ret = net_nfc_server_gdbus_check_privilege(invocation, smack_privilege,
+				"nfc-manager::p2p", "w");
+	if (false == ret)
+	{
+		NFC_ERR("permission denied, and finished request");
+
+		return FALSE;
+	}
+
+	mapped = net_nfc_util_gdbus_fd_list_to_data_s(fd_list, arg_data, &data);
+	if (NULL == mapped)
+	{
+		g_dbus_method_invocation_return_dbus_error(invocation,
+				"org.tizen.NetNfcService.Llcp.DataError", "Can not map data");
+
+		return FALSE;
+	}
+
+	return llcp_send_push(llcp, invocation, arg_handle, arg_client_socket,
+			&data, mapped);
+}
+
+static gboolean llcp_send_to_push(NetNfcGDbusLlcp *llcp,
+		GDBusMethodInvocation *invocation,
+		guint32 arg_handle,
+		guint32 arg_client_socket,
+		guint8 arg_sap,
+		data_s *arg_data,
+		GMappedFile *mapped)
+{
+	gboolean result;
+	LlcpSendToData *data;
+
 	data = g_try_new0(LlcpSendToData, 1);
 	if (NULL == data)
 	{
 		g_dbus_method_invocation_return_dbus_error(invocation,
 				"org.tizen.NetNfcService.AllocationError", "Can not allocate memory");
 
+		net_nfc_util_gdbus_release_data_s(arg_data, mapped);
+
 		return FALSE;
 	}
 
@@ -1291,11 +1798,12 @@ static gboolean llcp_handle_send_to(NetNfcGDbusLlcp *llcp,
 	data->handle = arg_handle;
 	data->client_socket = arg_client_socket;
 	data->sap = arg_sap;
+	data->data = *arg_data;
+	data->mapped = mapped;
 
-	net_nfc_util_gdbus_variant_to_data_s(arg_data, &data->data);
-
-	result = net_nfc_server_controller_async_queue_push(llcp_handle_send_to_thread_func,
-			data);
+	result = net_nfc_server_controller_async_queue_push_handle(
+			NET_NFC_CONTROLLER_PRIORITY_P2P, GUINT_TO_POINTER(data->handle),
+			llcp_handle_send_to_thread_func, data);
 
 	if (FALSE == result)
 	{
@@ -1303,7 +1811,7 @@ static gboolean llcp_handle_send_to(NetNfcGDbusLlcp *llcp,
 				"org.tizen.NetNfcService.Llcp.ThreadError",
 				"can not push to controller thread");
 
-		net_nfc_util_free_data(&data->data);
+		net_nfc_util_gdbus_release_data_s(&data->data, data->mapped);
 
 		g_object_unref(data->invocation);
 		g_object_unref(data->llcp);
@@ -1314,6 +1822,75 @@ static gboolean llcp_handle_send_to(NetNfcGDbusLlcp *llcp,
 	return result;
 }
 
+static gboolean llcp_handle_send_to(NetNfcGDbusLlcp *llcp,
+		GDBusMethodInvocation *invocation,
+		guint32 arg_handle,
+		guint32 arg_client_socket,
+		guint8 arg_sap,
+		GVariant *arg_data,
+		GVariant *smack_privilege,
+		gpointer user_data)
+{
+	bool ret;
+	data_s data = { NULL, 0 };
+
+	NFC_INFO(">>> REQUEST from [%s]", g_dbus_method_invocation_get_sender(invocation));
+
+	/* check privilege and update client context */
+	ret = net_nfc_server_gdbus_check_privilege(invocation, smack_privilege,
+				"nfc-manager::p2p", "rw");
+	if (false == ret)
+	{
+		NFC_ERR("permission denied, and finished request");
+
+		return FALSE;
+	}
+
+	net_nfc_util_gdbus_variant_to_data_s(arg_data, &data);
+
+	return llcp_send_to_push(llcp, invocation, arg_handle, arg_client_socket,
+			arg_sap, &data, NULL);
+}
+
+static gboolean llcp_handle_send_to_fd(NetNfcGDbusLlcp *llcp,
+		GDBusMethodInvocation *invocation,
+		GUnixFDList *fd_list,
+		guint32 arg_handle,
+		guint32 arg_client_socket,
+		guint8 arg_sap,
+		gint32 arg_data,
+		GVariant *smack_privilege,
+		gpointer user_data)
+{
+	bool ret;
+	GMappedFile *mapped;
+	data_s data = { NULL, 0 };
+
+	NFC_INFO(">>> REQUEST from [%s]", g_dbus_method_invocation_get_sender(invocation));
+
+	/* check privilege and update client context */
+	ret = net_nfc_server_gdbus_check_privilege(invocation, smack_privilege,
+				"nfc-manager::p2p", "rw");
+	if (false == ret)
+	{
+		NFC_ERR("permission denied, and finished request");
+
+		return FALSE;
+	}
+
+	mapped = net_nfc_util_gdbus_fd_list_to_data_s(fd_list, arg_data, &data);
+	if (NULL == mapped)
+	{
+		g_dbus_method_invocation_return_dbus_error(invocation,
+				"org.tizen.NetNfcService.Llcp.DataError", "Can not map data");
+
+		return FALSE;
+	}
+
+	return llcp_send_to_push(llcp, invocation, arg_handle, arg_client_socket,
+			arg_sap, &data, mapped);
+}
+
 static gboolean llcp_handle_receive(NetNfcGDbusLlcp *llcp,
 		GDBusMethodInvocation *invocation,
 		guint32 arg_handle,
@@ -1354,8 +1931,9 @@ static gboolean llcp_handle_receive(NetNfcGDbusLlcp *llcp,
 	data->client_socket = arg_client_socket;
 	data->req_length = arg_req_length;
 
-	result = net_nfc_server_controller_async_queue_push(llcp_handle_receive_thread_func,
-			data);
+	result = net_nfc_server_controller_async_queue_push_handle(
+			NET_NFC_CONTROLLER_PRIORITY_P2P, GUINT_TO_POINTER(data->handle),
+			llcp_handle_receive_thread_func, data);
 	if (FALSE == result)
 	{
 		g_dbus_method_invocation_return_dbus_error(invocation,
@@ -1411,7 +1989,8 @@ static gboolean llcp_handle_receive_from(NetNfcGDbusLlcp *llcp,
 	data->client_socket = arg_client_socket;
 	data->req_length = arg_req_length;
 
-	result = net_nfc_server_controller_async_queue_push(
+	result = net_nfc_server_controller_async_queue_push_handle(
+			NET_NFC_CONTROLLER_PRIORITY_P2P, GUINT_TO_POINTER(data->handle),
 			llcp_handle_receive_from_thread_func, data);
 	if (FALSE == result)
 	{
@@ -1428,6 +2007,176 @@ static gboolean llcp_handle_receive_from(NetNfcGDbusLlcp *llcp,
 	return result;
 }
 
+static void llcp_open_stream_data_free(LlcpOpenStreamData *data)
+{
+	g_object_unref(data->invocation);
+	g_object_unref(data->llcp);
+
+	g_free(data);
+}
+
+static gboolean llcp_open_stream_done(gpointer user_data)
+{
+	int fds[2];
+	LlcpStream *stream;
+	GUnixFDList *out_fd_list;
+	LlcpOpenStreamData *data = user_data;
+
+	if (data->result != NET_NFC_OK || 0 == data->option.miu)
+	{
+		NFC_ERR("no remote socket info [%d]", data->result);
+
+		net_nfc_gdbus_llcp_complete_open_stream(data->llcp, data->invocation,
+				NULL, data->result != NET_NFC_OK ? data->result :
+				NET_NFC_OPERATION_FAIL, -1);
+
+		goto END;
+	}
+
+	if (NULL == llcp_streams)
+		llcp_streams = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+				NULL, (GDestroyNotify)llcp_stream_unref);
+
+	/* checked again, another request may have opened it meanwhile */
+	if (g_hash_table_lookup(llcp_streams, GUINT_TO_POINTER(data->client_socket)))
+	{
+		net_nfc_gdbus_llcp_complete_open_stream(data->llcp, data->invocation,
+				NULL, NET_NFC_ALREADY_REGISTERED, -1);
+
+		goto END;
+	}
+
+	if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, fds) < 0)
+	{
+		NFC_ERR("socketpair failed [%d]", errno);
+
+		g_dbus_method_invocation_return_dbus_error(data->invocation,
+				"org.tizen.NetNfcService.Llcp.DataError", "Can not create stream");
+
+		goto END;
+	}
+
+	stream = g_new0(LlcpStream, 1);
+	stream->ref_count = 1;
+	stream->handle = data->handle;
+	stream->client_socket = data->client_socket;
+	stream->miu = data->option.miu;
+	stream->rw = MAX(data->option.rw, 1);
+	stream->fd = fds[0];
+
+	g_hash_table_insert(llcp_streams, GUINT_TO_POINTER(data->client_socket), stream);
+
+	stream->in_source = g_unix_fd_add(stream->fd, G_IO_IN | G_IO_HUP | G_IO_ERR,
+			llcp_stream_readable, stream);
+
+	llcp_stream_receive(stream);
+
+	/* the list owns the client end from here */
+	out_fd_list = g_unix_fd_list_new_from_array(&fds[1], 1);
+
+	net_nfc_gdbus_llcp_complete_open_stream(data->llcp, data->invocation,
+			out_fd_list, NET_NFC_OK, 0);
+
+	g_object_unref(out_fd_list);
+
+END :
+	llcp_open_stream_data_free(data);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void llcp_handle_open_stream_thread_func(gpointer user_data)
+{
+	LlcpOpenStreamData *data = user_data;
+
+	g_assert(data != NULL);
+
+	/* PDUs go out within the miu and rw the peer gave for the connection */
+	if (net_nfc_controller_llcp_get_remote_socket_info(
+				GUINT_TO_POINTER(data->handle), data->client_socket,
+				&data->option, &data->result) == false)
+	{
+		NFC_ERR("net_nfc_controller_llcp_get_remote_socket_info failed [%d]",
+				data->result);
+	}
+
+	g_idle_add(llcp_open_stream_done, data);
+}
+
+static gboolean llcp_handle_open_stream(NetNfcGDbusLlcp *llcp,
+		GDBusMethodInvocation *invocation,
+		GUnixFDList *fd_list,
+		guint32 arg_handle,
+		guint32 arg_client_socket,
+		GVariant *smack_privilege,
+		gpointer user_data)
+{
+	bool ret;
+	gboolean result;
+	LlcpOpenStreamData *data;
+
+	NFC_INFO(">>> REQUEST from [%s]", g_dbus_method_invocation_get_sender(invocation));
+
+	/* check privilege and update client context */
+	ret = net_nfc_server_gdbus_check_privilege(invocation, smack_privilege,
+				"nfc-manager::p2p", "w");
+	if (false == ret)
+	{
+		NFC_ERR("permission denied, and finished request");
+
+		return FALSE;
+	}
+
+	if (llcp_socket_is_owner(arg_client_socket,
+				g_dbus_method_invocation_get_sender(invocation)) == false)
+	{
+		NFC_ERR("socket [%x] is not a socket of the caller", arg_client_socket);
+
+		net_nfc_gdbus_llcp_complete_open_stream(llcp, invocation, NULL,
+				NET_NFC_LLCP_INVALID_SOCKET, -1);
+
+		return TRUE;
+	}
+
+	if (llcp_streams != NULL &&
+			g_hash_table_lookup(llcp_streams, GUINT_TO_POINTER(arg_client_socket)))
+	{
+		net_nfc_gdbus_llcp_complete_open_stream(llcp, invocation, NULL,
+				NET_NFC_ALREADY_REGISTERED, -1);
+
+		return TRUE;
+	}
+
+	data = g_try_new0(LlcpOpenStreamData, 1);
+	if (NULL == data)
+	{
+		g_dbus_method_invocation_return_dbus_error(invocation,
+				"org.tizen.NetNfcService.AllocationError", "Can not allocate memory");
+
+		return FALSE;
+	}
+
+	data->llcp = g_object_ref(llcp);
+	data->invocation = g_object_ref(invocation);
+	data->handle = arg_handle;
+	data->client_socket = arg_client_socket;
+	data->result = NET_NFC_OK;
+
+	result = net_nfc_server_controller_async_queue_push_handle(
+			NET_NFC_CONTROLLER_PRIORITY_P2P, GUINT_TO_POINTER(data->handle),
+			llcp_handle_open_stream_thread_func, data);
+	if (FALSE == result)
+	{
+		g_dbus_method_invocation_return_dbus_error(invocation,
+				"org.tizen.NetNfcService.Llcp.ThreadError",
+				"can not push to controller thread");
+
+		llcp_open_stream_data_free(data);
+	}
+
+	return result;
+}
+
 static gboolean llcp_handle_close(NetNfcGDbusLlcp *llcp,
 		GDBusMethodInvocation *invocation,
 		guint32 arg_handle,
@@ -1451,6 +2200,9 @@ static gboolean llcp_handle_close(NetNfcGDbusLlcp *llcp,
 		return FALSE;
 	}
 
+	/* the stream goes with the socket */
+	llcp_stream_close_socket(arg_client_socket);
+
 	data = g_try_new0(LlcpCloseData, 1);
 	if (NULL == data)
 	{
@@ -1465,8 +2217,9 @@ static gboolean llcp_handle_close(NetNfcGDbusLlcp *llcp,
 	data->handle = arg_handle;
 	data->client_socket = arg_client_socket;
 
-	result = net_nfc_server_controller_async_queue_push(llcp_handle_close_thread_func,
-			data);
+	result = net_nfc_server_controller_async_queue_push_handle(
+			NET_NFC_CONTROLLER_PRIORITY_P2P, GUINT_TO_POINTER(data->handle),
+			llcp_handle_close_thread_func, data);
 
 	if (FALSE == result)
 	{
@@ -1506,6 +2259,9 @@ static gboolean llcp_handle_disconnect(NetNfcGDbusLlcp *llcp,
 		return FALSE;
 	}
 
+	/* the stream goes with the socket */
+	llcp_stream_close_socket(arg_client_socket);
+
 	data = g_try_new0(LlcpDisconnectData, 1);
 	if (NULL == data)
 	{
@@ -1520,8 +2276,9 @@ static gboolean llcp_handle_disconnect(NetNfcGDbusLlcp *llcp,
 	data->handle = arg_handle;
 	data->client_socket = arg_client_socket;
 
-	result = net_nfc_server_controller_async_queue_push(llcp_handle_disconnect_thread_func,
-			data);
+	result = net_nfc_server_controller_async_queue_push_handle(
+			NET_NFC_CONTROLLER_PRIORITY_P2P, GUINT_TO_POINTER(data->handle),
+			llcp_handle_disconnect_thread_func, data);
 
 	if (FALSE == result)
 	{
@@ -1561,6 +2318,9 @@ void net_nfc_server_llcp_deactivated(gpointer user_data)
 		NFC_ERR("the target was disconnected");
 	}
 
+	/* streams of the lost link */
+	g_idle_add(llcp_stream_close_all, NULL);
+
 	/* send p2p detatch */
 	net_nfc_server_p2p_detached();
 }
@@ -1679,15 +2439,24 @@ gboolean net_nfc_server_llcp_init(GDBusConnection *connection)
 
 	g_signal_connect(llcp_skeleton, "handle-send", G_CALLBACK(llcp_handle_send), NULL);
 
+	g_signal_connect(llcp_skeleton, "handle-send-fd",
+			G_CALLBACK(llcp_handle_send_fd), NULL);
+
 	g_signal_connect(llcp_skeleton, "handle-send-to",
 			G_CALLBACK(llcp_handle_send_to), NULL);
 
+	g_signal_connect(llcp_skeleton, "handle-send-to-fd",
+			G_CALLBACK(llcp_handle_send_to_fd), NULL);
+
 	g_signal_connect(llcp_skeleton, "handle-receive",
 			G_CALLBACK(llcp_handle_receive), NULL);
 
 	g_signal_connect(llcp_skeleton, "handle-receive-from",
 			G_CALLBACK(llcp_handle_receive_from), NULL);
 
+	g_signal_connect(llcp_skeleton, "handle-open-stream",
+			G_CALLBACK(llcp_handle_open_stream), NULL);
+
 	g_signal_connect(llcp_skeleton, "handle-close", G_CALLBACK(llcp_handle_close), NULL);
 
 	g_signal_connect(llcp_skeleton, "handle-disconnect",
@@ -1707,6 +2476,24 @@ gboolean net_nfc_server_llcp_init(GDBusConnection *connection)
 
 void net_nfc_server_llcp_deinit(void)
 {
+	if (llcp_streams)
+	{
+		llcp_stream_close_all(NULL);
+
+		g_hash_table_destroy(llcp_streams);
+		llcp_streams = NULL;
+	}
+
+	pthread_mutex_lock(&llcp_socket_owners_lock);
+
+	if (llcp_socket_owners != NULL)
+	{
+		g_hash_table_destroy(llcp_socket_owners);
+		llcp_socket_owners = NULL;
+	}
+
+	pthread_mutex_unlock(&llcp_socket_owners_lock);
+
 	if (llcp_skeleton)
 	{
 		g_object_unref(llcp_skeleton);
@@ -2254,9 +3041,12 @@ static void net_nfc_server_llcp_process(gpointer user_data)
 	net_nfc_target_type_e dev_type;
 #endif
 
-	target = net_nfc_server_get_target_info();
-
-	g_assert(target != NULL); /* raise exception!!! what;s wrong?? */
+	target = net_nfc_server_dup_target_info();
+	if (NULL == target)
+	{
+		NFC_ERR("the target is gone already");
+		return;
+	}
 
 	handle = target->handle;
 
@@ -2301,6 +3091,8 @@ static void net_nfc_server_llcp_process(gpointer user_data)
 		return;
 	}
 #endif
+	g_free(target);
+
 	net_nfc_server_llcp_start_registered_services(handle);
 
 	net_nfc_server_p2p_discovered(handle);
@@ -2310,7 +3102,10 @@ void net_nfc_server_llcp_target_detected(void *info)
 {
 	gboolean ret;
 
-	ret = net_nfc_server_controller_async_queue_push(
+	net_nfc_request_target_detected_t *req = info;
+
+	ret = net_nfc_server_controller_async_queue_push_handle(
+				NET_NFC_CONTROLLER_PRIORITY_DISCOVERY, req->handle,
 				net_nfc_server_llcp_process, NULL);
 
 	if (FALSE == ret)
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <pthread.h>
 #include <vconf.h>
 
 #include "net_nfc_debug_internal.h"
@@ -25,7 +26,9 @@
 #include "net_nfc_server_se.h"
 #include "net_nfc_server_llcp.h"
 #include "net_nfc_server_context.h"
+#include "net_nfc_server_ipc.h"
 #include "net_nfc_server_controller.h"
+#include "net_nfc_server_statistics.h"
 #include "net_nfc_server_process_snep.h"
 #include "net_nfc_server_process_npp.h"
 #include "net_nfc_server_process_handover.h"
@@ -43,6 +46,13 @@ struct _ManagerActivationData
 
 static NetNfcGDbusManager *manager_skeleton = NULL;
 
+/* GetSnapshot values and the ones StateChanged has not sent yet,
+   key -> GVariant. updated from any thread */
+static pthread_mutex_t state_lock = PTHREAD_MUTEX_INITIALIZER;
+static GHashTable *state_values = NULL;
+static GHashTable *state_changed = NULL;
+static guint state_source = 0;
+
 
 /* reimplementation of net_nfc_service_init()*/
 static net_nfc_error_e manager_active(void)
@@ -155,6 +165,8 @@ static void manager_handle_active_thread_func(gpointer user_data)
 		NFC_INFO("nfc %s", data->is_active ? "activated" : "deactivated");
 
 		net_nfc_gdbus_manager_emit_activated(data->manager, data->is_active);
+		net_nfc_server_manager_update_state("activated",
+				g_variant_new_boolean(data->is_active));
 	}
 	else
 	{
@@ -209,7 +221,8 @@ static gboolean manager_handle_set_active(NetNfcGDbusManager *manager,
 	data->invocation = g_object_ref(invocation);
 	data->is_active = arg_is_active;
 
-	result = net_nfc_server_controller_async_queue_push(
+	result = net_nfc_server_controller_async_queue_push_priority(
+			NET_NFC_CONTROLLER_PRIORITY_DISCOVERY,
 			manager_handle_active_thread_func, data);
 	if (FALSE == result)
 	{
@@ -252,6 +265,186 @@ static gboolean manager_handle_get_server_state(NetNfcGDbusManager *manager,
 	return TRUE;
 }
 
+static gboolean manager_handle_set_event_filter(NetNfcGDbusManager *manager,
+		GDBusMethodInvocation *invocation,
+		guint arg_tech_mask,
+		GVariant *arg_ndef_types,
+		gboolean arg_raw_data,
+		GVariant *smack_privilege,
+		gpointer user_data)
+{
+	bool ret;
+
+	NFC_INFO(">>> REQUEST from [%s]", g_dbus_method_invocation_get_sender(invocation));
+
+	/* check privilege and update client context */
+	ret = net_nfc_server_gdbus_check_privilege(invocation, smack_privilege,
+				"nfc-manager", "r");
+	if (false == ret)
+	{
+		NFC_ERR("permission denied, and finished request");
+
+		return FALSE;
+	}
+
+	net_nfc_server_gdbus_set_event_filter(
+			g_dbus_method_invocation_get_sender(invocation),
+			arg_tech_mask, arg_ndef_types, arg_raw_data);
+
+	net_nfc_gdbus_manager_complete_set_event_filter(manager, invocation,
+			NET_NFC_OK);
+
+	return TRUE;
+}
+
+static GVariant *manager_state_to_variant_no_lock(GHashTable *table)
+{
+	gpointer key, value;
+	GHashTableIter iter;
+	GVariantBuilder builder;
+
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("a{sv}"));
+
+	if (table != NULL)
+	{
+		g_hash_table_iter_init(&iter, table);
+
+		while (g_hash_table_iter_next(&iter, &key, &value))
+			g_variant_builder_add(&builder, "{sv}", key, value);
+	}
+
+	return g_variant_builder_end(&builder);
+}
+
+static gboolean manager_emit_state_changed(gpointer user_data)
+{
+	GVariant *changed;
+
+	pthread_mutex_lock(&state_lock);
+
+	changed = g_variant_ref_sink(manager_state_to_variant_no_lock(state_changed));
+	g_hash_table_remove_all(state_changed);
+	state_source = 0;
+
+	pthread_mutex_unlock(&state_lock);
+
+	if (manager_skeleton != NULL)
+		net_nfc_gdbus_manager_emit_state_changed(manager_skeleton, changed);
+
+	g_variant_unref(changed);
+
+	return G_SOURCE_REMOVE;
+}
+
+void net_nfc_server_manager_update_state(const gchar *key, GVariant *value)
+{
+	GVariant *current;
+
+	g_variant_ref_sink(value);
+
+	pthread_mutex_lock(&state_lock);
+
+	if (NULL == state_values)
+	{
+		state_values = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
+				(GDestroyNotify)g_variant_unref);
+		state_changed = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
+				(GDestroyNotify)g_variant_unref);
+	}
+
+	current = g_hash_table_lookup(state_values, key);
+	if (current != NULL && g_variant_equal(current, value))
+	{
+		pthread_mutex_unlock(&state_lock);
+		g_variant_unref(value);
+
+		return;
+	}
+
+	g_hash_table_insert(state_values, (gpointer)key, g_variant_ref(value));
+	g_hash_table_insert(state_changed, (gpointer)key, value);
+
+	if (0 == state_source)
+		state_source = g_idle_add(manager_emit_state_changed, NULL);
+
+	pthread_mutex_unlock(&state_lock);
+}
+
+static gboolean manager_handle_get_snapshot(NetNfcGDbusManager *manager,
+		GDBusMethodInvocation *invocation, GVariant *smack_privilege, gpointer user_data)
+{
+	bool ret;
+	GVariant *state;
+
+	NFC_INFO(">>> REQUEST from [%s]", g_dbus_method_invocation_get_sender(invocation));
+
+	/* check privilege and update client context */
+	ret = net_nfc_server_gdbus_check_privilege(invocation, smack_privilege,
+				"nfc-manager", "r");
+	if (false == ret)
+	{
+		NFC_ERR("permission denied, and finished request");
+
+		return FALSE;
+	}
+
+	/* answered here, without waiting for the controller thread */
+	pthread_mutex_lock(&state_lock);
+	state = manager_state_to_variant_no_lock(state_values);
+	pthread_mutex_unlock(&state_lock);
+
+	net_nfc_gdbus_manager_complete_get_snapshot(manager, invocation, NET_NFC_OK,
+			state);
+
+	return TRUE;
+}
+
+static gboolean manager_handle_get_queue_statistics(NetNfcGDbusManager *manager,
+		GDBusMethodInvocation *invocation, GVariant *smack_privilege, gpointer user_data)
+{
+	bool ret;
+
+	NFC_INFO(">>> REQUEST from [%s]", g_dbus_method_invocation_get_sender(invocation));
+
+	/* check privilege and update client context */
+	ret = net_nfc_server_gdbus_check_privilege(invocation, smack_privilege,
+				"nfc-manager::admin", "r");
+	if (false == ret)
+	{
+		NFC_ERR("permission denied, and finished request");
+
+		return FALSE;
+	}
+
+	net_nfc_gdbus_manager_complete_get_queue_statistics(manager, invocation,
+			NET_NFC_OK, net_nfc_server_controller_get_queue_statistics());
+
+	return TRUE;
+}
+
+static gboolean manager_handle_get_statistics(NetNfcGDbusManager *manager,
+		GDBusMethodInvocation *invocation, GVariant *smack_privilege, gpointer user_data)
+{
+	bool ret;
+
+	NFC_INFO(">>> REQUEST from [%s]", g_dbus_method_invocation_get_sender(invocation));
+
+	/* check privilege and update client context */
+	ret = net_nfc_server_gdbus_check_privilege(invocation, smack_privilege,
+				"nfc-manager::admin", "r");
+	if (false == ret)
+	{
+		NFC_ERR("permission denied, and finished request");
+
+		return FALSE;
+	}
+
+	net_nfc_gdbus_manager_complete_get_statistics(manager, invocation,
+			NET_NFC_OK, net_nfc_server_statistics_get());
+
+	return TRUE;
+}
+
 /* server side */
 static void manager_active_thread_func(gpointer user_data)
 {
@@ -270,6 +463,8 @@ static void manager_active_thread_func(gpointer user_data)
 		NFC_INFO("nfc %s", data->is_active ? "activated" : "deactivated");
 
 		net_nfc_gdbus_manager_emit_activated(data->manager, data->is_active);
+		net_nfc_server_manager_update_state("activated",
+				g_variant_new_boolean(data->is_active));
 	}
 	else
 	{
@@ -295,6 +490,21 @@ gboolean net_nfc_server_manager_init(GDBusConnection *connection)
 	g_signal_connect(manager_skeleton, "handle-get-server-state",
 			G_CALLBACK(manager_handle_get_server_state), NULL);
 
+	g_signal_connect(manager_skeleton, "handle-set-event-filter",
+			G_CALLBACK(manager_handle_set_event_filter), NULL);
+
+	g_signal_connect(manager_skeleton, "handle-get-snapshot",
+			G_CALLBACK(manager_handle_get_snapshot), NULL);
+
+	g_signal_connect(manager_skeleton, "handle-get-queue-statistics",
+			G_CALLBACK(manager_handle_get_queue_statistics), NULL);
+
+	g_signal_connect(manager_skeleton, "handle-get-statistics",
+			G_CALLBACK(manager_handle_get_statistics), NULL);
+
+	net_nfc_server_manager_update_state("activated",
+			g_variant_new_boolean(net_nfc_server_manager_get_active()));
+
 	ret = g_dbus_interface_skeleton_export(
 				G_DBUS_INTERFACE_SKELETON(manager_skeleton),
 				connection,
@@ -312,16 +522,44 @@ gboolean net_nfc_server_manager_init(GDBusConnection *connection)
 		return FALSE;
 	}
 
+#ifdef USE_SOCKET_IPC
+	if (net_nfc_server_ipc_init() == FALSE)
+		NFC_ERR("can not start the socket transport, clients stay on D-Bus");
+#endif
+
 	return TRUE;
 }
 
 void net_nfc_server_manager_deinit(void)
 {
+#ifdef USE_SOCKET_IPC
+	net_nfc_server_ipc_deinit();
+#endif
+
 	if (manager_skeleton)
 	{
 		g_object_unref(manager_skeleton);
 		manager_skeleton = NULL;
 	}
+
+	pthread_mutex_lock(&state_lock);
+
+	if (state_source > 0)
+	{
+		g_source_remove(state_source);
+		state_source = 0;
+	}
+
+	if (state_values != NULL)
+	{
+		g_hash_table_destroy(state_values);
+		state_values = NULL;
+
+		g_hash_table_destroy(state_changed);
+		state_changed = NULL;
+	}
+
+	pthread_mutex_unlock(&state_lock);
 }
 
 void net_nfc_server_manager_set_active(gboolean is_active)
@@ -349,7 +587,8 @@ void net_nfc_server_manager_set_active(gboolean is_active)
 	data->manager = g_object_ref(manager_skeleton);
 	data->is_active = is_active;
 
-	ret = net_nfc_server_controller_async_queue_push(manager_active_thread_func, data);
+	ret = net_nfc_server_controller_async_queue_push_priority(
+			NET_NFC_CONTROLLER_PRIORITY_DISCOVERY, manager_active_thread_func, data);
 	if (FALSE == ret)
 	{
 		NFC_ERR("can not push to controller thread");
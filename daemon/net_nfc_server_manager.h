@@ -26,4 +26,8 @@ void net_nfc_server_manager_set_active(gboolean is_active);
 
 bool net_nfc_server_manager_get_active();
 
+/* publishes a GetSnapshot value, StateChanged follows if it differs.
+   key must be a static string, value is consumed if floating */
+void net_nfc_server_manager_update_state(const gchar *key, GVariant *value);
+
 #endif //__NET_NFC_SERVER_MANAGER_H__
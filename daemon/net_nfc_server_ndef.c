@@ -43,6 +43,7 @@ struct _WriteData
 	GDBusMethodInvocation *invocation;
 	guint32 handle;
 	data_s data;
+	GMappedFile *mapped; /* set when data came as a memfd */
 };
 
 typedef struct _MakeReadOnlyData MakeReadOnlyData;
@@ -82,7 +83,9 @@ static void ndef_read_thread_func(gpointer user_data)
 
 	handle = GUINT_TO_POINTER(data->handle);
 
-	if (net_nfc_server_target_connected(handle) == true)
+	if (net_nfc_server_controller_job_is_live(&result) == FALSE)
+		NFC_ERR("stale ndef read dropped");
+	else if (net_nfc_server_target_connected(handle) == true)
 		net_nfc_controller_read_ndef(handle, &read_data, &result);
 	else
 		result = NET_NFC_TARGET_IS_MOVED_AWAY;
@@ -116,14 +119,20 @@ static void ndef_write_thread_func(gpointer user_data)
 
 	handle = GUINT_TO_POINTER(data->handle);
 
-	if (net_nfc_server_target_connected(handle) == true)
+	if (net_nfc_server_controller_job_is_live(&result) == FALSE)
+		NFC_ERR("stale ndef write dropped");
+	else if (net_nfc_server_target_connected(handle) == true)
 		net_nfc_controller_write_ndef(handle, &data->data, &result);
 	else
 		result = NET_NFC_TARGET_IS_MOVED_AWAY;
 
-	net_nfc_gdbus_ndef_complete_write(data->ndef, data->invocation, (gint)result);
+	if (data->mapped != NULL)
+		net_nfc_gdbus_ndef_complete_write_fd(data->ndef, data->invocation, NULL,
+				(gint)result);
+	else
+		net_nfc_gdbus_ndef_complete_write(data->ndef, data->invocation, (gint)result);
 
-	net_nfc_util_free_data(&data->data);
+	net_nfc_util_gdbus_release_data_s(&data->data, data->mapped);
 
 	g_object_unref(data->invocation);
 	g_object_unref(data->ndef);
@@ -143,7 +152,9 @@ static void ndef_make_read_only_thread_func(gpointer user_data)
 
 	handle = GUINT_TO_POINTER(data->handle);
 
-	if (net_nfc_server_target_connected(handle) == true)
+	if (net_nfc_server_controller_job_is_live(&result) == FALSE)
+		NFC_ERR("stale ndef make read only dropped");
+	else if (net_nfc_server_target_connected(handle) == true)
 		net_nfc_controller_make_read_only_ndef(handle, &result);
 	else
 		result = NET_NFC_TARGET_IS_MOVED_AWAY;
@@ -168,7 +179,9 @@ static void ndef_format_thread_func(gpointer user_data)
 
 	handle = GUINT_TO_POINTER(data->handle);
 
-	if (net_nfc_server_target_connected(handle) == true)
+	if (net_nfc_server_controller_job_is_live(&result) == FALSE)
+		NFC_ERR("stale ndef format dropped");
+	else if (net_nfc_server_target_connected(handle) == true)
 		net_nfc_controller_format_ndef(handle, &data->key, &result);
 	else
 		result = NET_NFC_TARGET_IS_MOVED_AWAY;
@@ -219,7 +232,9 @@ static gboolean ndef_handle_read(NetNfcGDbusNdef *ndef,
 	data->invocation = g_object_ref(invocation);
 	data->handle = arg_handle;
 
-	result = net_nfc_server_controller_async_queue_push(ndef_read_thread_func, data);
+	result = net_nfc_server_controller_async_queue_push_job(
+			NET_NFC_CONTROLLER_PRIORITY_TAG, GUINT_TO_POINTER(data->handle),
+			invocation, ndef_read_thread_func, data);
 	if (FALSE == result)
 	{
 		g_dbus_method_invocation_return_dbus_error(invocation,
@@ -235,30 +250,15 @@ static gboolean ndef_handle_read(NetNfcGDbusNdef *ndef,
 	return result;
 }
 
-static gboolean ndef_handle_write(NetNfcGDbusNdef *ndef,
+static gboolean ndef_write_push(NetNfcGDbusNdef *ndef,
 		GDBusMethodInvocation *invocation,
 		guint32 arg_handle,
-		GVariant *arg_data,
-		GVariant *smack_privilege,
-		gpointer user_data)
+		data_s *arg_data,
+		GMappedFile *mapped)
 {
-	bool ret;
 	WriteData *data;
 	gboolean result;
 
-	NFC_INFO(">>> REQUEST from [%s]", g_dbus_method_invocation_get_sender(invocation));
-
-	/* check privilege and update client context */
-	ret = net_nfc_server_gdbus_check_privilege(invocation, smack_privilege,
-			"nfc-manager::tag", "w");
-
-	if (false == ret)
-	{
-		NFC_ERR("permission denied, and finished request");
-
-		return FALSE;
-	}
-
 	data = g_new0(WriteData, 1);
 	if (NULL == data)
 	{
@@ -266,23 +266,27 @@ static gboolean ndef_handle_write(NetNfcGDbusNdef *ndef,
 		g_dbus_method_invocation_return_dbus_error(invocation,
 				"org.tizen.NetNfcService.AllocationError", "Can not allocate memory");
 
+		net_nfc_util_gdbus_release_data_s(arg_data, mapped);
+
 		return FALSE;
 	}
 
 	data->ndef = g_object_ref(ndef);
 	data->invocation = g_object_ref(invocation);
 	data->handle = arg_handle;
+	data->data = *arg_data;
+	data->mapped = mapped;
 
-	net_nfc_util_gdbus_variant_to_data_s(arg_data, &data->data);
-
-	result = net_nfc_server_controller_async_queue_push(ndef_write_thread_func, data);
+	result = net_nfc_server_controller_async_queue_push_job(
+			NET_NFC_CONTROLLER_PRIORITY_TAG, GUINT_TO_POINTER(data->handle),
+			invocation, ndef_write_thread_func, data);
 	if (FALSE == result)
 	{
 		g_dbus_method_invocation_return_dbus_error(invocation,
 				"org.tizen.NetNfcService.Ndef.ThreadError",
 				"can not push to controller thread");
 
-		net_nfc_util_free_data(&data->data);
+		net_nfc_util_gdbus_release_data_s(&data->data, data->mapped);
 
 		g_object_unref(data->invocation);
 		g_object_unref(data->ndef);
@@ -293,6 +297,71 @@ static gboolean ndef_handle_write(NetNfcGDbusNdef *ndef,
 	return result;
 }
 
+static gboolean ndef_handle_write(NetNfcGDbusNdef *ndef,
+		GDBusMethodInvocation *invocation,
+		guint32 arg_handle,
+		GVariant *arg_data,
+		GVariant *smack_privilege,
+		gpointer user_data)
+{
+	bool ret;
+	data_s data = { NULL, 0 };
+
+	NFC_INFO(">>> REQUEST from [%s]", g_dbus_method_invocation_get_sender(invocation));
+
+	/* check privilege and update client context */
+	ret = net_nfc_server_gdbus_check_privilege(invocation, smack_privilege,
+			"nfc-manager::tag", "w");
+
+	if (false == ret)
+	{
+		NFC_ERR("permission denied, and finished request");
+
+		return FALSE;
+	}
+
+	net_nfc_util_gdbus_variant_to_data_s(arg_data, &data);
+
+	return ndef_write_push(ndef, invocation, arg_handle, &data, NULL);
+}
+
+static gboolean ndef_handle_write_fd(NetNfcGDbusNdef *ndef,
+		GDBusMethodInvocation *invocation,
+		GUnixFDList *fd_list,
+		guint32 arg_handle,
+		gint32 arg_data,
+		GVariant *smack_privilege,
+		gpointer user_data)
+{
+	bool ret;
+	GMappedFile *mapped;
+	data_s data = { NULL, 0 };
+
+	NFC_INFO(">>> REQUEST from [%s]", g_dbus_method_invocation_get_sender(invocation));
+
+	/* check privilege and update client context */
+	ret = net_nfc_server_gdbus_check_privilege(invocation, smack_privilege,
+			"nfc-manager::tag", "w");
+
+	if (false == ret)
+	{
+		NFC_ERR("permission denied, and finished request");
+
+		return FALSE;
+	}
+
+	mapped = net_nfc_util_gdbus_fd_list_to_data_s(fd_list, arg_data, &data);
+	if (NULL == mapped)
+	{
+		g_dbus_method_invocation_return_dbus_error(invocation,
+				"org.tizen.NetNfcService.Ndef.DataError", "Can not map data");
+
+		return FALSE;
+	}
+
+	return ndef_write_push(ndef, invocation, arg_handle, &data, mapped);
+}
+
 static gboolean ndef_handle_make_read_only(NetNfcGDbusNdef *ndef,
 		GDBusMethodInvocation *invocation,
 		guint32 arg_handle,
@@ -329,8 +398,9 @@ static gboolean ndef_handle_make_read_only(NetNfcGDbusNdef *ndef,
 	data->invocation = g_object_ref(invocation);
 	data->handle = arg_handle;
 
-	result = net_nfc_server_controller_async_queue_push(ndef_make_read_only_thread_func,
-			data);
+	result = net_nfc_server_controller_async_queue_push_job(
+			NET_NFC_CONTROLLER_PRIORITY_TAG, GUINT_TO_POINTER(data->handle),
+			invocation, ndef_make_read_only_thread_func, data);
 	if (FALSE == result)
 	{
 		g_dbus_method_invocation_return_dbus_error(invocation,
@@ -384,7 +454,9 @@ static gboolean ndef_handle_format(NetNfcGDbusNdef *ndef,
 	data->handle = arg_handle;
 	net_nfc_util_gdbus_variant_to_data_s(arg_key, &data->key);
 
-	result = net_nfc_server_controller_async_queue_push(ndef_format_thread_func, data);
+	result = net_nfc_server_controller_async_queue_push_job(
+			NET_NFC_CONTROLLER_PRIORITY_TAG, GUINT_TO_POINTER(data->handle),
+			invocation, ndef_format_thread_func, data);
 	if (FALSE == result)
 	{
 		g_dbus_method_invocation_return_dbus_error(invocation,
@@ -416,6 +488,9 @@ gboolean net_nfc_server_ndef_init(GDBusConnection *connection)
 
 	g_signal_connect(ndef_skeleton, "handle-write", G_CALLBACK(ndef_handle_write), NULL);
 
+	g_signal_connect(ndef_skeleton, "handle-write-fd",
+			G_CALLBACK(ndef_handle_write_fd), NULL);
+
 	g_signal_connect(ndef_skeleton, "handle-make-read-only",
 			G_CALLBACK(ndef_handle_make_read_only), NULL);
 
@@ -35,10 +35,28 @@ struct _P2pSendData
 	gint32 type;
 	guint32 p2p_handle;
 	data_s data;
+	GMappedFile *mapped; /* set when data came as a memfd */
 };
 
 static NetNfcGDbusP2p *p2p_skeleton = NULL;
 
+static void p2p_send_complete(P2pSendData *p2p_data, net_nfc_error_e result)
+{
+	if (p2p_data->mapped != NULL)
+		net_nfc_gdbus_p2p_complete_send_fd(p2p_data->p2p, p2p_data->invocation,
+				NULL, (gint)result);
+	else
+		net_nfc_gdbus_p2p_complete_send(p2p_data->p2p, p2p_data->invocation,
+				(gint)result);
+
+	net_nfc_util_gdbus_release_data_s(&p2p_data->data, p2p_data->mapped);
+
+	g_object_unref(p2p_data->invocation);
+	g_object_unref(p2p_data->p2p);
+
+	g_free(p2p_data);
+}
+
 static void p2p_send_data_thread_func(gpointer user_data)
 {
 	net_nfc_error_e result;
@@ -54,42 +72,19 @@ static void p2p_send_data_thread_func(gpointer user_data)
 	result = net_nfc_server_snep_default_client_start(handle, SNEP_REQ_PUT,
 			&p2p_data->data, -1, p2p_data);
 	if (result != NET_NFC_OK)
-	{
-		net_nfc_gdbus_p2p_complete_send(p2p_data->p2p, p2p_data->invocation, (gint)result);
-
-		net_nfc_util_free_data(&p2p_data->data);
-
-		g_object_unref(p2p_data->invocation);
-		g_object_unref(p2p_data->p2p);
-
-		g_free(p2p_data);
-	}
+		p2p_send_complete(p2p_data, result);
 }
 
-static gboolean p2p_handle_send(NetNfcGDbusP2p *p2p,
+static gboolean p2p_send_push(NetNfcGDbusP2p *p2p,
 		GDBusMethodInvocation *invocation,
 		gint32 arg_type,
-		GVariant *arg_data,
 		guint32 handle,
-		GVariant *smack_privilege,
-		gpointer user_data)
+		data_s *arg_data,
+		GMappedFile *mapped)
 {
-	bool ret;
 	gboolean result;
 	P2pSendData *data;
 
-	NFC_INFO(">>> REQUEST from [%s]", g_dbus_method_invocation_get_sender(invocation));
-
-	/* check privilege and update client context */
-	ret = net_nfc_server_gdbus_check_privilege(invocation, smack_privilege,
-				"nfc-manager::p2p", "w");
-	if (false == ret)
-	{
-		NFC_ERR("permission denied, and finished request");
-
-		return FALSE;
-	}
-
 	data = g_new0(P2pSendData, 1);
 	if(NULL == data)
 	{
@@ -97,6 +92,8 @@ static gboolean p2p_handle_send(NetNfcGDbusP2p *p2p,
 		g_dbus_method_invocation_return_dbus_error(invocation,
 				"org.tizen.NetNfcService.AllocationError", "Can not allocate memory");
 
+		net_nfc_util_gdbus_release_data_s(arg_data, mapped);
+
 		return FALSE;
 	}
 
@@ -104,9 +101,12 @@ static gboolean p2p_handle_send(NetNfcGDbusP2p *p2p,
 	data->invocation = g_object_ref(invocation);
 	data->type = arg_type;
 	data->p2p_handle = handle;
-	net_nfc_util_gdbus_variant_to_data_s(arg_data, &data->data);
+	data->data = *arg_data;
+	data->mapped = mapped;
 
-	result = net_nfc_server_controller_async_queue_push(p2p_send_data_thread_func, data);
+	result = net_nfc_server_controller_async_queue_push_handle(
+			NET_NFC_CONTROLLER_PRIORITY_P2P, GUINT_TO_POINTER(data->p2p_handle),
+			p2p_send_data_thread_func, data);
 
 	if (FALSE == result)
 	{
@@ -114,7 +114,7 @@ static gboolean p2p_handle_send(NetNfcGDbusP2p *p2p,
 				"org.tizen.NetNfcService.P2p.ThreadError",
 				"can not push to controller thread");
 
-		net_nfc_util_free_data(&data->data);
+		net_nfc_util_gdbus_release_data_s(&data->data, data->mapped);
 
 		g_object_unref(data->invocation);
 		g_object_unref(data->p2p);
@@ -125,6 +125,71 @@ static gboolean p2p_handle_send(NetNfcGDbusP2p *p2p,
 	return result;
 }
 
+static gboolean p2p_handle_send(NetNfcGDbusP2p *p2p,
+		GDBusMethodInvocation *invocation,
+		gint32 arg_type,
+		GVariant *arg_data,
+		guint32 handle,
+		GVariant *smack_privilege,
+		gpointer user_data)
+{
+	bool ret;
+	data_s data = { NULL, 0 };
+
+	NFC_INFO(">>> REQUEST from [%s]", g_dbus_method_invocation_get_sender(invocation));
+
+	/* check privilege and update client context */
+	ret = net_nfc_server_gdbus_check_privilege(invocation, smack_privilege,
+				"nfc-manager::p2p", "w");
+	if (false == ret)
+	{
+		NFC_ERR("permission denied, and finished request");
+
+		return FALSE;
+	}
+
+	net_nfc_util_gdbus_variant_to_data_s(arg_data, &data);
+
+	return p2p_send_push(p2p, invocation, arg_type, handle, &data, NULL);
+}
+
+static gboolean p2p_handle_send_fd(NetNfcGDbusP2p *p2p,
+		GDBusMethodInvocation *invocation,
+		GUnixFDList *fd_list,
+		gint32 arg_type,
+		gint32 arg_data,
+		guint32 handle,
+		GVariant *smack_privilege,
+		gpointer user_data)
+{
+	bool ret;
+	GMappedFile *mapped;
+	data_s data = { NULL, 0 };
+
+	NFC_INFO(">>> REQUEST from [%s]", g_dbus_method_invocation_get_sender(invocation));
+
+	/* check privilege and update client context */
+	ret = net_nfc_server_gdbus_check_privilege(invocation, smack_privilege,
+				"nfc-manager::p2p", "w");
+	if (false == ret)
+	{
+		NFC_ERR("permission denied, and finished request");
+
+		return FALSE;
+	}
+
+	mapped = net_nfc_util_gdbus_fd_list_to_data_s(fd_list, arg_data, &data);
+	if (NULL == mapped)
+	{
+		g_dbus_method_invocation_return_dbus_error(invocation,
+				"org.tizen.NetNfcService.P2p.DataError", "Can not map data");
+
+		return FALSE;
+	}
+
+	return p2p_send_push(p2p, invocation, arg_type, handle, &data, mapped);
+}
+
 
 gboolean net_nfc_server_p2p_init(GDBusConnection *connection)
 {
@@ -138,6 +203,9 @@ gboolean net_nfc_server_p2p_init(GDBusConnection *connection)
 
 	g_signal_connect(p2p_skeleton, "handle-send", G_CALLBACK(p2p_handle_send), NULL);
 
+	g_signal_connect(p2p_skeleton, "handle-send-fd",
+			G_CALLBACK(p2p_handle_send_fd), NULL);
+
 	result = g_dbus_interface_skeleton_export(G_DBUS_INTERFACE_SKELETON(p2p_skeleton),
 			connection, "/org/tizen/NetNfcService/P2p", &error);
 	if (FALSE == result)
@@ -167,7 +235,8 @@ void net_nfc_server_p2p_detached(void)
 	net_nfc_server_free_target_info();
 
 	if (p2p_skeleton != NULL)
-		net_nfc_gdbus_p2p_emit_detached(p2p_skeleton);
+		net_nfc_server_gdbus_emit_event(G_DBUS_INTERFACE_SKELETON(p2p_skeleton),
+				"Detached", NET_NFC_IP_ENABLE, NULL, g_variant_new("()"), NULL);
 }
 
 void net_nfc_server_p2p_discovered(net_nfc_target_handle_s *handle)
@@ -181,12 +250,15 @@ void net_nfc_server_p2p_discovered(net_nfc_target_handle_s *handle)
 		return;
 	}
 
-	net_nfc_gdbus_p2p_emit_discovered(p2p_skeleton, GPOINTER_TO_UINT(handle));
+	net_nfc_server_gdbus_emit_event(G_DBUS_INTERFACE_SKELETON(p2p_skeleton),
+			"Discovered", NET_NFC_IP_ENABLE, NULL,
+			g_variant_new("(u)", GPOINTER_TO_UINT(handle)), NULL);
 }
 
 void net_nfc_server_p2p_received(data_s *user_data)
 {
 	GVariant *arg_data;
+	GVariant *no_data = NULL;
 
 	if (NULL == p2p_skeleton)
 	{
@@ -197,7 +269,13 @@ void net_nfc_server_p2p_received(data_s *user_data)
 
 	arg_data = net_nfc_util_gdbus_data_to_variant((data_s *)user_data);
 
-	net_nfc_gdbus_p2p_emit_received(p2p_skeleton, arg_data);
+	if (user_data != NULL && user_data->length > 0)
+		no_data = g_variant_new("(@ay)", net_nfc_util_gdbus_buffer_to_variant(NULL, 0));
+
+	net_nfc_server_gdbus_emit_event(G_DBUS_INTERFACE_SKELETON(p2p_skeleton),
+			"Received", NET_NFC_IP_ENABLE, NULL,
+			g_variant_new("(@ay)", arg_data),
+			no_data);
 }
 
 void net_nfc_server_p2p_data_sent(net_nfc_error_e result, gpointer user_data)
@@ -208,12 +286,5 @@ void net_nfc_server_p2p_data_sent(net_nfc_error_e result, gpointer user_data)
 	g_assert(data->p2p != NULL);
 	g_assert(data->invocation != NULL);
 
-	net_nfc_gdbus_p2p_complete_send(data->p2p, data->invocation, (gint)result);
-
-	net_nfc_util_free_data(&data->data);
-
-	g_object_unref(data->invocation);
-	g_object_unref(data->p2p);
-
-	g_free(data);
+	p2p_send_complete(data, result);
 }
@@ -56,7 +56,7 @@ static gboolean _phdc_send_request_cb_(net_nfc_phdc_handle_h handle,
 	GVariant *phdc_data ;
 
 	g_variant_get(parameter,
-		"(uuu@a(y))",
+		"(uuu@ay)",
 		(guint *)&object,
 		(guint *)&invocation,
 		(guint *)&phdc_handle,
@@ -92,7 +92,7 @@ static void phdc_send_data_thread_func(gpointer user_data)
 	NFC_DBG(">>> phdc_send_data_thread_func");
 
 	g_variant_get((GVariant *)user_data,
-		"(uuu@a(y))",
+		"(uuu@ay)",
 		(guint *)&object,
 		(guint *)&invocation,
 		(guint *)&handle,
@@ -141,7 +141,7 @@ static gboolean phdc_handle_send(NetNfcGDbusPhdc *phdc,
 		goto ERROR;
 	}
 
-	parameter = g_variant_new("(uuu@a(y))",
+	parameter = g_variant_new("(uuu@ay)",
 		GPOINTER_TO_UINT(g_object_ref(phdc)),
 		GPOINTER_TO_UINT(g_object_ref(invocation)),
 		handle,
@@ -155,7 +155,9 @@ static gboolean phdc_handle_send(NetNfcGDbusPhdc *phdc,
 		goto ERROR;
 	}
 
-	result = net_nfc_server_controller_async_queue_push(phdc_send_data_thread_func, parameter);
+	result = net_nfc_server_controller_async_queue_push_handle(
+			NET_NFC_CONTROLLER_PRIORITY_P2P, GUINT_TO_POINTER(handle),
+			phdc_send_data_thread_func, parameter);
 
 	if (FALSE == result)
 	{
@@ -473,7 +475,8 @@ static gboolean phdc_handle_register(
 		result = NET_NFC_ALLOC_FAIL;
 		goto ERROR;
 	}
-	if(net_nfc_server_controller_async_queue_push(
+	if(net_nfc_server_controller_async_queue_push_priority(
+			NET_NFC_CONTROLLER_PRIORITY_P2P,
 			phdc_register_server_thread_func, parameter) == FALSE)
 	{
 		NFC_ERR("controller is processing important message.");
@@ -566,7 +569,8 @@ static gboolean phdc_handle_unregister(
 		result = NET_NFC_ALLOC_FAIL;
 		goto ERROR;
 	}
-	if(net_nfc_server_controller_async_queue_push(
+	if(net_nfc_server_controller_async_queue_push_priority(
+			NET_NFC_CONTROLLER_PRIORITY_P2P,
 			phdc_unregister_server_thread_func, parameter) == FALSE)
 	{
 		NFC_ERR("controller is processing important message.");
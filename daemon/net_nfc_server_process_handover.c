@@ -196,24 +196,10 @@ static void _net_nfc_server_handover_send_response(
 static net_nfc_error_e _net_nfc_server_handover_convert_ndef_message_to_data(
 		ndef_message_s *msg, data_s *data)
 {
-	uint32_t length;
-	net_nfc_error_e result;
-
 	RETV_IF(NULL == msg, NET_NFC_INVALID_PARAM);
 	RETV_IF(NULL == data, NET_NFC_INVALID_PARAM);
 
-	length = net_nfc_util_get_ndef_message_length(msg);
-	if (length > 0)
-	{
-		net_nfc_util_alloc_data(data, length);
-		result = net_nfc_util_convert_ndef_message_to_rawdata(msg, data);
-	}
-	else
-	{
-		result = NET_NFC_INVALID_PARAM;
-	}
-
-	return result;
+	return net_nfc_util_serialize_ndef_message(msg, 0, data);
 }
 
 static void _net_nfc_server_handover_bss_get_carrier_record_cb(
@@ -231,8 +217,7 @@ static void _net_nfc_server_handover_bss_get_carrier_record_cb(
 	{
 		ndef_record_s *record;
 
-		net_nfc_util_create_record(carrier->TNF, &carrier->type_s, &carrier->id_s,
-				&carrier->payload_s, &record);
+		net_nfc_util_share_record(carrier, &record);
 
 		result = net_nfc_util_append_carrier_config_record(context->ndef_message,
 						record, cps);
@@ -617,7 +602,8 @@ _net_nfc_server_handover_create_requester_carrier_configs(
 
 		context->cb = cb;
 		context->user_param = user_param;
-		net_nfc_util_create_handover_request_message(&context->ndef_message);
+		net_nfc_util_create_handover_request_message_with_arena(
+				&context->ndef_message);
 
 		/* append carrier record */
 		g_idle_add((GSourceFunc)_net_nfc_server_handover_iterate_create_carrier_configs,
@@ -654,7 +640,8 @@ _net_nfc_server_handover_create_selector_carrier_configs(
 
 		context->cb = cb;
 		context->user_param = user_param;
-		net_nfc_util_create_handover_select_message(&context->ndef_message);
+		net_nfc_util_create_handover_select_message_with_arena(
+				&context->ndef_message);
 
 		/* append carrier record */
 		g_idle_add((GSourceFunc)_net_nfc_server_handover_iterate_create_carrier_configs,
@@ -757,8 +744,7 @@ static net_nfc_error_e _net_nfc_server_handover_select_carrier_record(
 				result = net_nfc_util_get_alternative_carrier_type_from_record(temp, type);
 				if (NET_NFC_OK == result)
 				{
-					net_nfc_util_create_record(temp->TNF, &temp->type_s, &temp->id_s,
-							&temp->payload_s, record);
+					net_nfc_util_share_record(temp, record);
 				}
 				else
 				{
@@ -932,8 +918,7 @@ static bool _net_nfc_server_handover_get_response_cb(
 				context->user_param = user_param;
 				context->state = NET_NFC_LLCP_STEP_02;
 
-				net_nfc_util_create_record(record->TNF, &record->type_s, &record->id_s,
-						&record->payload_s, &context->record);
+				net_nfc_util_share_record(record, &context->record);
 
 				_net_nfc_server_handover_get_response_process(context);
 			}
@@ -1042,8 +1027,7 @@ static void _net_nfc_server_handover_server_recv_cb(
 
 			if (NET_NFC_OK == ret)
 			{
-				net_nfc_util_create_record(record->TNF, &record->type_s, &record->id_s,
-						&record->payload_s, &context->record);
+				net_nfc_util_share_record(record, &context->record);
 
 				context->state = NET_NFC_LLCP_STEP_02;
 			}
@@ -1381,8 +1365,7 @@ static void _net_nfc_server_handover_client_recv_cb(net_nfc_error_e result,
 
 			if (NET_NFC_OK == result)
 			{
-				net_nfc_util_create_record(record->TNF, &record->type_s, &record->id_s,
-						&record->payload_s, &context->record);
+				net_nfc_util_share_record(record, &context->record);
 
 				context->state = NET_NFC_LLCP_STEP_04;
 			}
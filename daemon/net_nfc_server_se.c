@@ -136,11 +136,15 @@ static void net_nfc_server_se_set_se_type(uint8_t type)
 {
 	gdbus_se_setting.return_type = gdbus_se_setting.type;
 	gdbus_se_setting.type = type;
+
+	net_nfc_server_manager_update_state("se_type", g_variant_new_byte(type));
 }
 
 static void net_nfc_server_se_set_se_mode(uint8_t mode)
 {
 	gdbus_se_setting.mode = mode;
+
+	net_nfc_server_manager_update_state("se_mode", g_variant_new_byte(mode));
 }
 
 
@@ -512,7 +516,8 @@ static gboolean se_handle_close_secure_element(
 	data->invocation = g_object_ref(invocation);
 	data->handle = GUINT_TO_POINTER(arg_handle);
 
-	result = net_nfc_server_controller_async_queue_push(
+	result = net_nfc_server_controller_async_queue_push_handle(
+			NET_NFC_CONTROLLER_PRIORITY_SE, data->handle,
 			se_close_secure_element_thread_func, data);
 	if (FALSE == result)
 	{
@@ -608,7 +613,9 @@ static gboolean se_handle_get_atr(
 	data->invocation = g_object_ref(invocation);
 	data->handle = GUINT_TO_POINTER(arg_handle);
 
-	result = net_nfc_server_controller_async_queue_push(se_get_atr_thread_func, data);
+	result = net_nfc_server_controller_async_queue_push_handle(
+			NET_NFC_CONTROLLER_PRIORITY_SE, data->handle,
+			se_get_atr_thread_func, data);
 	if (FALSE == result)
 	{
 		g_dbus_method_invocation_return_dbus_error(invocation,
@@ -745,7 +752,8 @@ static gboolean se_handle_open_secure_element(
 	data->invocation = g_object_ref(invocation);
 	data->se_type= arg_type;
 
-	result = net_nfc_server_controller_async_queue_push(
+	result = net_nfc_server_controller_async_queue_push_priority(
+			NET_NFC_CONTROLLER_PRIORITY_SE,
 			se_open_secure_element_thread_func, data);
 	if (FALSE == result)
 	{
@@ -776,7 +784,11 @@ static void se_send_apdu_thread_func(gpointer user_data)
 
 	net_nfc_util_gdbus_variant_to_data_s(detail->data, &apdu_data);
 
-	if (_se_is_uicc_handle(detail->handle) == true)
+	if (net_nfc_server_controller_job_is_live(&result) == FALSE)
+	{
+		NFC_ERR("stale apdu dropped");
+	}
+	else if (_se_is_uicc_handle(detail->handle) == true)
 	{
 		result = NET_NFC_NOT_SUPPORTED;
 	}
@@ -849,7 +861,9 @@ static gboolean se_handle_send_apdu(
 	data->handle = GUINT_TO_POINTER(arg_handle);
 	data->data = g_variant_ref(apdudata);
 
-	result = net_nfc_server_controller_async_queue_push(se_send_apdu_thread_func, data);
+	result = net_nfc_server_controller_async_queue_push_job(
+			NET_NFC_CONTROLLER_PRIORITY_SE, data->handle,
+			invocation, se_send_apdu_thread_func, data);
 	if (FALSE == result)
 	{
 		g_dbus_method_invocation_return_dbus_error(invocation,
@@ -957,7 +971,8 @@ static gboolean _se_handle_set_card_emulation(
 	data->invocation = g_object_ref(invocation);
 	data->mode = arg_mode;
 
-	result = net_nfc_server_controller_async_queue_push(
+	result = net_nfc_server_controller_async_queue_push_priority(
+			NET_NFC_CONTROLLER_PRIORITY_SE,
 			_se_set_card_emulation_thread_func, data);
 	if (FALSE == result)
 	{
@@ -1034,7 +1049,8 @@ static gboolean se_handle_set(NetNfcGDbusSecureElement *object,
 	data->invocation = g_object_ref(invocation);
 	data->se_type = arg_type;
 
-	result = net_nfc_server_controller_async_queue_push(se_set_data_thread_func, data);
+	result = net_nfc_server_controller_async_queue_push_priority(
+			NET_NFC_CONTROLLER_PRIORITY_SE, se_set_data_thread_func, data);
 
 	if (FALSE == result)
 	{
@@ -1101,7 +1117,8 @@ static gboolean se_handle_get(NetNfcGDbusSecureElement *object,
 	data->object = g_object_ref(object);
 	data->invocation = g_object_ref(invocation);
 
-	result = net_nfc_server_controller_async_queue_push(se_get_data_thread_func, data);
+	result = net_nfc_server_controller_async_queue_push_priority(
+			NET_NFC_CONTROLLER_PRIORITY_SE, se_get_data_thread_func, data);
 	if (FALSE == result)
 	{
 		g_dbus_method_invocation_return_dbus_error(invocation,
@@ -1197,7 +1214,8 @@ static gboolean se_handle_change_card_emulation_mode(
 	data->invocation = g_object_ref(invocation);
 	data->mode = arg_mode;
 
-	result = net_nfc_server_controller_async_queue_push(
+	result = net_nfc_server_controller_async_queue_push_priority(
+			NET_NFC_CONTROLLER_PRIORITY_SE,
 			_se_change_card_emulation_mode_thread_func, data);
 	if (FALSE == result)
 	{
@@ -1292,7 +1310,7 @@ static void se_detected_thread_func(gpointer user_data)
 		return;
 	}
 
-	g_variant_get((GVariant *)user_data, "uu@a(y)", (guint *)&handle, &devType, &data);
+	g_variant_get((GVariant *)user_data, "uu@ay", (guint *)&handle, &devType, &data);
 
 	net_nfc_server_se_set_current_ese_handle(handle);
 
@@ -1366,12 +1384,13 @@ void net_nfc_server_se_detected(void *info)
 	data = net_nfc_util_gdbus_buffer_to_variant(se_target->target_info_values.buffer,
 			se_target->target_info_values.length);
 
-	parameter = g_variant_new("uu@a(y)", GPOINTER_TO_UINT(se_target->handle),
+	parameter = g_variant_new("uu@ay", GPOINTER_TO_UINT(se_target->handle),
 			se_target->devType, data);
 	if (parameter != NULL)
 	{
-		ret = net_nfc_server_controller_async_queue_push(se_detected_thread_func,
-					parameter);
+		ret = net_nfc_server_controller_async_queue_push_handle(
+				NET_NFC_CONTROLLER_PRIORITY_DISCOVERY, se_target->handle,
+				se_detected_thread_func, parameter);
 		if (FALSE == ret)
 		{
 			NFC_ERR("can not push to controller thread");
@@ -1411,7 +1430,8 @@ void net_nfc_server_se_transaction_received(void *info)
 				memcpy(detail->param.buffer, se_event->param.buffer, se_event->param.length);
 		}
 
-		ret = net_nfc_server_controller_async_queue_push(
+		ret = net_nfc_server_controller_async_queue_push_priority(
+					NET_NFC_CONTROLLER_PRIORITY_DISCOVERY,
 					se_transcation_thread_func, detail);
 		if (FALSE == ret)
 		{
@@ -52,7 +52,7 @@ static void _emit_snep_event_signal(GVariant *parameter,
 				"/org/tizen/NetNfcService/Snep",
 				"org.tizen.NetNfcService.Snep",
 				"SnepEvent",
-				g_variant_new("(uui@a(y)u)", GPOINTER_TO_UINT(handle), type, (gint)result,
+				g_variant_new("(uui@ayu)", GPOINTER_TO_UINT(handle), type, (gint)result,
 					arg_data, GPOINTER_TO_UINT(user_data)),
 				&error);
 	if (false == ret)
@@ -200,7 +200,9 @@ static gboolean _handle_start_server(
 
 	if (parameter != NULL)
 	{
-		result = net_nfc_server_controller_async_queue_push(
+		result = net_nfc_server_controller_async_queue_push_handle(
+						NET_NFC_CONTROLLER_PRIORITY_P2P,
+						GUINT_TO_POINTER(arg_handle),
 						snep_server_start_thread_func, parameter);
 		if (FALSE == result)
 		{
@@ -345,7 +347,9 @@ static gboolean _handle_start_client(
 
 	if (parameter != NULL)
 	{
-		result = net_nfc_server_controller_async_queue_push(
+		result = net_nfc_server_controller_async_queue_push_handle(
+						NET_NFC_CONTROLLER_PRIORITY_P2P,
+						GUINT_TO_POINTER(arg_handle),
 						snep_client_start_thread_func, parameter);
 		if (FALSE == result)
 		{
@@ -374,6 +378,40 @@ static gboolean _handle_start_client(
 	return result;
 }
 
+static void _snep_client_request_complete(NetNfcGDbusSnep *object,
+		GDBusMethodInvocation *invocation,
+		gboolean fd,
+		net_nfc_error_e result,
+		net_nfc_snep_type_t type,
+		data_s *data)
+{
+	GVariant *arg_data;
+	GUnixFDList *fd_list = NULL;
+
+	/* a large response goes back the way the request came */
+	if (fd == TRUE && data != NULL)
+		fd_list = net_nfc_util_gdbus_data_to_fd_list(data);
+
+	if (fd_list == NULL && data != NULL && data->buffer != NULL && data->length > 0)
+		arg_data = net_nfc_util_gdbus_data_to_variant(data);
+	else
+		arg_data = net_nfc_util_gdbus_buffer_to_variant(NULL, 0);
+
+	if (fd == TRUE)
+	{
+		net_nfc_gdbus_snep_complete_client_request_fd(object, invocation,
+				fd_list, result, type, arg_data, (fd_list != NULL) ? 0 : -1);
+
+		if (fd_list != NULL)
+			g_object_unref(fd_list);
+	}
+	else
+	{
+		net_nfc_gdbus_snep_complete_client_request(object, invocation, result,
+				type, arg_data);
+	}
+}
+
 static net_nfc_error_e _snep_client_request_cb(
 		net_nfc_snep_handle_h handle,
 		net_nfc_error_e result,
@@ -388,28 +426,23 @@ static net_nfc_error_e _snep_client_request_cb(
 
 	if (parameter != NULL)
 	{
+		gboolean fd;
 		GVariant *arg_ndef_msg;
 		NetNfcGDbusSnep *object;
-		GVariant *arg_data = NULL;
 		net_nfc_snep_type_t arg_type;
 		GDBusMethodInvocation *invocation;
 		net_nfc_snep_handle_h arg_snep_handle;
 
 		g_variant_get(parameter,
-				"(uuuu@a(y))",
+				"(uuuub@ay)",
 				(guint *)&object,
 				(guint *)&invocation,
 				(guint *)&arg_snep_handle,
 				(guint *)&arg_type,
+				&fd,
 				&arg_ndef_msg);
 
-		if (data != NULL && data->buffer != NULL && data->length > 0)
-			arg_data = net_nfc_util_gdbus_data_to_variant(data);
-		else
-			arg_data = net_nfc_util_gdbus_buffer_to_variant(NULL, 0);
-
-		net_nfc_gdbus_snep_complete_client_request(object, invocation, result,
-				type, arg_data);
+		_snep_client_request_complete(object, invocation, fd, result, type, data);
 
 		g_variant_unref(arg_ndef_msg);
 
@@ -430,6 +463,8 @@ static net_nfc_error_e _snep_client_request_cb(
 
 static void snep_client_send_request_thread_func(gpointer user_data)
 {
+	gboolean fd;
+	gsize length;
 	net_nfc_error_e result;
 	GVariant *arg_ndef_msg;
 	NetNfcGDbusSnep *object;
@@ -441,30 +476,31 @@ static void snep_client_send_request_thread_func(gpointer user_data)
 	RET_IF(NULL == user_data);
 
 	g_variant_get((GVariant *)user_data,
-			"(uuuu@a(y))",
+			"(uuuub@ay)",
 			(guint *)&object,
 			(guint *)&invocation,
 			(guint *)&arg_snep_handle,
 			(guint *)&arg_type,
+			&fd,
 			&arg_ndef_msg);
 
 	g_assert(object != NULL);
 	g_assert(invocation != NULL);
 
-	net_nfc_util_gdbus_variant_to_data_s(arg_ndef_msg, &data);
+	/* the request copies what it keeps, so borrow the message bytes
+	   (or the memfd mapping behind them) for the duration of the call */
+	data.buffer = (uint8_t *)g_variant_get_fixed_array(arg_ndef_msg, &length,
+			sizeof(guint8));
+	data.length = length;
 
 	result = net_nfc_server_snep_client_request(arg_snep_handle, arg_type,
 			&data, _snep_client_request_cb, user_data);
 	if (result != NET_NFC_OK)
 	{
-		GVariant *resp;
-
 		NFC_ERR("net_nfc_server_snep_client_request failed, [%d]",result);
 
-		resp = net_nfc_util_gdbus_buffer_to_variant(NULL, 0);
-
-		net_nfc_gdbus_snep_complete_client_request(object,
-				invocation, result, NET_NFC_LLCP_STOP, resp);
+		_snep_client_request_complete(object, invocation, fd, result,
+				NET_NFC_LLCP_STOP, NULL);
 
 		g_object_unref(invocation);
 		g_object_unref(object);
@@ -472,45 +508,32 @@ static void snep_client_send_request_thread_func(gpointer user_data)
 		g_variant_unref(user_data);
 	}
 
-	net_nfc_util_free_data(&data);
-
 	g_variant_unref(arg_ndef_msg);
 }
 
-static gboolean _handle_client_send_request(
+static gboolean _client_send_request_push(
 		NetNfcGDbusSnep *object,
 		GDBusMethodInvocation *invocation,
 		guint arg_snep_handle,
 		guint arg_type,
 		GVariant *arg_ndef_msg,
-		GVariant *arg_privilege)
+		gboolean fd)
 {
-	bool ret;
 	gboolean result;
 	GVariant *parameter;
 
-	NFC_INFO(">>> REQUEST from [%s]", g_dbus_method_invocation_get_sender(invocation));
-
-	/* check privilege and update client context */
-	ret = net_nfc_server_gdbus_check_privilege(invocation, arg_privilege,
-				"nfc-manager::p2p", "rw");
-	if (false == ret)
-	{
-		NFC_ERR("permission denied, and finished request");
-
-		return FALSE;
-	}
-
-	parameter = g_variant_new("(uuuu@a(y))",
+	parameter = g_variant_new("(uuuub@ay)",
 			GPOINTER_TO_UINT(g_object_ref(object)),
 			GPOINTER_TO_UINT(g_object_ref(invocation)),
 			arg_snep_handle,
 			arg_type,
+			fd,
 			arg_ndef_msg);
 
 	if (parameter != NULL)
 	{
-		result = net_nfc_server_controller_async_queue_push(
+		result = net_nfc_server_controller_async_queue_push_priority(
+						NET_NFC_CONTROLLER_PRIORITY_P2P,
 						snep_client_send_request_thread_func, parameter);
 		if (FALSE == result)
 		{
@@ -539,6 +562,75 @@ static gboolean _handle_client_send_request(
 	return result;
 }
 
+static gboolean _handle_client_send_request(
+		NetNfcGDbusSnep *object,
+		GDBusMethodInvocation *invocation,
+		guint arg_snep_handle,
+		guint arg_type,
+		GVariant *arg_ndef_msg,
+		GVariant *arg_privilege)
+{
+	bool ret;
+
+	NFC_INFO(">>> REQUEST from [%s]", g_dbus_method_invocation_get_sender(invocation));
+
+	/* check privilege and update client context */
+	ret = net_nfc_server_gdbus_check_privilege(invocation, arg_privilege,
+				"nfc-manager::p2p", "rw");
+	if (false == ret)
+	{
+		NFC_ERR("permission denied, and finished request");
+
+		return FALSE;
+	}
+
+	return _client_send_request_push(object, invocation, arg_snep_handle,
+			arg_type, arg_ndef_msg, FALSE);
+}
+
+static gboolean _handle_client_send_request_fd(
+		NetNfcGDbusSnep *object,
+		GDBusMethodInvocation *invocation,
+		GUnixFDList *fd_list,
+		guint arg_snep_handle,
+		guint arg_type,
+		gint32 arg_ndef_msg,
+		GVariant *arg_privilege)
+{
+	bool ret;
+	data_s data;
+	GVariant *ndef_msg;
+	GMappedFile *mapped;
+
+	NFC_INFO(">>> REQUEST from [%s]", g_dbus_method_invocation_get_sender(invocation));
+
+	/* check privilege and update client context */
+	ret = net_nfc_server_gdbus_check_privilege(invocation, arg_privilege,
+				"nfc-manager::p2p", "rw");
+	if (false == ret)
+	{
+		NFC_ERR("permission denied, and finished request");
+
+		return FALSE;
+	}
+
+	mapped = net_nfc_util_gdbus_fd_list_to_data_s(fd_list, arg_ndef_msg, &data);
+	if (NULL == mapped)
+	{
+		g_dbus_method_invocation_return_dbus_error(invocation,
+				"org.tizen.NetNfcService.Snep.DataError", "Can not map data");
+
+		return FALSE;
+	}
+
+	/* the variant owns the mapping and unmaps it when released */
+	ndef_msg = g_variant_new_from_data(G_VARIANT_TYPE_BYTESTRING, data.buffer,
+			data.length, TRUE, (GDestroyNotify)g_mapped_file_unref, mapped);
+
+	return _client_send_request_push(object, invocation, arg_snep_handle,
+			arg_type, ndef_msg, TRUE);
+}
+
 static void snep_stop_service_thread_func(gpointer user_data)
 {
 	NetNfcGDbusSnep *object;
@@ -595,7 +687,9 @@ static gboolean _handle_stop_snep(
 
 	if (parameter != NULL)
 	{
-		result = net_nfc_server_controller_async_queue_push(
+		result = net_nfc_server_controller_async_queue_push_handle(
+						NET_NFC_CONTROLLER_PRIORITY_P2P,
+						GUINT_TO_POINTER(arg_handle),
 						snep_stop_service_thread_func, parameter);
 		if (FALSE == result)
 		{
@@ -753,7 +847,8 @@ static gboolean _handle_register_server(
 
 	if (parameter != NULL)
 	{
-		result = net_nfc_server_controller_async_queue_push(
+		result = net_nfc_server_controller_async_queue_push_priority(
+						NET_NFC_CONTROLLER_PRIORITY_P2P,
 						snep_register_server_thread_func, parameter);
 		if (FALSE == result)
 		{
@@ -840,7 +935,8 @@ static gboolean _handle_unregister_server(
 
 	if (parameter != NULL)
 	{
-		result = net_nfc_server_controller_async_queue_push(
+		result = net_nfc_server_controller_async_queue_push_priority(
+						NET_NFC_CONTROLLER_PRIORITY_P2P,
 						snep_unregister_server_thread_func, parameter);
 		if (FALSE == result)
 		{
@@ -894,6 +990,9 @@ gboolean net_nfc_server_snep_init(GDBusConnection *connection)
 	g_signal_connect(snep_skeleton, "handle-client-request",
 			G_CALLBACK(_handle_client_send_request), NULL);
 
+	g_signal_connect(snep_skeleton, "handle-client-request-fd",
+			G_CALLBACK(_handle_client_send_request_fd), NULL);
+
 	g_signal_connect(snep_skeleton, "handle-stop-snep",
 			G_CALLBACK(_handle_stop_snep), NULL);
 
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2012-2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 				 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "net_nfc_debug_internal.h"
+#include "net_nfc_server_statistics.h"
+
+#define STATISTICS_SLOTS	96
+#define STATISTICS_BUCKETS	24
+
+typedef struct _StatisticsSlot StatisticsSlot;
+
+/* updated with atomics only, the hot paths never take a lock */
+struct _StatisticsSlot
+{
+	const gchar *name;
+	guint count;
+	guint64 total;
+	gint max;
+	guint buckets[STATISTICS_BUCKETS];
+};
+
+static StatisticsSlot statistics_slots[STATISTICS_SLOTS];
+
+
+static guint statistics_bucket(gint64 elapsed)
+{
+	guint i;
+
+	for (i = 0; i < STATISTICS_BUCKETS - 1; i++)
+	{
+		if (elapsed < ((gint64)1 << i))
+			break;
+	}
+
+	return i;
+}
+
+static StatisticsSlot *statistics_lookup(gint *slot, const gchar *name)
+{
+	gint i;
+	const gchar *owner;
+
+	i = g_atomic_int_get(slot);
+	if (i > 0)
+		return &statistics_slots[i - 1];
+
+	/* slots are taken in order, so racing callers with the same name
+	   meet at the first free one */
+	for (i = 0; i < STATISTICS_SLOTS; i++)
+	{
+		owner = g_atomic_pointer_get(&statistics_slots[i].name);
+		if (NULL == owner &&
+				g_atomic_pointer_compare_and_exchange(
+					&statistics_slots[i].name, NULL, name) == TRUE)
+		{
+			owner = name;
+		}
+		else
+		{
+			owner = g_atomic_pointer_get(&statistics_slots[i].name);
+		}
+
+		if (g_strcmp0(owner, name) == 0)
+		{
+			g_atomic_int_set(slot, i + 1);
+
+			return &statistics_slots[i];
+		}
+	}
+
+	return NULL;
+}
+
+void net_nfc_server_statistics_add(gint *slot, const gchar *name,
+		gint64 elapsed)
+{
+	gint max;
+	StatisticsSlot *stats;
+
+	RET_IF(NULL == slot);
+	RET_IF(NULL == name);
+
+	NET_NFC_SERVER_PROBE2(sample, name, elapsed);
+
+	stats = statistics_lookup(slot, name);
+	if (NULL == stats)
+	{
+		NFC_ERR("no room for [%s]", name);
+		return;
+	}
+
+	if (elapsed < 0)
+		elapsed = 0;
+	else if (elapsed > G_MAXINT)
+		elapsed = G_MAXINT;
+
+	g_atomic_int_inc(&stats->count);
+	__atomic_fetch_add(&stats->total, (guint64)elapsed, __ATOMIC_RELAXED);
+	g_atomic_int_inc(&stats->buckets[statistics_bucket(elapsed)]);
+
+	max = g_atomic_int_get(&stats->max);
+	while (elapsed > max)
+	{
+		if (g_atomic_int_compare_and_exchange(&stats->max, max,
+					(gint)elapsed) == TRUE)
+			break;
+
+		max = g_atomic_int_get(&stats->max);
+	}
+}
+
+GVariant *net_nfc_server_statistics_get(void)
+{
+	gint i, j;
+	const gchar *name;
+	StatisticsSlot *stats;
+	GVariantBuilder builder;
+	guint buckets[STATISTICS_BUCKETS];
+
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("a(sutuau)"));
+
+	/* a snapshot per counter, a sample may land in between */
+	for (i = 0; i < STATISTICS_SLOTS; i++)
+	{
+		stats = &statistics_slots[i];
+
+		name = g_atomic_pointer_get(&stats->name);
+		if (NULL == name)
+			break;
+
+		for (j = 0; j < STATISTICS_BUCKETS; j++)
+			buckets[j] = g_atomic_int_get(&stats->buckets[j]);
+
+		g_variant_builder_add(&builder, "(sutu@au)",
+				name,
+				g_atomic_int_get(&stats->count),
+				__atomic_load_n(&stats->total, __ATOMIC_RELAXED),
+				(guint)g_atomic_int_get(&stats->max),
+				g_variant_new_fixed_array(G_VARIANT_TYPE_UINT32, buckets,
+					STATISTICS_BUCKETS, sizeof(guint)));
+	}
+
+	return g_variant_builder_end(&builder);
+}
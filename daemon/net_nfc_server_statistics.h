@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2012-2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 				 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __NET_NFC_SERVER_STATISTICS_H__
+#define __NET_NFC_SERVER_STATISTICS_H__
+
+#include <glib.h>
+
+#ifdef USE_USDT
+#include <sys/sdt.h>
+
+#define NET_NFC_SERVER_PROBE1(name, a) DTRACE_PROBE1(nfc_manager, name, a)
+#define NET_NFC_SERVER_PROBE2(name, a, b) DTRACE_PROBE2(nfc_manager, name, a, b)
+#else
+#define NET_NFC_SERVER_PROBE1(name, a)
+#define NET_NFC_SERVER_PROBE2(name, a, b)
+#endif
+
+/* adds elapsed, in us, to the histogram of name. slot caches where
+   name is kept, callers start it at zero and keep it around */
+void net_nfc_server_statistics_add(gint *slot, const gchar *name,
+		gint64 elapsed);
+
+/* a(sutuau) : per operation name, samples, total us, max us and a
+   log2 histogram, bucket n holds samples from 2^(n-1) up to 2^n us
+   and the last one everything longer */
+GVariant *net_nfc_server_statistics_get(void);
+
+#endif //__NET_NFC_SERVER_STATISTICS_H__
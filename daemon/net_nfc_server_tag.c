@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <pthread.h>
 
 #include "net_nfc_debug_internal.h"
 #include "net_nfc_util_internal.h"
@@ -24,7 +25,9 @@
 #include "net_nfc_server_context.h"
 #include "net_nfc_server_util.h"
 #include "net_nfc_server_p2p.h"
+#include "net_nfc_server_manager.h"
 #include "net_nfc_server_process_handover.h"
+#include "net_nfc_util_ndef_message.h"
 #include "net_nfc_util_ndef_record.h"
 #include "net_nfc_server_tag.h"
 
@@ -36,17 +39,26 @@ struct _CurrentTagInfoData
 	GDBusMethodInvocation *invocation;
 };
 
+/* presence check interval in ms, it starts short after a detection
+   and doubles each time the tag is still there */
+#define TAG_WATCHDOG_INTERVAL_MIN	20
+#define TAG_WATCHDOG_INTERVAL_MAX	320
+
 typedef struct _WatchDogData WatchDogData;
 
 struct _WatchDogData
 {
 	net_nfc_target_type_e dev_type;
 	net_nfc_target_handle_s *handle;
+	guint interval;
 };
 
 static NetNfcGDbusTag *tag_skeleton = NULL;
 
+/* replaced from the plugin callback thread, read by the controller
+   thread, the lanes and the main loop */
 static net_nfc_current_target_info_s *current_target_info = NULL;
+static pthread_mutex_t target_info_lock = PTHREAD_MUTEX_INITIALIZER;
 
 static gboolean tag_is_isp_dep_ndef_formatable(net_nfc_target_handle_s *handle,
 		int dev_type)
@@ -157,9 +169,43 @@ static gboolean tag_read_ndef_message(net_nfc_target_handle_s *handle,
 	return TRUE;
 }
 
+static void tag_watchdog_thread_func(gpointer user_data);
+
+static gboolean tag_watchdog_timeout(gpointer user_data)
+{
+	WatchDogData *watch_dog = user_data;
+
+	/* a running transceive notices the removal by itself, and the
+	   tag is probably still moving, so look again soon */
+	if (net_nfc_server_controller_get_pending(
+				NET_NFC_CONTROLLER_PRIORITY_TAG) > 0)
+	{
+		watch_dog->interval = TAG_WATCHDOG_INTERVAL_MIN;
+		g_timeout_add(watch_dog->interval, tag_watchdog_timeout, watch_dog);
+
+		return G_SOURCE_REMOVE;
+	}
+
+	if (net_nfc_server_controller_async_queue_push_handle(
+				NET_NFC_CONTROLLER_PRIORITY_DISCOVERY, watch_dog->handle,
+				tag_watchdog_thread_func, watch_dog) == FALSE)
+	{
+		NFC_ERR("can not create watch dog");
+		g_free(watch_dog);
+	}
+
+	return G_SOURCE_REMOVE;
+}
+
+static void tag_watchdog_start(WatchDogData *watch_dog)
+{
+	watch_dog->interval = TAG_WATCHDOG_INTERVAL_MIN;
+
+	g_timeout_add(watch_dog->interval, tag_watchdog_timeout, watch_dog);
+}
+
 static void tag_watchdog_thread_func(gpointer user_data)
 {
-	gboolean ret;
 	net_nfc_target_handle_s *handle;
 	bool is_present_target = false;
 	net_nfc_error_e result = NET_NFC_OK;
@@ -168,10 +214,6 @@ static void tag_watchdog_thread_func(gpointer user_data)
 	RET_IF(NULL == watch_dog);
 	RET_IF(NULL == watch_dog->handle);
 
-	/* IMPORTANT, TEMPORARY : switching context to another thread
-	   for give CPU time */
-	g_usleep(10000);
-
 	handle = watch_dog->handle;
 	if (handle->connection_type == NET_NFC_P2P_CONNECTION_TARGET ||
 			handle->connection_type == NET_NFC_TAG_CONNECTION)
@@ -181,13 +223,10 @@ static void tag_watchdog_thread_func(gpointer user_data)
 
 	if (true == is_present_target)
 	{
-		ret = net_nfc_server_controller_async_queue_push(tag_watchdog_thread_func,
-					watch_dog);
-		if(FALSE == ret)
-		{
-			NFC_ERR("can not create watch dog");
-			g_free(watch_dog);
-		}
+		watch_dog->interval = MIN(watch_dog->interval * 2,
+				TAG_WATCHDOG_INTERVAL_MAX);
+		g_timeout_add(watch_dog->interval, tag_watchdog_timeout, watch_dog);
+
 		return;
 	}
 
@@ -200,10 +239,17 @@ static void tag_watchdog_thread_func(gpointer user_data)
 		}
 	}
 
+	/* whatever is still queued for the tag would only wait for rf timeouts */
+	net_nfc_server_controller_cancel_handle(handle);
+
 	net_nfc_server_set_state(NET_NFC_SERVER_IDLE);
 
-	net_nfc_gdbus_tag_emit_tag_detached(tag_skeleton, GPOINTER_TO_UINT(handle),
-			watch_dog->dev_type);
+	net_nfc_server_gdbus_emit_event(G_DBUS_INTERFACE_SKELETON(tag_skeleton),
+			"TagDetached",
+			net_nfc_util_get_event_filter(watch_dog->dev_type),
+			NULL,
+			g_variant_new("(ui)", GPOINTER_TO_UINT(handle), watch_dog->dev_type),
+			NULL);
 
 	g_free(watch_dog);
 }
@@ -230,7 +276,7 @@ static void tag_get_current_tag_info_thread_func(gpointer user_data)
 	g_assert(info_data->tag != NULL);
 	g_assert(info_data->invocation != NULL);
 
-	target_info = net_nfc_server_get_target_info();
+	target_info = net_nfc_server_dup_target_info();
 	if (target_info != NULL && target_info->devType != NET_NFC_NFCIP1_TARGET &&
 			target_info->devType != NET_NFC_NFCIP1_INITIATOR)
 	{
@@ -269,6 +315,8 @@ static void tag_get_current_tag_info_thread_func(gpointer user_data)
 			net_nfc_util_gdbus_data_to_variant(&target_info_values),
 			net_nfc_util_gdbus_data_to_variant(raw_data));
 
+	g_free(target_info);
+
 	if (raw_data != NULL)
 	{
 		net_nfc_util_free_data(raw_data);
@@ -281,6 +329,71 @@ static void tag_get_current_tag_info_thread_func(gpointer user_data)
 	g_free(info_data);
 }
 
+static void tag_emit_tag_discovered(net_nfc_current_target_info_s *target,
+		gboolean is_ndef_supported,
+		guint8 ndef_card_state,
+		guint32 max_data_size,
+		guint32 actual_data_size,
+		GVariant *target_info_values,
+		GVariant *raw_data)
+{
+	gsize length = 0;
+	data_s ndef_data;
+	ndef_message_s ndef = { 0, };
+	bool parsed = false;
+	GVariant *parameters_no_raw = NULL;
+
+	g_variant_ref_sink(target_info_values);
+	g_variant_ref_sink(raw_data);
+
+	/* records are only compared with the event filters of clients */
+	ndef_data.buffer = (uint8_t *)g_variant_get_fixed_array(raw_data, &length,
+			sizeof(guint8));
+	ndef_data.length = length;
+
+	if (length > 0 && net_nfc_util_convert_rawdata_to_ndef_message_view(
+				&ndef_data, &ndef, NULL, 0) == NET_NFC_OK)
+	{
+		parsed = true;
+	}
+
+	if (length > 0)
+	{
+		parameters_no_raw = g_variant_new("(uibyuuu@ay@ay)",
+				GPOINTER_TO_UINT(target->handle),
+				target->devType,
+				is_ndef_supported,
+				ndef_card_state,
+				max_data_size,
+				actual_data_size,
+				target->number_of_keys,
+				target_info_values,
+				net_nfc_util_gdbus_buffer_to_variant(NULL, 0));
+	}
+
+	net_nfc_server_gdbus_emit_event(G_DBUS_INTERFACE_SKELETON(tag_skeleton),
+			"TagDiscovered",
+			net_nfc_util_get_event_filter(target->devType),
+			&ndef,
+			g_variant_new("(uibyuuu@ay@ay)",
+				GPOINTER_TO_UINT(target->handle),
+				target->devType,
+				is_ndef_supported,
+				ndef_card_state,
+				max_data_size,
+				actual_data_size,
+				target->number_of_keys,
+				target_info_values,
+				raw_data),
+			parameters_no_raw);
+
+	if (true == parsed)
+		net_nfc_util_release_ndef_message_view(&ndef);
+
+	g_variant_unref(raw_data);
+	g_variant_unref(target_info_values);
+}
+
 static void tag_slave_target_detected_thread_func(gpointer user_data)
 {
 	bool ret;
@@ -295,12 +408,15 @@ static void tag_slave_target_detected_thread_func(gpointer user_data)
 	net_nfc_current_target_info_s *target;
 	GVariant *target_info_values = NULL;
 
-	target = net_nfc_server_get_target_info();
-
-	g_assert(target != NULL); /* raise exception!!! what;s wrong?? */
-
 	RET_IF(NULL == tag_skeleton);
 
+	target = net_nfc_server_dup_target_info();
+	if (NULL == target)
+	{
+		NFC_ERR("the target is gone already");
+		return;
+	}
+
 	if (net_nfc_controller_connect(target->handle, &result) == false)
 	{
 		NFC_ERR("connect failed & Retry Polling!!");
@@ -310,6 +426,7 @@ static void tag_slave_target_detected_thread_func(gpointer user_data)
 		if (false == ret)
 			net_nfc_controller_exception_handler();
 
+		g_free(target);
 		return;
 	}
 
@@ -347,16 +464,19 @@ static void tag_slave_target_detected_thread_func(gpointer user_data)
 				isHandoverMessage = true;
 				if (NET_NFC_OK == result)
 				{
-					net_nfc_util_create_record(record->TNF, &record->type_s, &record->id_s,
-							&record->payload_s, &recordasperpriority);
+					net_nfc_util_share_record(record, &recordasperpriority);
 
 					net_nfc_server_handover_process_carrier_record(recordasperpriority,
 							NULL, NULL);
+
+					net_nfc_util_free_record(recordasperpriority);
 				}
 				else
 				{
 					NFC_ERR("_get_carrier_record_by_priority_order failed, [%d]",result);
 				}
+
+				net_nfc_util_free_ndef_message(selector);
 			}
 			else
 			{
@@ -385,14 +505,11 @@ static void tag_slave_target_detected_thread_func(gpointer user_data)
 	if(isHandoverMessage == false)
 	{
 		/* send TagDiscoverd signal */
-		net_nfc_gdbus_tag_emit_tag_discovered(tag_skeleton,
-				GPOINTER_TO_UINT(target->handle),
-				target->devType,
+		tag_emit_tag_discovered(target,
 				is_ndef_supported,
 				ndef_card_state,
 				max_data_size,
 				actual_data_size,
-				target->number_of_keys,
 				target_info_values,
 				raw_data);
 	}
@@ -404,19 +521,16 @@ static void tag_slave_target_detected_thread_func(gpointer user_data)
 	if(NULL == watch_dog)
 	{
 		NFC_ERR("Memory allocation failed");
+		g_free(target);
 		return;
 	}
 
 	watch_dog->dev_type = target->devType;
 	watch_dog->handle = target->handle;
 
-	if (net_nfc_server_controller_async_queue_push(
-				tag_watchdog_thread_func, watch_dog) == FALSE)
-	{
-		NFC_ERR("can not create watch dog");
-		g_free(watch_dog);
-		return;
-	}
+	g_free(target);
+
+	tag_watchdog_start(watch_dog);
 }
 
 
@@ -444,11 +558,13 @@ static gboolean tag_handle_is_tag_connected(NetNfcGDbusTag *tag,
 		goto END;
 	}
 
-	target_info = net_nfc_server_get_target_info();
+	target_info = net_nfc_server_dup_target_info();
 	if (target_info != NULL)
 	{
 		dev_type = target_info->devType;
 		is_connected = TRUE;
+
+		g_free(target_info);
 	}
 
 	result = NET_NFC_OK;
@@ -466,6 +582,7 @@ static gboolean tag_handle_get_current_tag_info(NetNfcGDbusTag *tag,
 	bool ret;
 	gboolean result;
 	CurrentTagInfoData *info_data;
+	net_nfc_current_target_info_s *target_info;
 
 	NFC_INFO(">>> REQUEST from [%s]", g_dbus_method_invocation_get_sender(invocation));
 
@@ -492,8 +609,15 @@ static gboolean tag_handle_get_current_tag_info(NetNfcGDbusTag *tag,
 	info_data->tag = g_object_ref(tag);
 	info_data->invocation = g_object_ref(invocation);
 
-	result = net_nfc_server_controller_async_queue_push(
+	/* the reads below go to the current target, keep them in its lane */
+	target_info = net_nfc_server_dup_target_info();
+
+	result = net_nfc_server_controller_async_queue_push_handle(
+			NET_NFC_CONTROLLER_PRIORITY_TAG,
+			(target_info != NULL) ? target_info->handle : NULL,
 			tag_get_current_tag_info_thread_func, info_data);
+
+	g_free(target_info);
 	if (FALSE == result)
 	{
 		g_dbus_method_invocation_return_dbus_error(invocation,
@@ -532,11 +656,13 @@ static gboolean tag_handle_get_current_target_handle(NetNfcGDbusTag *tag,
 		goto END;
 	}
 
-	target_info = net_nfc_server_get_target_info();
+	target_info = net_nfc_server_dup_target_info();
 	if (target_info != NULL)
 	{
 		handle = target_info->handle;
 		devType = target_info->devType;
+
+		g_free(target_info);
 	}
 
 	result = NET_NFC_OK;
@@ -591,61 +717,116 @@ void net_nfc_server_tag_deinit(void)
 	}
 }
 
+/* same answer as IsTagConnected, for GetSnapshot */
+static void tag_update_state(net_nfc_target_handle_s *handle,
+		net_nfc_target_type_e dev_type)
+{
+	net_nfc_server_manager_update_state("tag_connected",
+			g_variant_new_boolean(handle != NULL));
+	net_nfc_server_manager_update_state("tag_handle",
+			g_variant_new_uint32(GPOINTER_TO_UINT(handle)));
+	net_nfc_server_manager_update_state("tag_type", g_variant_new_int32(dev_type));
+}
+
 void net_nfc_server_set_target_info(void *info)
 {
+	uint32_t length;
 	net_nfc_request_target_detected_t *target;
-
-	if (current_target_info)
-		g_free(current_target_info);
+	net_nfc_current_target_info_s *target_info;
 
 	target = (net_nfc_request_target_detected_t *)info;
 
-	current_target_info = g_malloc0(sizeof(net_nfc_current_target_info_s) +
-			target->target_info_values.length);
+	/* target info is kept compact encoded right after the struct, it is
+	   sent as is with every TagDiscovered and GetCurrentTagInfo */
+	length = NET_NFC_TAG_INFO_ENCODED_MAX(target->target_info_values.length,
+			target->number_of_keys);
 
-	current_target_info->handle = target->handle;
-	current_target_info->devType = target->devType;
+	target_info = g_malloc0(sizeof(net_nfc_current_target_info_s) + length);
 
-	if (current_target_info->devType != NET_NFC_NFCIP1_INITIATOR &&
-			current_target_info->devType != NET_NFC_NFCIP1_TARGET)
-	{
-		current_target_info->number_of_keys = target->number_of_keys;
-		current_target_info->target_info_values.length =
-			target->target_info_values.length;
+	target_info->handle = target->handle;
+	target_info->devType = target->devType;
 
-		memcpy(&current_target_info->target_info_values,
-				&target->target_info_values,
-				current_target_info->target_info_values.length);
+	if (target_info->devType != NET_NFC_NFCIP1_INITIATOR &&
+			target_info->devType != NET_NFC_NFCIP1_TARGET)
+	{
+		target_info->target_info_values.buffer = (uint8_t *)(target_info + 1);
+		target_info->target_info_values.length =
+			net_nfc_util_encode_tag_info(&target->target_info_values,
+					target->number_of_keys,
+					target_info->target_info_values.buffer,
+					length);
+
+		if (target_info->target_info_values.length > 0)
+			target_info->number_of_keys = target->number_of_keys;
+		else
+			NFC_ERR("malformed target info of [%d] keys", target->number_of_keys);
 	}
+
+	pthread_mutex_lock(&target_info_lock);
+
+	g_free(current_target_info);
+	current_target_info = target_info;
+
+	pthread_mutex_unlock(&target_info_lock);
+
+	tag_update_state(target->handle, target->devType);
 }
 
-net_nfc_current_target_info_s *net_nfc_server_get_target_info(void)
+net_nfc_current_target_info_s *net_nfc_server_dup_target_info(void)
 {
-	return current_target_info;
+	net_nfc_current_target_info_s *target_info = NULL;
+
+	pthread_mutex_lock(&target_info_lock);
+
+	if (current_target_info != NULL)
+	{
+		target_info = g_memdup(current_target_info,
+				sizeof(net_nfc_current_target_info_s) +
+				current_target_info->target_info_values.length);
+
+		if (target_info->target_info_values.buffer != NULL)
+			target_info->target_info_values.buffer = (uint8_t *)(target_info + 1);
+	}
+
+	pthread_mutex_unlock(&target_info_lock);
+
+	return target_info;
 }
 
 gboolean net_nfc_server_target_connected(net_nfc_target_handle_s *handle)
 {
-	if (NULL == current_target_info)
-		return FALSE;
+	gboolean connected;
 
-	if (current_target_info->handle != handle)
-		return FALSE;
+	pthread_mutex_lock(&target_info_lock);
 
-	return TRUE;
+	connected = (current_target_info != NULL &&
+			current_target_info->handle == handle);
+
+	pthread_mutex_unlock(&target_info_lock);
+
+	return connected;
 }
 
 void net_nfc_server_free_target_info(void)
 {
+	pthread_mutex_lock(&target_info_lock);
+
 	g_free(current_target_info);
 	current_target_info = NULL;
+
+	pthread_mutex_unlock(&target_info_lock);
+
+	tag_update_state(NULL, NET_NFC_UNKNOWN_TARGET);
 }
 
 void net_nfc_server_tag_target_detected(void *info)
 {
 	gboolean ret;
 
-	ret = net_nfc_server_controller_async_queue_push(
+	net_nfc_request_target_detected_t *req = info;
+
+	ret = net_nfc_server_controller_async_queue_push_handle(
+				NET_NFC_CONTROLLER_PRIORITY_DISCOVERY, req->handle,
 				tag_slave_target_detected_thread_func, NULL);
 
 	if (FALSE == ret)
@@ -27,7 +27,8 @@ void net_nfc_server_tag_deinit(void);
 
 void net_nfc_server_set_target_info(void *info);
 
-net_nfc_current_target_info_s *net_nfc_server_get_target_info(void);
+/* a copy of the current target, NULL if there is none. g_free() it */
+net_nfc_current_target_info_s *net_nfc_server_dup_target_info(void);
 
 gboolean net_nfc_server_target_connected(net_nfc_target_handle_s *handle);
 
@@ -27,6 +27,10 @@
 #include "net_nfc_server_transceive.h"
 
 
+/* upper bound of commands in one TransceiveBatch, a 4K MIFARE Classic
+   dump with its sector authentications fits easily */
+#define TRANSCEIVE_BATCH_MAX	1024
+
 static NetNfcGDbusTransceive *transceive_skeleton = NULL;
 
 
@@ -40,6 +44,17 @@ struct _TransceiveSendData
 	net_nfc_transceive_info_s transceive_info;
 };
 
+typedef struct _TransceiveBatchData TransceiveBatchData;
+
+struct _TransceiveBatchData
+{
+	NetNfcGDbusTransceive *transceive;
+	GDBusMethodInvocation *invocation;
+	guint transceive_handle;
+	guint dev_type;
+	GVariant *commands;
+};
+
 static void transceive_data_thread_func(gpointer user_data)
 {
 	bool ret;
@@ -55,7 +70,11 @@ static void transceive_data_thread_func(gpointer user_data)
 	g_assert(transceive_data->transceive != NULL);
 	g_assert(transceive_data->invocation != NULL);
 
-	if (net_nfc_server_target_connected(handle) == true)
+	if (net_nfc_server_controller_job_is_live(&result) == FALSE)
+	{
+		NFC_ERR("stale transceive dropped");
+	}
+	else if (net_nfc_server_target_connected(handle) == true)
 	{
 		NFC_DBG("call transceive");
 
@@ -134,7 +153,9 @@ static gboolean transceive_data_handle(NetNfcGDbusTransceive *transceive,
 	data->transceive_info.dev_type = dev_type;
 	net_nfc_util_gdbus_variant_to_data_s(arg_data, &data->transceive_info.trans_data);
 
-	result = net_nfc_server_controller_async_queue_push(transceive_data_thread_func, data);
+	result = net_nfc_server_controller_async_queue_push_job(
+			NET_NFC_CONTROLLER_PRIORITY_TAG, GUINT_TO_POINTER(handle),
+			invocation, transceive_data_thread_func, data);
 	if (FALSE == result)
 	{
 		g_dbus_method_invocation_return_dbus_error(invocation,
@@ -166,7 +187,11 @@ static void transceive_thread_func(gpointer user_data)
 	g_assert(transceive_data->transceive != NULL);
 	g_assert(transceive_data->invocation != NULL);
 
-	if (net_nfc_server_target_connected(handle) == true)
+	if (net_nfc_server_controller_job_is_live(&result) == FALSE)
+	{
+		NFC_ERR("stale transceive dropped");
+	}
+	else if (net_nfc_server_target_connected(handle) == true)
 	{
 		NFC_DBG("call transceive");
 		ret = net_nfc_controller_transceive(handle, &transceive_data->transceive_info,
@@ -244,7 +269,9 @@ static gboolean transceive_handle(NetNfcGDbusTransceive *transceive,
 	net_nfc_util_gdbus_variant_to_data_s(arg_data,
 			&data->transceive_info.trans_data);
 
-	result = net_nfc_server_controller_async_queue_push(transceive_thread_func, data);
+	result = net_nfc_server_controller_async_queue_push_job(
+			NET_NFC_CONTROLLER_PRIORITY_TAG, GUINT_TO_POINTER(handle),
+			invocation, transceive_thread_func, data);
 	if (FALSE == result)
 	{
 		g_dbus_method_invocation_return_dbus_error(invocation,
@@ -262,6 +289,167 @@ static gboolean transceive_handle(NetNfcGDbusTransceive *transceive,
 	return result;
 }
 
+static void transceive_batch_thread_func(gpointer user_data)
+{
+	bool ret;
+	gsize i, count;
+	gboolean stop_on_error;
+	GVariant *command;
+	GVariantBuilder builder;
+	net_nfc_error_e result = NET_NFC_OK;
+	net_nfc_error_e cmd_result;
+	net_nfc_transceive_info_s info;
+	TransceiveBatchData *batch_data = user_data;
+	net_nfc_target_handle_s *handle =
+		(net_nfc_target_handle_s *)batch_data->transceive_handle;
+
+	/* use assert because it was checked in handle function */
+	g_assert(batch_data != NULL);
+	g_assert(batch_data->transceive != NULL);
+	g_assert(batch_data->invocation != NULL);
+
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("a(iay)"));
+
+	info.dev_type = batch_data->dev_type;
+
+	count = g_variant_n_children(batch_data->commands);
+
+	if (net_nfc_server_controller_job_is_live(&result) == FALSE)
+	{
+		NFC_ERR("stale transceive batch dropped");
+		count = 0;
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		data_s *data = NULL;
+		gsize length = 0;
+
+		if (net_nfc_server_target_connected(handle) == false)
+		{
+			NFC_ERR("target is not connected");
+
+			result = NET_NFC_TARGET_IS_MOVED_AWAY;
+			break;
+		}
+
+		g_variant_get_child(batch_data->commands, i, "(b@ay)",
+				&stop_on_error, &command);
+
+		/* borrow the bytes, the controller does not keep them */
+		info.trans_data.buffer = (uint8_t *)g_variant_get_fixed_array(command,
+				&length, sizeof(uint8_t));
+		info.trans_data.length = length;
+
+		cmd_result = NET_NFC_OK;
+		ret = net_nfc_controller_transceive(handle, &info, &data, &cmd_result);
+		if (false == ret && NET_NFC_OK == cmd_result)
+			cmd_result = NET_NFC_OPERATION_FAIL;
+
+		g_variant_unref(command);
+
+		g_variant_builder_add(&builder, "(i@ay)", (gint)cmd_result,
+				net_nfc_util_gdbus_data_to_variant(data));
+
+		if (data != NULL)
+		{
+			g_free(data->buffer);
+			g_free(data);
+		}
+
+		if (cmd_result != NET_NFC_OK && TRUE == stop_on_error)
+		{
+			NFC_ERR("command [%d] failed [%d], stop the batch", (int)i, cmd_result);
+
+			result = cmd_result;
+			break;
+		}
+	}
+
+	NFC_DBG("transceive batch result : %d", result);
+
+	net_nfc_gdbus_transceive_complete_transceive_batch(batch_data->transceive,
+			batch_data->invocation, (gint)result,
+			g_variant_builder_end(&builder));
+
+	g_variant_unref(batch_data->commands);
+
+	g_object_unref(batch_data->invocation);
+	g_object_unref(batch_data->transceive);
+
+	g_free(batch_data);
+}
+
+static gboolean transceive_batch_handle(NetNfcGDbusTransceive *transceive,
+		GDBusMethodInvocation *invocation,
+		guint handle,
+		guint dev_type,
+		GVariant *arg_commands,
+		GVariant *smack_privilege,
+		gpointer user_data)
+{
+	bool ret;
+	gboolean result;
+	TransceiveBatchData *data;
+
+	NFC_INFO(">>> REQUEST from [%s]", g_dbus_method_invocation_get_sender(invocation));
+
+	/* check privilege and update client context */
+	ret = net_nfc_server_gdbus_check_privilege(invocation, smack_privilege,
+				"nfc-manager", "rw");
+	if (false == ret)
+	{
+		NFC_ERR("permission denied, and finished request");
+
+		return FALSE;
+	}
+
+	if (g_variant_n_children(arg_commands) > TRANSCEIVE_BATCH_MAX)
+	{
+		NFC_ERR("too many commands [%d]", (int)g_variant_n_children(arg_commands));
+		g_dbus_method_invocation_return_dbus_error(invocation,
+				"org.tizen.NetNfcService.Transceive.DataError",
+				"too many commands");
+
+		return FALSE;
+	}
+
+	data = g_new0(TransceiveBatchData, 1);
+	if (NULL == data)
+	{
+		NFC_ERR("Memory allocation failed");
+		g_dbus_method_invocation_return_dbus_error(invocation,
+				"org.tizen.NetNfcService.AllocationError", "Can not allocate memory");
+
+		return FALSE;
+	}
+
+	data->transceive = g_object_ref(transceive);
+	data->invocation = g_object_ref(invocation);
+	data->transceive_handle = handle;
+	data->dev_type = dev_type;
+	data->commands = g_variant_ref(arg_commands);
+
+	result = net_nfc_server_controller_async_queue_push_job(
+			NET_NFC_CONTROLLER_PRIORITY_TAG, GUINT_TO_POINTER(handle),
+			invocation, transceive_batch_thread_func, data);
+	if (FALSE == result)
+	{
+		g_dbus_method_invocation_return_dbus_error(invocation,
+				"org.tizen.NetNfcService.Transceive.ThreadError",
+				"can not push to controller thread");
+
+		g_variant_unref(data->commands);
+
+		g_object_unref(data->transceive);
+		g_object_unref(data->invocation);
+
+		g_free(data);
+	}
+
+	return result;
+}
+
 
 gboolean net_nfc_server_transceive_init(GDBusConnection *connection)
 {
@@ -279,6 +467,9 @@ gboolean net_nfc_server_transceive_init(GDBusConnection *connection)
 	g_signal_connect(transceive_skeleton, "handle-transceive",
 			G_CALLBACK(transceive_handle), NULL);
 
+	g_signal_connect(transceive_skeleton, "handle-transceive-batch",
+			G_CALLBACK(transceive_batch_handle), NULL);
+
 	result = g_dbus_interface_skeleton_export(
 			G_DBUS_INTERFACE_SKELETON(transceive_skeleton),
 			connection,
@@ -574,14 +574,15 @@ net_nfc_error_e net_nfc_app_util_process_ndef(data_s *data)
 		return result;
 	}
 
-	if (net_nfc_util_create_ndef_message(&msg) != NET_NFC_OK)
+	if ((result = net_nfc_util_create_pooled_ndef_message(&msg)) != NET_NFC_OK)
 	{
-		NFC_ERR("memory alloc fail..");
-		return NET_NFC_ALLOC_FAIL;
+		NFC_ERR("net_nfc_util_create_pooled_ndef_message failed [%d]", result);
+		return result;
 	}
 
-	/* parse ndef message and fill appsvc data */
-	if ((result = net_nfc_util_convert_rawdata_to_ndef_message(data, msg)) != NET_NFC_OK)
+	/* parse ndef message and fill appsvc data, records are only read here */
+	if ((result = net_nfc_util_convert_rawdata_to_ndef_message_view(data, msg,
+					NULL, 0)) != NET_NFC_OK)
 	{
 		NFC_ERR("net_nfc_app_util_store_ndef_message failed [%d]", result);
 		goto ERROR;
@@ -1,5 +1,7 @@
 %bcond_with wayland	1
 %bcond_with x
+%bcond_with socket_ipc
+%bcond_with usdt
 
 Name:       nfc-manager-neard
 Summary:    NFC framework manager
@@ -37,6 +39,9 @@ BuildRequires: pkgconfig(ecore-x)
 BuildRequires: pkgconfig(ecore-wayland)
 %endif
 BuildRequires:  pkgconfig(deviced)
+%if %{with usdt}
+BuildRequires:  systemtap-sdt-devel
+%endif
 BuildRequires:  pkgconfig(libtzplatform-config)
 BuildRequires:  pkgconfig(neardal)
 BuildRequires:  python
@@ -106,9 +111,19 @@ MAJORVER=`echo %{version} | awk 'BEGIN {FS="."}{print $1}'`
 -DWAYLAND_SUPPORT=Off \
 %endif
 %if %{with x}
--DX11_SUPPORT=On
+-DX11_SUPPORT=On \
+%else
+-DX11_SUPPORT=Off \
+%endif
+%if %{with socket_ipc}
+-DUSE_SOCKET_IPC=On \
+%else
+-DUSE_SOCKET_IPC=Off \
+%endif
+%if %{with usdt}
+-DUSE_USDT=On
 %else
--DX11_SUPPORT=Off
+-DUSE_USDT=Off
 %endif
 
 make %{?_smp_mflags}
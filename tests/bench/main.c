@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2012-2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 				 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+#include <glib.h>
+
+#include "net_nfc_bench_util.h"
+#include "net_nfc_bench_ndef.h"
+#include "net_nfc_bench_uri.h"
+#include "net_nfc_bench_gdbus.h"
+#include "net_nfc_bench_tag_info.h"
+#include "net_nfc_bench_ipc.h"
+
+
+typedef struct _BenchData BenchData;
+
+struct _BenchData
+{
+	gchar *name;
+	GFunc func;
+	gchar *comment;
+};
+
+static BenchData bench_data[] = {
+	{
+		"Ndef.Build",
+		net_nfc_bench_ndef_build,
+		"Build and free a message, record by record"
+	},
+
+	{
+		"Ndef.BuildArena",
+		net_nfc_bench_ndef_build_arena,
+		"Build and free a message carved from an arena"
+	},
+
+	{
+		"Ndef.Parse",
+		net_nfc_bench_ndef_parse,
+		"Parse raw data and free the message"
+	},
+
+	{
+		"Ndef.ParseArena",
+		net_nfc_bench_ndef_parse_arena,
+		"Parse raw data into an arena message and free it"
+	},
+
+	{
+		"Ndef.ParsePooled",
+		net_nfc_bench_ndef_parse_pooled,
+		"Parse raw data into a pooled message and free it"
+	},
+
+	{
+		"Ndef.HandoverRequest",
+		net_nfc_bench_ndef_handover_request,
+		"Create and free a handover request message"
+	},
+
+	{
+		"Ndef.HandoverRequestArena",
+		net_nfc_bench_ndef_handover_request_arena,
+		"Create and free a handover request message carved from an arena"
+	},
+
+	{
+		"Ndef.Append1k",
+		net_nfc_bench_ndef_append_1k,
+		"Build and free a message of 1000 records"
+	},
+
+	{
+		"Ndef.GetByIndex1k",
+		net_nfc_bench_ndef_get_by_index_1k,
+		"Look up every record of a 1000 record message by index"
+	},
+
+	{
+		"Ndef.InsertRemove1k",
+		net_nfc_bench_ndef_insert_remove_1k,
+		"Insert and remove a record in the middle of a 1000 record message"
+	},
+
+	{
+		"Ndef.SearchById1k",
+		net_nfc_bench_ndef_search_by_id_1k,
+		"Look up each record of a 1000 record message by id"
+	},
+
+	{
+		"Ndef.ParseThroughput",
+		net_nfc_bench_ndef_parse_throughput,
+		"Decode a 1000 record message in place"
+	},
+
+	{
+		"Ndef.Serialize",
+		net_nfc_bench_ndef_serialize,
+		"Serialize a message into a newly allocated buffer"
+	},
+
+	{
+		"Ndef.SerializeIovec",
+		net_nfc_bench_ndef_serialize_iovec,
+		"Serialize a message into iov entries without copying payloads"
+	},
+
+	{
+		"Ndef.StreamParse",
+		net_nfc_bench_ndef_stream_parse,
+		"Parse a message fed in LLCP MIU sized fragments"
+	},
+
+	{
+		"Uri.Encode",
+		net_nfc_bench_uri_encode,
+		"Create uri records from a batch of uris, abbreviating prefixes"
+	},
+
+	{
+		"Uri.Decode",
+		net_nfc_bench_uri_decode,
+		"Expand a batch of uri records into a caller buffer"
+	},
+
+	{
+		"Gdbus.Data",
+		net_nfc_bench_gdbus_data,
+		"Marshal a 10K buffer to an ay variant and back"
+	},
+
+	{
+		"TagInfo.Decode",
+		net_nfc_bench_tag_info_decode,
+		"Decode compact target info and look up two keys"
+	},
+
+	{
+		"Ipc.Dbus",
+		net_nfc_bench_ipc_dbus,
+		"GetServerState round trip through the bus, needs the daemon"
+	},
+
+	{
+		"Ipc.Socket",
+		net_nfc_bench_ipc_socket,
+		"GetServerState round trip over the Unix socket, needs the daemon"
+	},
+
+	{
+		"Ipc.SocketPipelined",
+		net_nfc_bench_ipc_socket_pipelined,
+		"GetServerState over the Unix socket, 16 requests in flight"
+	},
+
+	{ NULL }
+};
+
+static gboolean run_bench(const gchar *name)
+{
+	gint i;
+
+	for (i = 0; i < G_N_ELEMENTS(bench_data) - 1; i++)
+	{
+		if (name == NULL || strcmp(bench_data[i].name, name) == 0)
+		{
+			bench_data[i].func(NULL, NULL);
+
+			if (name != NULL)
+				return TRUE;
+		}
+	}
+
+	return (name == NULL);
+}
+
+int main(int argc, char *argv[])
+{
+	gint i;
+
+	if (argc == 2 && strcmp(argv[1], "--help") == 0)
+	{
+		g_print("nfc-bench: nfc-bench [name]...\n");
+		g_print("\n");
+
+		for (i = 0; i < G_N_ELEMENTS(bench_data) - 1; i++)
+		{
+			g_print("\t%s : %s\n", bench_data[i].name,
+					bench_data[i].comment);
+		}
+		return 0;
+	}
+
+	if (argc == 1)
+	{
+		run_bench(NULL);
+		return 0;
+	}
+
+	for (i = 1; i < argc; i++)
+	{
+		if (run_bench(argv[i]) == FALSE)
+		{
+			g_printerr("unknown bench [%s]\n", argv[i]);
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2012-2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 				 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "net_nfc_typedef_internal.h"
+#include "net_nfc_util_internal.h"
+#include "net_nfc_util_gdbus_internal.h"
+
+#include "net_nfc_bench_util.h"
+#include "net_nfc_bench_gdbus.h"
+
+/* large enough to show the per byte cost of a transceive or ndef write */
+#define BENCH_GDBUS_DATA_LENGTH	(10 * 1024)
+
+static void _bench_fill(uint8_t *buffer, size_t length)
+{
+	size_t i;
+
+	for (i = 0; i < length; i++)
+		buffer[i] = (uint8_t)i;
+}
+
+void net_nfc_bench_gdbus_data(gpointer data, gpointer user_data)
+{
+	net_nfc_bench_result_s result;
+	uint8_t buffer[BENCH_GDBUS_DATA_LENGTH];
+	data_s source = { buffer, sizeof(buffer) };
+	data_s target;
+	GVariant *variant;
+	guint i;
+
+	_bench_fill(buffer, sizeof(buffer));
+
+	net_nfc_bench_start(&result, NET_NFC_BENCH_ITERATIONS);
+
+	for (i = 0; i < NET_NFC_BENCH_ITERATIONS; i++)
+	{
+		variant = g_variant_ref_sink(
+				net_nfc_util_gdbus_data_to_variant(&source));
+
+		net_nfc_util_gdbus_variant_to_data_s(variant, &target);
+
+		net_nfc_util_free_data(&target);
+		g_variant_unref(variant);
+	}
+
+	net_nfc_bench_stop(&result);
+	net_nfc_bench_print_throughput("Gdbus.Data", &result, 1, sizeof(buffer));
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2012-2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 				 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "net_nfc_typedef_internal.h"
+#include "net_nfc_util_gdbus_internal.h"
+#include "net_nfc_util_ipc_internal.h"
+#include "net_nfc_gdbus.h"
+
+#include "net_nfc_bench_util.h"
+#include "net_nfc_bench_ipc.h"
+
+/* these need a running daemon, and the socket one a daemon built with
+   USE_SOCKET_IPC. both time a GetServerState round trip, which the
+   daemon answers on its main loop without touching the controller */
+#define BENCH_IPC_ITERATIONS	(NET_NFC_BENCH_ITERATIONS / 10)
+
+/* requests written before the first reply is read */
+#define BENCH_IPC_WINDOW	16
+
+static void _bench_skip(const gchar *name, const gchar *reason)
+{
+	g_print("%-32s skipped, %s\n", name, reason);
+}
+
+void net_nfc_bench_ipc_dbus(gpointer data, gpointer user_data)
+{
+	net_nfc_bench_result_s result;
+	NetNfcGDbusManager *proxy;
+	GError *error = NULL;
+	gint out_result;
+	guint out_state;
+	guint i;
+
+	/* never start the daemon for a bench */
+	proxy = net_nfc_gdbus_manager_proxy_new_for_bus_sync(
+			G_BUS_TYPE_SYSTEM,
+			G_DBUS_PROXY_FLAGS_DO_NOT_AUTO_START,
+			"org.tizen.NetNfcService",
+			"/org/tizen/NetNfcService/Manager",
+			NULL,
+			&error);
+	if (NULL == proxy)
+	{
+		_bench_skip("Ipc.Dbus", error->message);
+		g_error_free(error);
+
+		return;
+	}
+
+	if (net_nfc_gdbus_manager_call_get_server_state_sync(proxy,
+				net_nfc_util_gdbus_buffer_to_variant(NULL, 0),
+				&out_result, &out_state, NULL, &error) == FALSE)
+	{
+		_bench_skip("Ipc.Dbus", error->message);
+		g_error_free(error);
+		g_object_unref(proxy);
+
+		return;
+	}
+
+	net_nfc_bench_start(&result, BENCH_IPC_ITERATIONS);
+
+	for (i = 0; i < BENCH_IPC_ITERATIONS; i++)
+	{
+		net_nfc_gdbus_manager_call_get_server_state_sync(proxy,
+				net_nfc_util_gdbus_buffer_to_variant(NULL, 0),
+				&out_result, &out_state, NULL, NULL);
+	}
+
+	net_nfc_bench_stop(&result);
+	net_nfc_bench_print("Ipc.Dbus", &result);
+
+	g_object_unref(proxy);
+}
+
+static gboolean _bench_socket_call(int fd, uint8_t *buffer, guint count)
+{
+	guint i;
+	net_nfc_ipc_header_s header = { 0, };
+
+	header.type = NET_NFC_IPC_GET_SERVER_STATE;
+
+	for (i = 0; i < count; i++)
+	{
+		header.id = i + 1;
+
+		if (net_nfc_util_ipc_send(fd, &header, NULL, 0) == false)
+			return FALSE;
+	}
+
+	/* the replies are taken in whatever order they arrive */
+	for (i = 0; i < count; i++)
+	{
+		if (net_nfc_util_ipc_recv(fd, buffer, 0) <= 0)
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void _bench_socket(const gchar *name, guint window)
+{
+	net_nfc_bench_result_s result;
+	uint8_t *buffer;
+	guint i;
+	int fd;
+
+	fd = net_nfc_util_ipc_connect();
+	if (fd < 0)
+	{
+		_bench_skip(name, "no daemon on " NET_NFC_IPC_SOCKET_PATH);
+		return;
+	}
+
+	buffer = g_malloc(sizeof(net_nfc_ipc_header_s) + NET_NFC_IPC_PAYLOAD_MAX);
+
+	net_nfc_bench_start(&result, BENCH_IPC_ITERATIONS);
+
+	for (i = 0; i < BENCH_IPC_ITERATIONS; i += window)
+	{
+		if (_bench_socket_call(fd, buffer,
+					MIN(window, BENCH_IPC_ITERATIONS - i)) == FALSE)
+		{
+			_bench_skip(name, "the daemon closed the socket");
+			break;
+		}
+	}
+
+	net_nfc_bench_stop(&result);
+
+	if (i >= BENCH_IPC_ITERATIONS)
+		net_nfc_bench_print(name, &result);
+
+	g_free(buffer);
+	close(fd);
+}
+
+void net_nfc_bench_ipc_socket(gpointer data, gpointer user_data)
+{
+	_bench_socket("Ipc.Socket", 1);
+}
+
+void net_nfc_bench_ipc_socket_pipelined(gpointer data, gpointer user_data)
+{
+	_bench_socket("Ipc.SocketPipelined", BENCH_IPC_WINDOW);
+}
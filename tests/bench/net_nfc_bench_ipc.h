@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2012-2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 				 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _NET_NFC_BENCH_IPC_H_
+#define _NET_NFC_BENCH_IPC_H_
+
+#include <glib.h>
+
+
+void net_nfc_bench_ipc_dbus(gpointer data, gpointer user_data);
+
+void net_nfc_bench_ipc_socket(gpointer data, gpointer user_data);
+
+void net_nfc_bench_ipc_socket_pipelined(gpointer data, gpointer user_data);
+
+
+#endif
@@ -0,0 +1,492 @@
+/*
+ * Copyright (c) 2012-2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 				 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "net_nfc_typedef_internal.h"
+#include "net_nfc_util_internal.h"
+#include "net_nfc_util_ndef_message.h"
+#include "net_nfc_util_ndef_record.h"
+#include "net_nfc_util_handover.h"
+
+#include "net_nfc_bench_util.h"
+#include "net_nfc_bench_ndef.h"
+
+/* roughly the shape of a handover select message */
+#define BENCH_NDEF_RECORD_COUNT	4
+
+#define BENCH_NDEF_LARGE_RECORD_COUNT	1000
+#define BENCH_NDEF_LARGE_ITERATIONS	100
+
+/* default LLCP MIU */
+#define BENCH_NDEF_FRAGMENT_SIZE	128
+
+static uint8_t bench_payload[64];
+
+static void __build_message(ndef_message_s *msg)
+{
+	data_s type = { (uint8_t *)"application/vnd.bluetooth.ep.oob", 32 };
+	data_s id = { (uint8_t *)"0", 1 };
+	data_s payload = { bench_payload, sizeof(bench_payload) };
+	ndef_record_s *record;
+	int i;
+
+	for (i = 0; i < BENCH_NDEF_RECORD_COUNT; i++)
+	{
+		record = NULL;
+
+		net_nfc_util_create_record_with_arena(msg->arena,
+				NET_NFC_RECORD_MIME_TYPE, &type, &id, &payload, &record);
+		net_nfc_util_append_record(msg, record);
+	}
+}
+
+static void __make_rawdata(data_s *rawdata)
+{
+	ndef_message_s *msg = NULL;
+
+	net_nfc_util_create_ndef_message(&msg);
+	__build_message(msg);
+
+	net_nfc_util_alloc_data(rawdata, net_nfc_util_get_ndef_message_length(msg));
+	net_nfc_util_convert_ndef_message_to_rawdata(msg, rawdata);
+
+	net_nfc_util_free_ndef_message(msg);
+}
+
+void net_nfc_bench_ndef_build(gpointer data, gpointer user_data)
+{
+	net_nfc_bench_result_s result;
+	ndef_message_s *msg;
+	guint i;
+
+	net_nfc_bench_start(&result, NET_NFC_BENCH_ITERATIONS);
+
+	for (i = 0; i < NET_NFC_BENCH_ITERATIONS; i++)
+	{
+		msg = NULL;
+
+		net_nfc_util_create_ndef_message(&msg);
+		__build_message(msg);
+		net_nfc_util_free_ndef_message(msg);
+	}
+
+	net_nfc_bench_stop(&result);
+	net_nfc_bench_print("Ndef.Build", &result);
+}
+
+void net_nfc_bench_ndef_build_arena(gpointer data, gpointer user_data)
+{
+	net_nfc_bench_result_s result;
+	ndef_message_s *msg;
+	guint i;
+
+	net_nfc_bench_start(&result, NET_NFC_BENCH_ITERATIONS);
+
+	for (i = 0; i < NET_NFC_BENCH_ITERATIONS; i++)
+	{
+		msg = NULL;
+
+		net_nfc_util_create_ndef_message_with_arena(&msg,
+				NET_NFC_UTIL_ARENA_DEFAULT_SIZE);
+		__build_message(msg);
+		net_nfc_util_free_ndef_message(msg);
+	}
+
+	net_nfc_bench_stop(&result);
+	net_nfc_bench_print("Ndef.BuildArena", &result);
+}
+
+void net_nfc_bench_ndef_parse(gpointer data, gpointer user_data)
+{
+	net_nfc_bench_result_s result;
+	data_s rawdata = { NULL, 0 };
+	ndef_message_s *msg;
+	guint i;
+
+	__make_rawdata(&rawdata);
+
+	net_nfc_bench_start(&result, NET_NFC_BENCH_ITERATIONS);
+
+	for (i = 0; i < NET_NFC_BENCH_ITERATIONS; i++)
+	{
+		msg = NULL;
+
+		net_nfc_util_create_ndef_message(&msg);
+		net_nfc_util_convert_rawdata_to_ndef_message(&rawdata, msg);
+		net_nfc_util_free_ndef_message(msg);
+	}
+
+	net_nfc_bench_stop(&result);
+	net_nfc_bench_print("Ndef.Parse", &result);
+
+	net_nfc_util_free_data(&rawdata);
+}
+
+void net_nfc_bench_ndef_parse_pooled(gpointer data, gpointer user_data)
+{
+	net_nfc_bench_result_s result;
+	net_nfc_util_ndef_pool_stats_s stats;
+	data_s rawdata = { NULL, 0 };
+	ndef_message_s *msg;
+	guint i;
+
+	__make_rawdata(&rawdata);
+
+	net_nfc_bench_start(&result, NET_NFC_BENCH_ITERATIONS);
+
+	for (i = 0; i < NET_NFC_BENCH_ITERATIONS; i++)
+	{
+		msg = NULL;
+
+		net_nfc_util_create_pooled_ndef_message(&msg);
+		net_nfc_util_convert_rawdata_to_ndef_message(&rawdata, msg);
+		net_nfc_util_free_ndef_message(msg);
+	}
+
+	net_nfc_bench_stop(&result);
+	net_nfc_bench_print("Ndef.ParsePooled", &result);
+
+	net_nfc_util_get_ndef_pool_stats(&stats);
+	g_print("%-32s %u hits %u misses %u high water\n", "",
+			stats.hits, stats.misses, stats.high_water);
+
+	net_nfc_util_free_data(&rawdata);
+}
+
+void net_nfc_bench_ndef_parse_arena(gpointer data, gpointer user_data)
+{
+	net_nfc_bench_result_s result;
+	data_s rawdata = { NULL, 0 };
+	ndef_message_s *msg;
+	guint i;
+
+	__make_rawdata(&rawdata);
+
+	net_nfc_bench_start(&result, NET_NFC_BENCH_ITERATIONS);
+
+	for (i = 0; i < NET_NFC_BENCH_ITERATIONS; i++)
+	{
+		msg = NULL;
+
+		net_nfc_util_create_ndef_message_with_arena(&msg,
+				rawdata.length * 4);
+		net_nfc_util_convert_rawdata_to_ndef_message(&rawdata, msg);
+		net_nfc_util_free_ndef_message(msg);
+	}
+
+	net_nfc_bench_stop(&result);
+	net_nfc_bench_print("Ndef.ParseArena", &result);
+
+	net_nfc_util_free_data(&rawdata);
+}
+
+void net_nfc_bench_ndef_handover_request(gpointer data, gpointer user_data)
+{
+	net_nfc_bench_result_s result;
+	ndef_message_s *msg;
+	guint i;
+
+	net_nfc_bench_start(&result, NET_NFC_BENCH_ITERATIONS);
+
+	for (i = 0; i < NET_NFC_BENCH_ITERATIONS; i++)
+	{
+		msg = NULL;
+
+		net_nfc_util_create_handover_request_message(&msg);
+		net_nfc_util_free_ndef_message(msg);
+	}
+
+	net_nfc_bench_stop(&result);
+	net_nfc_bench_print("Ndef.HandoverRequest", &result);
+}
+
+void net_nfc_bench_ndef_handover_request_arena(gpointer data, gpointer user_data)
+{
+	net_nfc_bench_result_s result;
+	ndef_message_s *msg;
+	guint i;
+
+	net_nfc_bench_start(&result, NET_NFC_BENCH_ITERATIONS);
+
+	for (i = 0; i < NET_NFC_BENCH_ITERATIONS; i++)
+	{
+		msg = NULL;
+
+		net_nfc_util_create_handover_request_message_with_arena(&msg);
+		net_nfc_util_free_ndef_message(msg);
+	}
+
+	net_nfc_bench_stop(&result);
+	net_nfc_bench_print("Ndef.HandoverRequestArena", &result);
+}
+
+static void __build_large_message(ndef_message_s *msg)
+{
+	data_s type = { (uint8_t *)"T", 1 };
+	data_s payload = { bench_payload, 8 };
+	ndef_record_s *record;
+	int i;
+
+	for (i = 0; i < BENCH_NDEF_LARGE_RECORD_COUNT; i++)
+	{
+		record = NULL;
+
+		net_nfc_util_create_record_with_arena(msg->arena,
+				NET_NFC_RECORD_WELL_KNOWN_TYPE, &type, NULL, &payload, &record);
+		net_nfc_util_append_record(msg, record);
+	}
+}
+
+void net_nfc_bench_ndef_append_1k(gpointer data, gpointer user_data)
+{
+	net_nfc_bench_result_s result;
+	ndef_message_s *msg;
+	guint i;
+
+	net_nfc_bench_start(&result, BENCH_NDEF_LARGE_ITERATIONS);
+
+	for (i = 0; i < BENCH_NDEF_LARGE_ITERATIONS; i++)
+	{
+		msg = NULL;
+
+		net_nfc_util_create_ndef_message(&msg);
+		__build_large_message(msg);
+		net_nfc_util_free_ndef_message(msg);
+	}
+
+	net_nfc_bench_stop(&result);
+	net_nfc_bench_print("Ndef.Append1k", &result);
+}
+
+void net_nfc_bench_ndef_get_by_index_1k(gpointer data, gpointer user_data)
+{
+	net_nfc_bench_result_s result;
+	ndef_message_s *msg = NULL;
+	ndef_record_s *record;
+	guint i;
+	int idx;
+
+	net_nfc_util_create_ndef_message(&msg);
+	__build_large_message(msg);
+
+	net_nfc_bench_start(&result, BENCH_NDEF_LARGE_ITERATIONS);
+
+	for (i = 0; i < BENCH_NDEF_LARGE_ITERATIONS; i++)
+	{
+		for (idx = 0; idx < msg->recordCount; idx++)
+			net_nfc_util_get_record_by_index(msg, idx, &record);
+	}
+
+	net_nfc_bench_stop(&result);
+	net_nfc_bench_print("Ndef.GetByIndex1k", &result);
+
+	net_nfc_util_free_ndef_message(msg);
+}
+
+void net_nfc_bench_ndef_insert_remove_1k(gpointer data, gpointer user_data)
+{
+	net_nfc_bench_result_s result;
+	ndef_message_s *msg = NULL;
+	ndef_record_s *record;
+	data_s type = { (uint8_t *)"T", 1 };
+	data_s payload = { bench_payload, 8 };
+	guint i;
+
+	net_nfc_util_create_ndef_message(&msg);
+	__build_large_message(msg);
+
+	net_nfc_bench_start(&result, BENCH_NDEF_LARGE_ITERATIONS);
+
+	for (i = 0; i < BENCH_NDEF_LARGE_ITERATIONS; i++)
+	{
+		record = NULL;
+
+		net_nfc_util_create_record(NET_NFC_RECORD_WELL_KNOWN_TYPE, &type,
+				NULL, &payload, &record);
+		net_nfc_util_append_record_by_index(msg, msg->recordCount / 2, record);
+		net_nfc_util_remove_record_by_index(msg, msg->recordCount / 2);
+	}
+
+	net_nfc_bench_stop(&result);
+	net_nfc_bench_print("Ndef.InsertRemove1k", &result);
+
+	net_nfc_util_free_ndef_message(msg);
+}
+
+void net_nfc_bench_ndef_search_by_id_1k(gpointer data, gpointer user_data)
+{
+	net_nfc_bench_result_s result;
+	ndef_message_s *msg = NULL;
+	ndef_record_s *record;
+	data_s type = { (uint8_t *)"T", 1 };
+	data_s payload = { bench_payload, 8 };
+	data_s id;
+	uint32_t ids[BENCH_NDEF_LARGE_RECORD_COUNT];
+	guint i;
+	int idx;
+
+	net_nfc_util_create_ndef_message(&msg);
+
+	for (idx = 0; idx < BENCH_NDEF_LARGE_RECORD_COUNT; idx++)
+	{
+		record = NULL;
+		ids[idx] = idx;
+		id.buffer = (uint8_t *)&ids[idx];
+		id.length = sizeof(ids[idx]);
+
+		net_nfc_util_create_record_with_arena(msg->arena,
+				NET_NFC_RECORD_WELL_KNOWN_TYPE, &type, &id, &payload, &record);
+		net_nfc_util_append_record(msg, record);
+	}
+
+	net_nfc_bench_start(&result, BENCH_NDEF_LARGE_ITERATIONS);
+
+	for (i = 0; i < BENCH_NDEF_LARGE_ITERATIONS; i++)
+	{
+		for (idx = 0; idx < BENCH_NDEF_LARGE_RECORD_COUNT; idx++)
+		{
+			id.buffer = (uint8_t *)&ids[idx];
+			id.length = sizeof(ids[idx]);
+
+			net_nfc_util_search_record_by_id(msg, &id, &record);
+		}
+	}
+
+	net_nfc_bench_stop(&result);
+	net_nfc_bench_print("Ndef.SearchById1k", &result);
+
+	net_nfc_util_free_ndef_message(msg);
+}
+
+void net_nfc_bench_ndef_parse_throughput(gpointer data, gpointer user_data)
+{
+	net_nfc_bench_result_s result;
+	ndef_message_s *msg = NULL;
+	ndef_message_s view;
+	data_s rawdata = { NULL, 0 };
+	guint i;
+
+	net_nfc_util_create_ndef_message(&msg);
+	__build_large_message(msg);
+	net_nfc_util_serialize_ndef_message(msg, 0, &rawdata);
+	net_nfc_util_free_ndef_message(msg);
+
+	net_nfc_bench_start(&result, BENCH_NDEF_LARGE_ITERATIONS);
+
+	for (i = 0; i < BENCH_NDEF_LARGE_ITERATIONS; i++)
+	{
+		memset(&view, 0, sizeof(view));
+
+		net_nfc_util_convert_rawdata_to_ndef_message_view(&rawdata, &view,
+				NULL, 0);
+		net_nfc_util_release_ndef_message_view(&view);
+	}
+
+	net_nfc_bench_stop(&result);
+	net_nfc_bench_print_throughput("Ndef.ParseThroughput", &result,
+			BENCH_NDEF_LARGE_RECORD_COUNT, rawdata.length);
+
+	net_nfc_util_free_data(&rawdata);
+}
+
+void net_nfc_bench_ndef_serialize(gpointer data, gpointer user_data)
+{
+	net_nfc_bench_result_s result;
+	ndef_message_s *msg = NULL;
+	data_s rawdata;
+	guint i;
+
+	net_nfc_util_create_ndef_message(&msg);
+	__build_message(msg);
+
+	net_nfc_bench_start(&result, NET_NFC_BENCH_ITERATIONS);
+
+	for (i = 0; i < NET_NFC_BENCH_ITERATIONS; i++)
+	{
+		net_nfc_util_serialize_ndef_message(msg, 0, &rawdata);
+		net_nfc_util_free_data(&rawdata);
+	}
+
+	net_nfc_bench_stop(&result);
+	net_nfc_bench_print("Ndef.Serialize", &result);
+
+	net_nfc_util_free_ndef_message(msg);
+}
+
+void net_nfc_bench_ndef_serialize_iovec(gpointer data, gpointer user_data)
+{
+	net_nfc_bench_result_s result;
+	ndef_message_s *msg = NULL;
+	struct iovec iov[BENCH_NDEF_RECORD_COUNT * 2];
+	uint32_t iov_count;
+	data_s headers;
+	guint i;
+
+	net_nfc_util_create_ndef_message(&msg);
+	__build_message(msg);
+
+	net_nfc_bench_start(&result, NET_NFC_BENCH_ITERATIONS);
+
+	for (i = 0; i < NET_NFC_BENCH_ITERATIONS; i++)
+	{
+		iov_count = G_N_ELEMENTS(iov);
+
+		net_nfc_util_convert_ndef_message_to_iovec(msg, &headers, iov, &iov_count);
+		net_nfc_util_free_data(&headers);
+	}
+
+	net_nfc_bench_stop(&result);
+	net_nfc_bench_print("Ndef.SerializeIovec", &result);
+
+	net_nfc_util_free_ndef_message(msg);
+}
+
+static void __stream_record_cb(ndef_record_s *record, void *user_data)
+{
+	net_nfc_util_free_record(record);
+}
+
+void net_nfc_bench_ndef_stream_parse(gpointer data, gpointer user_data)
+{
+	net_nfc_bench_result_s result;
+	net_nfc_util_ndef_parser_s *parser;
+	data_s rawdata = { NULL, 0 };
+	uint32_t offset;
+	guint i;
+
+	__make_rawdata(&rawdata);
+
+	net_nfc_bench_start(&result, NET_NFC_BENCH_ITERATIONS);
+
+	for (i = 0; i < NET_NFC_BENCH_ITERATIONS; i++)
+	{
+		parser = net_nfc_util_ndef_parser_create(__stream_record_cb, NULL);
+
+		for (offset = 0; offset < rawdata.length; offset += BENCH_NDEF_FRAGMENT_SIZE)
+		{
+			net_nfc_util_ndef_parser_feed(parser, rawdata.buffer + offset,
+					MIN(BENCH_NDEF_FRAGMENT_SIZE, rawdata.length - offset));
+		}
+
+		net_nfc_util_ndef_parser_destroy(parser);
+	}
+
+	net_nfc_bench_stop(&result);
+	net_nfc_bench_print("Ndef.StreamParse", &result);
+
+	net_nfc_util_free_data(&rawdata);
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2012-2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 				 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _NET_NFC_BENCH_NDEF_H_
+#define _NET_NFC_BENCH_NDEF_H_
+
+#include <glib.h>
+
+
+void net_nfc_bench_ndef_build(gpointer data, gpointer user_data);
+
+void net_nfc_bench_ndef_build_arena(gpointer data, gpointer user_data);
+
+void net_nfc_bench_ndef_parse(gpointer data, gpointer user_data);
+
+void net_nfc_bench_ndef_parse_arena(gpointer data, gpointer user_data);
+
+void net_nfc_bench_ndef_parse_pooled(gpointer data, gpointer user_data);
+
+void net_nfc_bench_ndef_handover_request(gpointer data, gpointer user_data);
+
+void net_nfc_bench_ndef_handover_request_arena(gpointer data,
+		gpointer user_data);
+
+void net_nfc_bench_ndef_append_1k(gpointer data, gpointer user_data);
+
+void net_nfc_bench_ndef_get_by_index_1k(gpointer data, gpointer user_data);
+
+void net_nfc_bench_ndef_insert_remove_1k(gpointer data, gpointer user_data);
+
+void net_nfc_bench_ndef_search_by_id_1k(gpointer data, gpointer user_data);
+
+void net_nfc_bench_ndef_parse_throughput(gpointer data, gpointer user_data);
+
+void net_nfc_bench_ndef_serialize(gpointer data, gpointer user_data);
+
+void net_nfc_bench_ndef_serialize_iovec(gpointer data, gpointer user_data);
+
+void net_nfc_bench_ndef_stream_parse(gpointer data, gpointer user_data);
+
+
+#endif
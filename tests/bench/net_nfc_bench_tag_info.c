@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2012-2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 				 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "net_nfc_typedef_internal.h"
+#include "net_nfc_util_internal.h"
+
+#include "net_nfc_bench_util.h"
+#include "net_nfc_bench_tag_info.h"
+
+/* target info of an ISO14443-A tag as a plugin reports it */
+static const uint8_t bench_legacy[] =
+{
+	3, 'U', 'I', 'D', 7, 0x04, 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC,
+	4, 'A', 'T', 'Q', 'A', 2, 0x44, 0x00,
+	3, 'S', 'A', 'K', 1, 0x00,
+	8, 'A', 'P', 'P', '_', 'D', 'A', 'T', 'A', 0,
+	10, 'H', 'I', 'S', 'T', '_', 'B', 'Y', 'T', 'E', 'S', 4, 0x80, 0x73, 0xC0, 0x21,
+	8, 'F', 'W', 'I', '_', 'S', 'F', 'G', 'T', 1, 0x77,
+};
+
+#define BENCH_LEGACY_KEYS	6
+
+void net_nfc_bench_tag_info_decode(gpointer data, gpointer user_data)
+{
+	net_nfc_bench_result_s result;
+	data_s legacy = { (uint8_t *)bench_legacy, sizeof(bench_legacy) };
+	uint8_t buffer[NET_NFC_TAG_INFO_ENCODED_MAX(sizeof(bench_legacy),
+			BENCH_LEGACY_KEYS)];
+	net_nfc_tag_info_s *list;
+	uint32_t length;
+	int number_of_keys;
+	guint i;
+
+	length = net_nfc_util_encode_tag_info(&legacy, BENCH_LEGACY_KEYS, buffer,
+			sizeof(buffer));
+
+	net_nfc_bench_start(&result, NET_NFC_BENCH_ITERATIONS);
+
+	for (i = 0; i < NET_NFC_BENCH_ITERATIONS; i++)
+	{
+		list = net_nfc_util_decode_tag_info(buffer, length, &number_of_keys);
+
+		net_nfc_util_find_tag_info(list, number_of_keys, "UID");
+		net_nfc_util_find_tag_info(list, number_of_keys, "SAK");
+
+		net_nfc_util_free_tag_info(list);
+	}
+
+	net_nfc_bench_stop(&result);
+	net_nfc_bench_print("TagInfo.Decode", &result);
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2012-2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 				 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "net_nfc_typedef_internal.h"
+#include "net_nfc_util_ndef_record.h"
+
+#include "net_nfc_bench_util.h"
+#include "net_nfc_bench_uri.h"
+
+#define BENCH_URI_LENGTH_MAX	64
+
+/* a mix of long, short and missing prefixes */
+static const char *bench_uris[] =
+{
+	"http://www.tizen.org",
+	"https://www.tizen.org/about",
+	"http://tizen.org",
+	"tel:+821012345678",
+	"mailto:someone@tizen.org",
+	"urn:epc:id:sgtin:0614141.107346.2017",
+	"urn:nfc:wkt:U",
+	"btspp://0012345678AB",
+	"market://details?id=org.tizen",
+	"ftp://ftp.tizen.org/pub",
+};
+
+void net_nfc_bench_uri_encode(gpointer data, gpointer user_data)
+{
+	net_nfc_bench_result_s result;
+	ndef_record_s *record;
+	guint i;
+	gint j;
+
+	net_nfc_bench_start(&result, NET_NFC_BENCH_ITERATIONS);
+
+	for (i = 0; i < NET_NFC_BENCH_ITERATIONS; i++)
+	{
+		for (j = 0; j < G_N_ELEMENTS(bench_uris); j++)
+		{
+			record = NULL;
+
+			net_nfc_util_create_uri_type_record(bench_uris[j],
+					NET_NFC_SCHEMA_FULL_URI, &record);
+			net_nfc_util_free_record(record);
+		}
+	}
+
+	net_nfc_bench_stop(&result);
+	net_nfc_bench_print("Uri.Encode", &result);
+}
+
+void net_nfc_bench_uri_decode(gpointer data, gpointer user_data)
+{
+	net_nfc_bench_result_s result;
+	ndef_record_s *records[G_N_ELEMENTS(bench_uris)];
+	char buffer[BENCH_URI_LENGTH_MAX];
+	uint32_t length;
+	guint i;
+	gint j;
+
+	for (j = 0; j < G_N_ELEMENTS(bench_uris); j++)
+	{
+		records[j] = NULL;
+
+		net_nfc_util_create_uri_type_record(bench_uris[j],
+				NET_NFC_SCHEMA_FULL_URI, &records[j]);
+	}
+
+	net_nfc_bench_start(&result, NET_NFC_BENCH_ITERATIONS);
+
+	for (i = 0; i < NET_NFC_BENCH_ITERATIONS; i++)
+	{
+		for (j = 0; j < G_N_ELEMENTS(bench_uris); j++)
+		{
+			length = sizeof(buffer);
+
+			net_nfc_util_get_uri_string_from_uri_record(records[j], buffer,
+					&length);
+		}
+	}
+
+	net_nfc_bench_stop(&result);
+	net_nfc_bench_print("Uri.Decode", &result);
+
+	for (j = 0; j < G_N_ELEMENTS(bench_uris); j++)
+		net_nfc_util_free_record(records[j]);
+}
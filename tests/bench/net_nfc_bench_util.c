@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2012-2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 				 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "net_nfc_bench_util.h"
+
+/* the bench is linked with --wrap for these, so every allocation made by
+   nfc-common goes through the counters below */
+gpointer __real_g_malloc(gsize n_bytes);
+gpointer __real_g_malloc0(gsize n_bytes);
+gpointer __real_g_realloc(gpointer mem, gsize n_bytes);
+void __real_g_free(gpointer mem);
+
+static guint64 alloc_count;
+static guint64 free_count;
+
+gpointer __wrap_g_malloc(gsize n_bytes)
+{
+	alloc_count++;
+
+	return __real_g_malloc(n_bytes);
+}
+
+gpointer __wrap_g_malloc0(gsize n_bytes)
+{
+	alloc_count++;
+
+	return __real_g_malloc0(n_bytes);
+}
+
+gpointer __wrap_g_realloc(gpointer mem, gsize n_bytes)
+{
+	if (NULL == mem)
+		alloc_count++;
+
+	return __real_g_realloc(mem, n_bytes);
+}
+
+void __wrap_g_free(gpointer mem)
+{
+	if (mem != NULL)
+		free_count++;
+
+	__real_g_free(mem);
+}
+
+void net_nfc_bench_start(net_nfc_bench_result_s *result, guint iterations)
+{
+	result->iterations = iterations;
+	result->allocs = alloc_count;
+	result->frees = free_count;
+	result->elapsed = g_get_monotonic_time();
+}
+
+void net_nfc_bench_stop(net_nfc_bench_result_s *result)
+{
+	result->elapsed = g_get_monotonic_time() - result->elapsed;
+	result->allocs = alloc_count - result->allocs;
+	result->frees = free_count - result->frees;
+}
+
+void net_nfc_bench_print(const gchar *name, net_nfc_bench_result_s *result)
+{
+	guint iterations = MAX(result->iterations, 1);
+
+	g_print("%-32s %8u iter %10.1f ns/iter %8.2f allocs/iter %8.2f frees/iter\n",
+			name, result->iterations,
+			(gdouble)result->elapsed * 1000 / iterations,
+			(gdouble)result->allocs / iterations,
+			(gdouble)result->frees / iterations);
+}
+
+void net_nfc_bench_print_throughput(const gchar *name,
+		net_nfc_bench_result_s *result, guint64 records, guint64 bytes)
+{
+	gdouble seconds = (gdouble)MAX(result->elapsed, 1) / G_USEC_PER_SEC;
+
+	g_print("%-32s %8u iter %12.0f records/s %10.1f MB/s\n",
+			name, result->iterations,
+			(gdouble)records * result->iterations / seconds,
+			(gdouble)bytes * result->iterations / seconds / (1024 * 1024));
+}
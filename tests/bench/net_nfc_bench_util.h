@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2012-2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 				 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _NET_NFC_BENCH_UTIL_H_
+#define _NET_NFC_BENCH_UTIL_H_
+
+#include <glib.h>
+
+#define NET_NFC_BENCH_ITERATIONS	10000
+
+typedef struct _net_nfc_bench_result_s
+{
+	guint iterations;
+	gint64 elapsed; /* usec */
+	guint64 allocs;
+	guint64 frees;
+} net_nfc_bench_result_s;
+
+void net_nfc_bench_start(net_nfc_bench_result_s *result, guint iterations);
+
+void net_nfc_bench_stop(net_nfc_bench_result_s *result);
+
+void net_nfc_bench_print(const gchar *name, net_nfc_bench_result_s *result);
+
+/* records and bytes are processed once per iteration */
+void net_nfc_bench_print_throughput(const gchar *name,
+		net_nfc_bench_result_s *result, guint64 records, guint64 bytes);
+
+
+#endif
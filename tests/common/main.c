@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2012-2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 				 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+#include <glib.h>
+
+#include "net_nfc_common_test_record.h"
+#include "net_nfc_common_test_parser.h"
+
+
+typedef struct _CommonTestData CommonTestData;
+
+struct _CommonTestData
+{
+	gchar *name;
+	gboolean (*func)(void);
+	gchar *comment;
+};
+
+static CommonTestData test_data[] = {
+	{
+		"Record.SearchUnshared",
+		net_nfc_common_test_record_search_unshared,
+		"Search a record by type after unsharing it"
+	},
+
+	{
+		"Parser.SplitHeader",
+		net_nfc_common_test_parser_split_header,
+		"Stream parse two records fed in fragments of every size"
+	},
+
+	{
+		"Parser.Chunked",
+		net_nfc_common_test_parser_chunked,
+		"Reassemble a record sent as MB/CF, CF and ME chunks"
+	},
+
+	{
+		"Parser.InvalidSequence",
+		net_nfc_common_test_parser_invalid_sequence,
+		"Reject broken MB, ME, CF and TNF sequences"
+	},
+
+	{ NULL }
+};
+
+/* returns the number of failed tests, or -1 if name is unknown */
+static gint run_test(const gchar *name)
+{
+	gint i;
+	gint failed = 0;
+	gboolean found = FALSE;
+
+	for (i = 0; i < G_N_ELEMENTS(test_data) - 1; i++)
+	{
+		if (name != NULL && strcmp(test_data[i].name, name) != 0)
+			continue;
+
+		found = TRUE;
+
+		if (test_data[i].func() == TRUE)
+		{
+			g_print("PASS: %s\n", test_data[i].name);
+		}
+		else
+		{
+			g_print("FAIL: %s\n", test_data[i].name);
+			failed++;
+		}
+	}
+
+	return (found == TRUE) ? failed : -1;
+}
+
+int main(int argc, char *argv[])
+{
+	gint i;
+	gint failed = 0;
+	gint result;
+
+	if (argc == 2 && strcmp(argv[1], "--help") == 0)
+	{
+		g_print("nfc-common-test: nfc-common-test [name]...\n");
+		g_print("\n");
+
+		for (i = 0; i < G_N_ELEMENTS(test_data) - 1; i++)
+		{
+			g_print("\t%s : %s\n", test_data[i].name,
+					test_data[i].comment);
+		}
+		return 0;
+	}
+
+	if (argc == 1)
+		return (run_test(NULL) == 0) ? 0 : 1;
+
+	for (i = 1; i < argc; i++)
+	{
+		result = run_test(argv[i]);
+		if (result < 0)
+		{
+			g_printerr("unknown test [%s]\n", argv[i]);
+			return 1;
+		}
+
+		failed += result;
+	}
+
+	return (failed == 0) ? 0 : 1;
+}
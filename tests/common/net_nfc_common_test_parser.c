@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2012-2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 				 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "net_nfc_typedef_internal.h"
+#include "net_nfc_util_internal.h"
+#include "net_nfc_util_ndef_message.h"
+#include "net_nfc_util_ndef_record.h"
+
+#include "net_nfc_common_test_util.h"
+#include "net_nfc_common_test_parser.h"
+
+/* two short well known records, "T" with "abc" and "U" with "\x01x" */
+static uint8_t two_records[] = {
+	0x91, 0x01, 0x03, 'T', 'a', 'b', 'c',
+	0x51, 0x01, 0x02, 'U', 0x01, 'x',
+};
+
+/* one "T" record sent as three chunks, "ab" + "cd" + "e" */
+static uint8_t chunked_record[] = {
+	0xB1, 0x01, 0x02, 'T', 'a', 'b',
+	0x36, 0x00, 0x02, 'c', 'd',
+	0x56, 0x00, 0x01, 'e',
+};
+
+typedef struct _test_sequence_s
+{
+	const gchar *name;
+	uint8_t data[16];
+	uint32_t length;
+} test_sequence_s;
+
+static test_sequence_s invalid_sequences[] = {
+	{ "no MB", { 0x51, 0x01, 0x00, 'T' }, 4 },
+	{ "unchanged tnf outside a chunk", { 0xD6, 0x00, 0x00 }, 3 },
+	{ "CF with ME", { 0xF1, 0x01, 0x00, 'T' }, 4 },
+	{ "type in a following chunk",
+		{ 0xB1, 0x01, 0x00, 'T', 0x51, 0x01, 0x00, 'U' }, 8 },
+	{ "id in a following chunk",
+		{ 0xB1, 0x01, 0x00, 'T', 0x5E, 0x00, 0x00, 0x01, '0' }, 9 },
+	{ "record after ME",
+		{ 0xD1, 0x01, 0x00, 'T', 0x51, 0x01, 0x00, 'U' }, 8 },
+};
+
+static void _collect_record_cb(ndef_record_s *record, void *user_data)
+{
+	ndef_message_s *msg = user_data;
+
+	if (net_nfc_util_append_record(msg, record) != NET_NFC_OK)
+		net_nfc_util_free_record(record);
+}
+
+static gboolean _check_record(ndef_record_s *record, uint8_t tnf,
+		const char *type, const char *payload, uint32_t payload_length)
+{
+	TEST_CHECK(record != NULL);
+	TEST_CHECK(record->TNF == tnf);
+	TEST_CHECK(record->type_s.length == strlen(type));
+	TEST_CHECK(memcmp(record->type_s.buffer, type, strlen(type)) == 0);
+	TEST_CHECK(record->payload_s.length == payload_length);
+	TEST_CHECK(memcmp(record->payload_s.buffer, payload, payload_length) == 0);
+
+	return TRUE;
+}
+
+/* feed data in fragments of fragment_size bytes */
+static net_nfc_error_e _stream_parse(const uint8_t *data, uint32_t length,
+		uint32_t fragment_size, ndef_message_s *msg, bool *complete)
+{
+	net_nfc_util_ndef_parser_s *parser;
+	net_nfc_error_e result = NET_NFC_OK;
+	uint32_t offset;
+	uint32_t size;
+
+	parser = net_nfc_util_ndef_parser_create(_collect_record_cb, msg);
+	if (NULL == parser)
+		return NET_NFC_ALLOC_FAIL;
+
+	for (offset = 0; offset < length && result == NET_NFC_OK; offset += size)
+	{
+		size = MIN(fragment_size, length - offset);
+
+		result = net_nfc_util_ndef_parser_feed(parser, data + offset, size);
+	}
+
+	*complete = net_nfc_util_ndef_parser_is_complete(parser);
+
+	net_nfc_util_ndef_parser_destroy(parser);
+
+	return result;
+}
+
+/* every fragment size splits the headers somewhere else */
+gboolean net_nfc_common_test_parser_split_header(void)
+{
+	ndef_message_s *msg;
+	uint32_t fragment_size;
+	bool complete;
+
+	for (fragment_size = 1; fragment_size <= sizeof(two_records); fragment_size++)
+	{
+		msg = NULL;
+
+		TEST_CHECK(net_nfc_util_create_ndef_message(&msg) == NET_NFC_OK);
+		TEST_CHECK(_stream_parse(two_records, sizeof(two_records),
+					fragment_size, msg, &complete) == NET_NFC_OK);
+		TEST_CHECK(complete == true);
+		TEST_CHECK(msg->recordCount == 2);
+		TEST_CHECK(_check_record(msg->records, NET_NFC_RECORD_WELL_KNOWN_TYPE,
+					"T", "abc", 3));
+		TEST_CHECK(_check_record(msg->records->next,
+					NET_NFC_RECORD_WELL_KNOWN_TYPE, "U", "\x01x", 2));
+
+		net_nfc_util_free_ndef_message(msg);
+	}
+
+	return TRUE;
+}
+
+/* MB/CF, CF and ME chunks make one record, both parsers agree */
+gboolean net_nfc_common_test_parser_chunked(void)
+{
+	data_s rawdata = { chunked_record, sizeof(chunked_record) };
+	ndef_message_s *msg = NULL;
+	uint32_t fragment_size;
+	bool complete;
+
+	TEST_CHECK(net_nfc_util_create_ndef_message(&msg) == NET_NFC_OK);
+	TEST_CHECK(net_nfc_util_convert_rawdata_to_ndef_message(&rawdata,
+				msg) == NET_NFC_OK);
+	TEST_CHECK(msg->recordCount == 1);
+	TEST_CHECK(_check_record(msg->records, NET_NFC_RECORD_WELL_KNOWN_TYPE,
+				"T", "abcde", 5));
+	TEST_CHECK(msg->records->CF == 0);
+
+	net_nfc_util_free_ndef_message(msg);
+
+	for (fragment_size = 1; fragment_size <= sizeof(chunked_record); fragment_size++)
+	{
+		msg = NULL;
+
+		TEST_CHECK(net_nfc_util_create_ndef_message(&msg) == NET_NFC_OK);
+		TEST_CHECK(_stream_parse(chunked_record, sizeof(chunked_record),
+					fragment_size, msg, &complete) == NET_NFC_OK);
+		TEST_CHECK(complete == true);
+		TEST_CHECK(msg->recordCount == 1);
+		TEST_CHECK(_check_record(msg->records, NET_NFC_RECORD_WELL_KNOWN_TYPE,
+					"T", "abcde", 5));
+
+		net_nfc_util_free_ndef_message(msg);
+	}
+
+	/* a chunked record without its last chunk is not a message */
+	msg = NULL;
+
+	TEST_CHECK(net_nfc_util_create_ndef_message(&msg) == NET_NFC_OK);
+	TEST_CHECK(_stream_parse(chunked_record, sizeof(chunked_record) - 4,
+				1, msg, &complete) == NET_NFC_OK);
+	TEST_CHECK(complete == false);
+	TEST_CHECK(msg->recordCount == 0);
+
+	net_nfc_util_free_ndef_message(msg);
+
+	rawdata.length = sizeof(chunked_record) - 4;
+	msg = NULL;
+
+	TEST_CHECK(net_nfc_util_create_ndef_message(&msg) == NET_NFC_OK);
+	TEST_CHECK(net_nfc_util_convert_rawdata_to_ndef_message(&rawdata,
+				msg) != NET_NFC_OK);
+
+	net_nfc_util_free_ndef_message(msg);
+
+	return TRUE;
+}
+
+static gboolean _check_invalid_sequence(test_sequence_s *sequence)
+{
+	data_s rawdata = { sequence->data, sequence->length };
+	ndef_message_s *msg = NULL;
+	bool complete;
+
+	TEST_CHECK(net_nfc_util_create_ndef_message(&msg) == NET_NFC_OK);
+	TEST_CHECK(net_nfc_util_convert_rawdata_to_ndef_message(&rawdata,
+				msg) == NET_NFC_INVALID_FORMAT);
+
+	net_nfc_util_free_ndef_message(msg);
+	msg = NULL;
+
+	TEST_CHECK(net_nfc_util_create_ndef_message(&msg) == NET_NFC_OK);
+	TEST_CHECK(_stream_parse(sequence->data, sequence->length, 1, msg,
+				&complete) == NET_NFC_INVALID_FORMAT);
+
+	net_nfc_util_free_ndef_message(msg);
+
+	return TRUE;
+}
+
+gboolean net_nfc_common_test_parser_invalid_sequence(void)
+{
+	gint i;
+
+	for (i = 0; i < G_N_ELEMENTS(invalid_sequences); i++)
+	{
+		if (_check_invalid_sequence(&invalid_sequences[i]) == FALSE)
+		{
+			g_printerr("invalid sequence [%s] was accepted\n",
+					invalid_sequences[i].name);
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2012-2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 				 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _NET_NFC_COMMON_TEST_PARSER_H_
+#define _NET_NFC_COMMON_TEST_PARSER_H_
+
+#include <glib.h>
+
+gboolean net_nfc_common_test_parser_split_header(void);
+
+gboolean net_nfc_common_test_parser_chunked(void);
+
+gboolean net_nfc_common_test_parser_invalid_sequence(void);
+
+
+#endif
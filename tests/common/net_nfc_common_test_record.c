@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2012-2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 				 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "net_nfc_typedef_internal.h"
+#include "net_nfc_util_internal.h"
+#include "net_nfc_util_ndef_message.h"
+#include "net_nfc_util_ndef_record.h"
+
+#include "net_nfc_common_test_util.h"
+#include "net_nfc_common_test_record.h"
+
+/* enough records to search through the lookup tables of the message */
+#define TEST_RECORD_SEARCH_RECORDS	8
+
+/* a record found by type has to be found again after unsharing it, even
+   when the buffers it shared are gone */
+gboolean net_nfc_common_test_record_search_unshared(void)
+{
+	ndef_message_s *msg = NULL;
+	ndef_record_s *record = NULL;
+	ndef_record_s *shared = NULL;
+	ndef_record_s *found = NULL;
+	ndef_record_s *first;
+	uint8_t type_buffer[] = { 'T' };
+	data_s type = { type_buffer, sizeof(type_buffer) };
+	gint i;
+
+	TEST_CHECK(net_nfc_util_create_ndef_message(&msg) == NET_NFC_OK);
+
+	for (i = 0; i < TEST_RECORD_SEARCH_RECORDS; i++)
+	{
+		record = NULL;
+
+		TEST_CHECK(net_nfc_util_create_text_type_record("unshare", "en-US",
+					NET_NFC_ENCODE_UTF_8, &record) == NET_NFC_OK);
+		TEST_CHECK(net_nfc_util_append_record(msg, record) == NET_NFC_OK);
+	}
+
+	first = msg->records;
+
+	/* builds the lookup table on the shared type buffer */
+	TEST_CHECK(net_nfc_util_search_record_by_type(msg,
+				NET_NFC_RECORD_WELL_KNOWN_TYPE, &type, &found) == NET_NFC_OK);
+	TEST_CHECK(found == first);
+
+	TEST_CHECK(net_nfc_util_share_record(first, &shared) == NET_NFC_OK);
+	TEST_CHECK(net_nfc_util_unshare_record(first) == NET_NFC_OK);
+
+	/* drops the last reference to the old buffers */
+	net_nfc_util_free_record(shared);
+
+	found = NULL;
+	TEST_CHECK(net_nfc_util_search_record_by_type(msg,
+				NET_NFC_RECORD_WELL_KNOWN_TYPE, &type, &found) == NET_NFC_OK);
+	TEST_CHECK(found == first);
+
+	net_nfc_util_free_ndef_message(msg);
+
+	return TRUE;
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2012-2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 				 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "net_nfc_server_common.h"
+
+#include "net_nfc_daemon_test_util.h"
+#include "net_nfc_daemon_test_controller.h"
+
+#define TEST_JOBS	4
+
+/* two fake targets, only their addresses matter */
+static net_nfc_target_handle_s first_target;
+static net_nfc_target_handle_s second_target;
+
+typedef struct _test_job_s
+{
+	gboolean done;
+	gboolean live;
+	net_nfc_error_e result;
+} test_job_s;
+
+static pthread_mutex_t test_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t test_cond = PTHREAD_COND_INITIALIZER;
+static gboolean test_released;
+
+static void _block_job(gpointer user_data)
+{
+	pthread_mutex_lock(&test_lock);
+
+	while (FALSE == test_released)
+		pthread_cond_wait(&test_cond, &test_lock);
+
+	pthread_mutex_unlock(&test_lock);
+}
+
+static void _record_job(gpointer user_data)
+{
+	test_job_s *job = user_data;
+	net_nfc_error_e result = NET_NFC_OK;
+	gboolean live;
+
+	live = net_nfc_server_controller_job_is_live(&result);
+
+	pthread_mutex_lock(&test_lock);
+
+	job->live = live;
+	job->result = result;
+	job->done = TRUE;
+	pthread_cond_broadcast(&test_cond);
+
+	pthread_mutex_unlock(&test_lock);
+}
+
+static void _release(void)
+{
+	pthread_mutex_lock(&test_lock);
+
+	test_released = TRUE;
+	pthread_cond_broadcast(&test_cond);
+
+	pthread_mutex_unlock(&test_lock);
+}
+
+/* waits up to five seconds for jobs to run */
+static gboolean _wait_jobs(test_job_s *jobs, gint count)
+{
+	gint i;
+	gboolean done = FALSE;
+	struct timespec end;
+
+	clock_gettime(CLOCK_REALTIME, &end);
+	end.tv_sec += 5;
+
+	pthread_mutex_lock(&test_lock);
+
+	while (FALSE == done)
+	{
+		done = TRUE;
+		for (i = 0; i < count; i++)
+			done = done && jobs[i].done;
+
+		if (FALSE == done &&
+				pthread_cond_timedwait(&test_cond, &test_lock, &end) != 0)
+			break;
+	}
+
+	pthread_mutex_unlock(&test_lock);
+
+	return done;
+}
+
+/* blocks the controller with one job on first_target and queues count
+   tag jobs behind it */
+static gboolean _queue_jobs(test_job_s *jobs, gint count)
+{
+	gint i;
+
+	test_released = FALSE;
+	memset(jobs, 0, sizeof(*jobs) * count);
+
+	TEST_CHECK(net_nfc_server_controller_async_queue_push_handle(
+				NET_NFC_CONTROLLER_PRIORITY_TAG, &first_target,
+				_block_job, NULL) == TRUE);
+
+	for (i = 0; i < count; i++)
+	{
+		TEST_CHECK(net_nfc_server_controller_async_queue_push_job(
+					NET_NFC_CONTROLLER_PRIORITY_TAG, &first_target, NULL,
+					_record_job, &jobs[i]) == TRUE);
+	}
+
+	return TRUE;
+}
+
+gboolean net_nfc_daemon_test_controller_detach_pending(void)
+{
+	gint i;
+	gboolean ok = FALSE;
+	test_job_s jobs[TEST_JOBS + 1];
+
+	net_nfc_daemon_test_set_target(&first_target);
+	TEST_CHECK(net_nfc_server_controller_thread_init() == TRUE);
+
+	if (_queue_jobs(jobs, TEST_JOBS) == FALSE)
+		goto END;
+
+	/* the next tag is already there when the queue gets to the old jobs */
+	net_nfc_daemon_test_set_target(&second_target);
+
+	if (net_nfc_server_controller_async_queue_push_job(
+				NET_NFC_CONTROLLER_PRIORITY_TAG, &second_target, NULL,
+				_record_job, &jobs[TEST_JOBS]) == FALSE)
+		goto END;
+
+	_release();
+
+	if (_wait_jobs(jobs, TEST_JOBS + 1) == FALSE)
+		goto END;
+
+	for (i = 0; i < TEST_JOBS; i++)
+	{
+		if (jobs[i].live == TRUE ||
+				jobs[i].result != NET_NFC_TARGET_IS_MOVED_AWAY)
+			goto END;
+	}
+
+	ok = (jobs[TEST_JOBS].live == TRUE);
+
+END :
+	_release();
+	net_nfc_server_controller_thread_deinit();
+	net_nfc_daemon_test_set_target(NULL);
+
+	return ok;
+}
+
+gboolean net_nfc_daemon_test_controller_cancel_handle(void)
+{
+	gint i;
+	gboolean ok = FALSE;
+	test_job_s jobs[TEST_JOBS + 1];
+
+	net_nfc_daemon_test_set_target(&first_target);
+	TEST_CHECK(net_nfc_server_controller_thread_init() == TRUE);
+
+	if (_queue_jobs(jobs, TEST_JOBS) == FALSE)
+		goto END;
+
+	/* a plugin call saw the tag leave before the target info changed */
+	net_nfc_server_controller_cancel_handle(&first_target);
+
+	/* jobs queued afterwards are for a tag that came back */
+	if (net_nfc_server_controller_async_queue_push_job(
+				NET_NFC_CONTROLLER_PRIORITY_TAG, &first_target, NULL,
+				_record_job, &jobs[TEST_JOBS]) == FALSE)
+		goto END;
+
+	_release();
+
+	if (_wait_jobs(jobs, TEST_JOBS + 1) == FALSE)
+		goto END;
+
+	for (i = 0; i < TEST_JOBS; i++)
+	{
+		if (jobs[i].live == TRUE ||
+				jobs[i].result != NET_NFC_TARGET_IS_MOVED_AWAY)
+			goto END;
+	}
+
+	ok = (jobs[TEST_JOBS].live == TRUE);
+
+END :
+	_release();
+	net_nfc_server_controller_thread_deinit();
+	net_nfc_daemon_test_set_target(NULL);
+
+	return ok;
+}
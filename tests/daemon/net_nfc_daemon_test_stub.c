@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2012-2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 				 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <pthread.h>
+#include <glib.h>
+
+#include "net_nfc_server.h"
+#include "net_nfc_server_util.h"
+#include "net_nfc_server_controller.h"
+#include "net_nfc_server_context.h"
+#include "net_nfc_server_manager.h"
+#include "net_nfc_server_tag.h"
+#include "net_nfc_server_llcp.h"
+#include "net_nfc_server_se.h"
+
+#include "net_nfc_daemon_test_util.h"
+
+/* the parts of the daemon the controller queues call into */
+
+static net_nfc_target_handle_s *current_target;
+static pthread_mutex_t current_target_lock = PTHREAD_MUTEX_INITIALIZER;
+
+void net_nfc_daemon_test_set_target(net_nfc_target_handle_s *handle)
+{
+	pthread_mutex_lock(&current_target_lock);
+	current_target = handle;
+	pthread_mutex_unlock(&current_target_lock);
+}
+
+gboolean net_nfc_server_target_connected(net_nfc_target_handle_s *handle)
+{
+	gboolean connected;
+
+	pthread_mutex_lock(&current_target_lock);
+	connected = (current_target != NULL && current_target == handle);
+	pthread_mutex_unlock(&current_target_lock);
+
+	return connected;
+}
+
+void net_nfc_server_set_target_info(void *info)
+{
+}
+
+void net_nfc_server_free_target_info(void)
+{
+	net_nfc_daemon_test_set_target(NULL);
+}
+
+void net_nfc_server_tag_target_detected(void *info)
+{
+}
+
+void net_nfc_server_llcp_target_detected(void *info)
+{
+}
+
+void net_nfc_server_llcp_deactivated(gpointer user_data)
+{
+}
+
+void net_nfc_server_se_detected(void *info)
+{
+}
+
+void net_nfc_server_se_transaction_received(void *info)
+{
+}
+
+void net_nfc_server_manager_update_state(const gchar *key, GVariant *value)
+{
+	if (value != NULL)
+		g_variant_unref(g_variant_ref_sink(value));
+}
+
+bool net_nfc_server_gdbus_check_client_is_running(const char *id)
+{
+	return true;
+}
+
+void net_nfc_manager_quit()
+{
+}
+
+void net_nfc_manager_util_play_sound(net_nfc_sound_type_e sound_type)
+{
+}
+
+bool net_nfc_controller_init(net_nfc_error_e *result)
+{
+	*result = NET_NFC_OK;
+
+	return true;
+}
+
+bool net_nfc_controller_deinit(void)
+{
+	return true;
+}
+
+bool net_nfc_controller_register_listener(
+		target_detection_listener_cb target_detection_listener,
+		se_transaction_listener_cb se_transaction_listener,
+		llcp_event_listener_cb llcp_event_listener,
+		net_nfc_error_e *result)
+{
+	*result = NET_NFC_OK;
+
+	return true;
+}
+
+bool net_nfc_controller_is_reentrant(void)
+{
+	return false;
+}
+
+bool net_nfc_controller_configure_discovery(net_nfc_discovery_mode_e mode,
+		net_nfc_event_filter_e config, net_nfc_error_e *result)
+{
+	*result = NET_NFC_OK;
+
+	return true;
+}
+
+void net_nfc_controller_llcp_socket_error_cb(net_nfc_llcp_socket_t socket,
+		net_nfc_error_e result, void *data, void *user_param)
+{
+}
+
+void net_nfc_controller_llcp_incoming_cb(net_nfc_llcp_socket_t socket,
+		net_nfc_error_e result, void *data, void *user_param)
+{
+}
+
+void net_nfc_controller_llcp_connected_cb(net_nfc_llcp_socket_t socket,
+		net_nfc_error_e result, void *data, void *user_param)
+{
+}
+
+void net_nfc_controller_llcp_disconnected_cb(net_nfc_llcp_socket_t socket,
+		net_nfc_error_e result, void *data, void *user_param)
+{
+}
+
+void net_nfc_controller_llcp_received_cb(net_nfc_llcp_socket_t socket,
+		net_nfc_error_e result, void *data, void *user_param)
+{
+}
+
+void net_nfc_controller_llcp_sent_cb(net_nfc_llcp_socket_t socket,
+		net_nfc_error_e result, void *data, void *user_param)
+{
+}
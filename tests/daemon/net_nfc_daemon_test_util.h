@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2012-2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 				 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _NET_NFC_DAEMON_TEST_UTIL_H_
+#define _NET_NFC_DAEMON_TEST_UTIL_H_
+
+#include <glib.h>
+
+#include "net_nfc_typedef_internal.h"
+
+/* fail the running test with the location of the broken expectation */
+#define TEST_CHECK(cond) \
+	do { \
+		if (!(cond)) { \
+			g_printerr("%s:%d: check failed: %s\n", \
+					__FILE__, __LINE__, #cond); \
+			return FALSE; \
+		} \
+	} while (0)
+
+/* the target net_nfc_server_target_connected() reports, NULL for none */
+void net_nfc_daemon_test_set_target(net_nfc_target_handle_s *handle);
+
+
+#endif
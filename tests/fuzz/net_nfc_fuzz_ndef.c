@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2012-2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 				 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+
+#include "net_nfc_typedef_internal.h"
+#include "net_nfc_util_internal.h"
+#include "net_nfc_util_ndef_message.h"
+#include "net_nfc_util_ndef_record.h"
+
+/* small enough to split headers of the streaming parser */
+#define FUZZ_NDEF_FRAGMENT_SIZE	5
+
+static void _stream_record_cb(ndef_record_s *record, void *user_data)
+{
+	uint32_t *count = user_data;
+
+	(*count)++;
+	net_nfc_util_free_record(record);
+}
+
+static net_nfc_error_e _stream_parse(data_s *rawdata, uint32_t *count)
+{
+	net_nfc_util_ndef_parser_s *parser;
+	net_nfc_error_e result = NET_NFC_OK;
+	uint32_t offset;
+	uint32_t length;
+
+	parser = net_nfc_util_ndef_parser_create(_stream_record_cb, count);
+	if (NULL == parser)
+		abort();
+
+	for (offset = 0; offset < rawdata->length && result == NET_NFC_OK;
+			offset += length)
+	{
+		length = MIN(FUZZ_NDEF_FRAGMENT_SIZE, rawdata->length - offset);
+
+		result = net_nfc_util_ndef_parser_feed(parser,
+				rawdata->buffer + offset, length);
+	}
+
+	if (result == NET_NFC_OK && net_nfc_util_ndef_parser_is_complete(parser) == false)
+		result = NET_NFC_INVALID_FORMAT;
+
+	net_nfc_util_ndef_parser_destroy(parser);
+
+	return result;
+}
+
+/* every parser has to agree on the input, and a message which was parsed
+   has to survive serializing and parsing it again */
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+	ndef_message_s *msg = NULL;
+	ndef_message_s *again = NULL;
+	ndef_message_s view = { 0, };
+	data_s rawdata = { (uint8_t *)data, size };
+	data_s serial = { NULL, 0 };
+	net_nfc_error_e result;
+	uint32_t stream_count = 0;
+
+	if (size == 0 || size > G_MAXUINT32)
+		return 0;
+
+	net_nfc_util_create_ndef_message(&msg);
+
+	result = net_nfc_util_convert_rawdata_to_ndef_message(&rawdata, msg);
+
+	if (net_nfc_util_convert_rawdata_to_ndef_message_view(&rawdata, &view,
+				NULL, 0) != result)
+		abort();
+
+	if ((_stream_parse(&rawdata, &stream_count) == NET_NFC_OK)
+			!= (result == NET_NFC_OK))
+		abort();
+
+	if (result == NET_NFC_OK)
+	{
+		if (view.recordCount != msg->recordCount
+				|| stream_count != msg->recordCount)
+			abort();
+
+		if (net_nfc_util_serialize_ndef_message(msg, 0, &serial) != NET_NFC_OK)
+			abort();
+
+		net_nfc_util_create_ndef_message(&again);
+
+		if (net_nfc_util_convert_rawdata_to_ndef_message(&serial, again) != NET_NFC_OK
+				|| again->recordCount != msg->recordCount)
+			abort();
+
+		net_nfc_util_free_ndef_message(again);
+		net_nfc_util_free_data(&serial);
+
+		net_nfc_util_release_ndef_message_view(&view);
+	}
+
+	net_nfc_util_free_ndef_message(msg);
+
+	return 0;
+}
+
+#ifndef NET_NFC_FUZZ_LIBFUZZER
+/* replay inputs, e.g. a corpus or crashes found by a libFuzzer build */
+int main(int argc, char *argv[])
+{
+	gchar *contents;
+	gsize length;
+	gint i;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (g_file_get_contents(argv[i], &contents, &length, NULL) == FALSE)
+		{
+			g_printerr("can not read [%s]\n", argv[i]);
+			return 1;
+		}
+
+		LLVMFuzzerTestOneInput((const uint8_t *)contents, length);
+		g_free(contents);
+	}
+
+	return 0;
+}
+#endif
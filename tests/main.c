@@ -64,6 +64,14 @@ static TestData test_data[] = {
 		"Get server state"
 	},
 
+	{
+		"Manager",
+		"GetSnapshot",
+		net_nfc_test_manager_get_snapshot,
+		NULL,
+		"Get cached manager, SE and tag state"
+	},
+
 	{
 		"Client",
 		"ClientInitialize",
@@ -233,6 +241,14 @@ static TestData test_data[] = {
 		"Tansceive method call"
 	},
 
+	{
+		"Transceive",
+		"TransceiveBatch",
+		net_nfc_test_transceive_batch,
+		net_nfc_test_transceive_batch_sync,
+		"Tansceive batch method call"
+	},
+
 	{
 		"Handover",
 		"BTRequest",
@@ -653,6 +669,14 @@ static TestData test_data[] = {
 		"Send data to a specific SAP on the socket"
 	},
 
+	{
+		"llcp",
+		"StreamSocket",
+		net_nfc_test_llcp_stream,
+		NULL,
+		"Send data through a stream bound to the socket"
+	},
+
 	{
 		"llcp",
 		"DisconnectSocket",
@@ -15,6 +15,9 @@
  */
 
 
+#include <errno.h>
+#include <unistd.h>
+
 #include "net_nfc_test_util.h"
 #include "net_nfc_client_llcp.h"
 #include "net_nfc_test_llcp.h"
@@ -858,6 +861,38 @@ void net_nfc_test_llcp_send_sync(gpointer func_data, gpointer user_data)
 }
 
 
+void net_nfc_test_llcp_stream(gpointer func_data, gpointer user_data)
+{
+	int fd;
+	ssize_t length;
+	net_nfc_error_e result;
+	char * str = "Client message: Hello, server!";
+
+	result = net_nfc_client_llcp_open_stream_sync(client_test_socket, &fd);
+
+	if(result != NET_NFC_OK)
+	{
+		g_print(" net_nfc_test_llcp_stream failed: %d\n", result);
+		run_next_callback(user_data);
+		return;
+	}
+
+	/* one write is one pdu */
+	length = write(fd, str, strlen(str) + 1);
+	close(fd);
+
+	if(length < 0)
+	{
+		g_print(" net_nfc_test_llcp_stream write failed: %d\n", errno);
+		run_next_callback(user_data);
+		return;
+	}
+
+	g_print(" net_nfc_test_llcp_stream success\n");
+	run_next_callback(user_data);
+}
+
+
 void net_nfc_test_llcp_send_to(gpointer func_data, gpointer user_data)
 {
 	net_nfc_error_e result;
@@ -64,6 +64,7 @@ void net_nfc_test_llcp_connect_sap(gpointer data, gpointer user_data);
 void net_nfc_test_llcp_connect_sap_sync(gpointer data, gpointer user_data);
 void net_nfc_test_llcp_send(gpointer data, gpointer user_data);
 void net_nfc_test_llcp_send_sync(gpointer data, gpointer user_data);
+void net_nfc_test_llcp_stream(gpointer data, gpointer user_data);
 void net_nfc_test_llcp_send_to(gpointer data, gpointer user_data);
 void net_nfc_test_llcp_send_to_sync(gpointer data, gpointer user_data);
 void net_nfc_test_llcp_disconnect(gpointer func_data, gpointer user_data);
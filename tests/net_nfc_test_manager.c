@@ -128,3 +128,31 @@ void net_nfc_test_manager_get_server_state_sync(gpointer data,
 
 	run_next_callback(user_data);
 }
+
+void net_nfc_test_manager_get_snapshot(gpointer data, gpointer user_data)
+{
+	gint i;
+	GVariant *value;
+	const gchar *keys[] = { "activated", "server_state", "se_type", "se_mode",
+		"tag_connected", "tag_handle", "tag_type" };
+
+	for (i = 0; i < G_N_ELEMENTS(keys); i++)
+	{
+		gchar *str;
+
+		value = net_nfc_client_manager_get_state(keys[i]);
+		if (NULL == value)
+		{
+			g_print("%s: (unknown)\n", keys[i]);
+			continue;
+		}
+
+		str = g_variant_print(value, FALSE);
+		g_print("%s: %s\n", keys[i], str);
+
+		g_free(str);
+		g_variant_unref(value);
+	}
+
+	run_next_callback(user_data);
+}
@@ -31,4 +31,7 @@ void net_nfc_test_manager_set_active_sync(gpointer data,
 void net_nfc_test_manager_get_server_state_sync(gpointer data,
 		gpointer user_data);
 
+void net_nfc_test_manager_get_snapshot(gpointer data,
+		gpointer user_data);
+
 #endif //__NET_NFC_TEST_MANAGER_H__
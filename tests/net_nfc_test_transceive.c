@@ -18,6 +18,7 @@
 #include "net_nfc_test_transceive.h"
 #include "net_nfc_test_util.h"
 #include "net_nfc_target_info.h"
+#include "net_nfc_data.h"
 #include "net_nfc_typedef_internal.h"
 #include "net_nfc_test_tag.h"
 
@@ -29,6 +30,11 @@ static void call_transceive_data_cb(net_nfc_error_e result,
 static void call_transceive_cb(net_nfc_error_e result,
 		void* user_data);
 
+static void call_transceive_batch_cb(net_nfc_error_e result,
+		net_nfc_transceive_command_s *commands,
+		int count,
+		void *user_data);
+
 static void run_next_callback(gpointer user_data);
 
 
@@ -62,6 +68,24 @@ static void call_transceive_data_cb(net_nfc_error_e result,
 	run_next_callback(user_data);
 }
 
+static void call_transceive_batch_cb(net_nfc_error_e result,
+		net_nfc_transceive_command_s *commands,
+		int count,
+		void *user_data)
+{
+	int i;
+
+	g_print("call_transceive_batch_cb Completed %d\n", result);
+
+	for (i = 0; i < count; i++)
+	{
+		g_print("command %d : %d\n", i, commands[i].result);
+		print_received_data(commands[i].response);
+	}
+
+	run_next_callback(user_data);
+}
+
 void net_nfc_test_transceive(gpointer data, gpointer user_data)
 {
 	net_nfc_error_e result = NET_NFC_OK;
@@ -132,3 +156,57 @@ void net_nfc_test_transceive_data_sync(gpointer data, gpointer user_data)
 	if (NET_NFC_OK == result)
 		print_received_data(response);
 }
+
+void net_nfc_test_transceive_batch(gpointer data, gpointer user_data)
+{
+	net_nfc_error_e result = NET_NFC_OK;
+	static data_s raw_data = {NULL,};
+	static net_nfc_transceive_command_s commands[2];
+	net_nfc_target_info_s *info = NULL;
+	net_nfc_target_handle_s *handle = NULL;
+
+	info = net_nfc_test_tag_get_target_info();
+
+	net_nfc_get_tag_handle(info, &handle);
+
+	commands[0].data = &raw_data;
+	commands[0].stop_on_error = true;
+	commands[1].data = &raw_data;
+
+	result = net_nfc_client_transceive_batch(handle,
+			commands,
+			2,
+			call_transceive_batch_cb,
+			user_data);
+	g_print("net_nfc_client_transceive_batch() : %d\n", result);
+}
+
+void net_nfc_test_transceive_batch_sync(gpointer data, gpointer user_data)
+{
+	int i;
+	net_nfc_error_e result = NET_NFC_OK;
+	data_s raw_data = {NULL,};
+	net_nfc_transceive_command_s commands[2] = {{NULL,},};
+	net_nfc_target_info_s *info = NULL;
+	net_nfc_target_handle_s *handle = NULL;
+
+	info = net_nfc_test_tag_get_target_info();
+
+	net_nfc_get_tag_handle(info, &handle);
+
+	commands[0].data = &raw_data;
+	commands[0].stop_on_error = true;
+	commands[1].data = &raw_data;
+
+	result = net_nfc_client_transceive_batch_sync(handle, commands, 2);
+	g_print("net_nfc_client_transceive_batch_sync() : %d\n", result);
+
+	for (i = 0; i < 2; i++)
+	{
+		g_print("command %d : %d\n", i, commands[i].result);
+		print_received_data(commands[i].response);
+
+		if (commands[i].response != NULL)
+			net_nfc_free_data(commands[i].response);
+	}
+}
@@ -32,5 +32,11 @@ void net_nfc_test_transceive_data(gpointer data,
 void net_nfc_test_transceive_data_sync(gpointer data,
 		gpointer user_data);
 
+void net_nfc_test_transceive_batch(gpointer data,
+		gpointer user_data);
+
+void net_nfc_test_transceive_batch_sync(gpointer data,
+		gpointer user_data);
+
 #endif
 